@@ -18,6 +18,8 @@ cbuffer ObjectConstantBuffer : register(b1)
 {
     matrix u_transform;
     float4x4 u_segmentTransforms[65];
+    // Vertices come already skinned by the CPU
+    int u_cpuSkinned;
 }
 
 struct PSInput
@@ -35,7 +37,8 @@ PSInput VSMain(float4 position  : a_position,
     PSInput result;
 
     float4x4 finalTransform;
-    if (segmentID != -1.0f)
+    if (segmentID != -1.0f
+        && u_cpuSkinned == 0)
     {
         finalTransform = mul(u_transform, u_segmentTransforms[(int)segmentID]);
     }
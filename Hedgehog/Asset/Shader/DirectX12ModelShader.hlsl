@@ -9,12 +9,6 @@
 //
 //*********************************************************
 
-cbuffer SceneConstantBuffer : register(b0)
-{
-    float4x4 u_ViewProjection;
-    float3 u_viewPos;
-};
-
 struct DirectionalLight
 {
     float3 color;
@@ -39,12 +33,17 @@ struct SpotLight
     float2 cutoffAngle;
 };
 
-cbuffer SceneLightsBuffer : register(b1)
+// Camera and lights, written once per frame for all of the shaders
+cbuffer FrameConstants : register(b0, space1)
 {
-    DirectionalLight u_directionalLight;
+    float4x4 u_projectionView;
+    float3 u_viewPos;
     int u_numberOfPointLights;
+    DirectionalLight u_directionalLight;
     PointLight u_pointLight[3];
     SpotLight u_spotLight;
+    uint4 u_clusterSize;
+    float4 u_clusterDepth;
 }
 
 cbuffer ObjectConstantBuffer : register(b2)
@@ -67,7 +66,7 @@ PSInput VSMain(float3 position : a_position, float3 normal : a_normal, float3 of
 
     float4 pos = mul(u_Transform, float4(position + offset, 1.0f));
 
-    result.position = mul(u_ViewProjection, pos);
+    result.position = mul(u_projectionView, pos);
     result.pos = pos.xyz;
     result.normal = mul(u_Transform, float4(normal, 0.0f)).xyz;
 
@@ -95,17 +94,17 @@ void GSMain(triangle PSInput input[3], inout TriangleStream<PSInput> OutputStrea
     float3 direction = GetDirection(input[0].pos, input[1].pos, input[2].pos);
 
     result.pos = Explode(input[0].pos, direction);
-    result.position = mul(u_ViewProjection, float4(result.pos, 1.0f));
+    result.position = mul(u_projectionView, float4(result.pos, 1.0f));
     result.normal = input[0].normal;
     OutputStream.Append(result);
 
     result.pos = Explode(input[1].pos, direction);
-    result.position = mul(u_ViewProjection, float4(result.pos, 1.0f));
+    result.position = mul(u_projectionView, float4(result.pos, 1.0f));
     result.normal = input[1].normal;
     OutputStream.Append(result);
 
     result.pos = Explode(input[2].pos, direction);
-    result.position = mul(u_ViewProjection, float4(result.pos, 1.0f));
+    result.position = mul(u_projectionView, float4(result.pos, 1.0f));
     result.normal = input[2].normal;
     OutputStream.Append(result);
 }
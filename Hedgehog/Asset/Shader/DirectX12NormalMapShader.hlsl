@@ -23,26 +23,31 @@ struct SpotLight
 };
 
 
-cbuffer SceneConstantBuffer : register(b0)
+// Camera and lights, written once per frame for all of the shaders
+cbuffer FrameConstants : register(b0, space1)
 {
-    float4x4 u_ViewProjection;
+    float4x4 u_projectionView;
     float3 u_viewPos;
-    float pad0;
-    int u_normalMapping;
-};
-
-cbuffer SceneLightsBuffer : register(b1)
-{
-    DirectionalLight u_directionalLight;
     int u_numberOfPointLights;
+    DirectionalLight u_directionalLight;
     PointLight u_pointLight[3];
     SpotLight u_spotLight;
+    uint4 u_clusterSize;
+    float4 u_clusterDepth;
 }
 
+// The camera comes from the frame constants, the rest stays where the constant buffer description puts it
+cbuffer SceneConstantBuffer : register(b0)
+{
+    int u_normalMapping : packoffset(c5);
+};
+
 cbuffer ObjectConstantBuffer : register(b2)
 {
     float4x4 u_Transform;
     float4x4 u_segmentTransforms[65];
+    // Vertices come already skinned by the CPU
+    int u_cpuSkinned;
 }
 
 struct VSInput
@@ -80,7 +85,7 @@ PSInput VSMain(VSInput input)
     float3 finalTangent = float3(0.0f, 0.0f, 0.0f);
     //float3 finalBitangent = float3(0.0f, 0.0f, 0.0f);
 
-    for (int j = 0; j < 4; j++)
+    for (int j = 0; j < 4 && u_cpuSkinned == 0; j++)
     {
         if (input.segmentIDs[j] == -1.0f)
         {
@@ -100,9 +105,16 @@ PSInput VSMain(VSInput input)
         //finalBitangent += segmentBitangent * input.segmentWeigths[j];
     }
 
+    if (u_cpuSkinned != 0)
+    {
+        finalPosition = input.position;
+        finalNormal = input.normal;
+        finalTangent = input.tangent;
+    }
+
     float4 pos = mul(u_Transform, float4(finalPosition, 1.0f));
 
-    result.position = mul(u_ViewProjection, pos);
+    result.position = mul(u_projectionView, pos);
     result.pos = pos.xyz;
     result.texSlot = input.textureSlot;
     result.texCoords = input.texCoords;
@@ -0,0 +1,141 @@
+#version 460 core
+
+struct DirectionalLight
+{
+    vec3 color;
+    vec3 direction;
+};
+
+struct PointLight
+{
+    vec3 color;
+    vec3 position;
+    vec3 attenuation;// x = constant, y = linear, z = quadratic components
+};
+
+struct SpotLight
+{
+   vec3 color;
+   vec3 position;
+   vec3 attenuation; // x = constant, y = linear, z = quadratic components
+   vec3 direction;
+   vec2 cutoffAngle;
+};
+
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in float a_textureSlot;
+layout(location = 2) in vec2 a_textureCoordinates;
+layout(location = 3) in vec3 a_normal;
+layout(location = 4) in vec3 a_tangent;
+layout(location = 5) in vec3 a_bitangent;
+layout(location = 6) in vec4 a_segmentIDs;
+layout(location = 7) in vec4 a_segmentWeigths;
+// per instance
+layout(location = 8) in vec3 a_offset;
+layout(location = 9) in float a_bakedFrame;
+
+uniform mat4 u_transform;
+
+// Baked palettes, 3 texels (the top three matrix rows) per segment, one texture row per frame
+uniform sampler2D t_texture[1];
+
+// Camera and lights, written once per frame for all of the shaders
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 u_projectionView;
+	vec3 u_viewPos;
+	int u_numberOfPointLights;
+	DirectionalLight u_directionalLight;
+	PointLight u_pointLight[3];
+	SpotLight u_spotLight;
+	uvec4 u_clusterSize;
+	vec4 u_clusterDepth;
+};
+
+out vec3 v_Position;
+flat out int v_texSlot;
+out vec2 v_textureCoordinates;
+out mat3 v_TBN;
+out vec3 v_positionTan;
+out vec3 v_lightPosTan[3];
+out vec3 v_viewPosTan;
+out vec3 v_normalTan;
+
+mat4 FetchSegmentTransform(int segment, int frame)
+{
+	vec4 row0 = texelFetch(t_texture[0], ivec2(segment * 3 + 0, frame), 0);
+	vec4 row1 = texelFetch(t_texture[0], ivec2(segment * 3 + 1, frame), 0);
+	vec4 row2 = texelFetch(t_texture[0], ivec2(segment * 3 + 2, frame), 0);
+
+	return transpose(mat4(row0, row1, row2, vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+
+mat4 GetSegmentTransform(int segment)
+{
+	int frame = int(a_bakedFrame);
+	int nextFrame = min(frame + 1, textureSize(t_texture[0], 0).y - 1);
+
+	return mix(FetchSegmentTransform(segment, frame), FetchSegmentTransform(segment, nextFrame), fract(a_bakedFrame));
+}
+
+void main()
+{
+	vec3 finalPosition = vec3(0.0f);
+	vec3 finalNormal = vec3(0.0f);
+	vec3 finalTangent = vec3(0.0f);
+	//vec3 finalBitangent = vec3(0.0f);
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (a_segmentIDs[i] == -1.0f)
+		{
+			continue;
+		}
+
+		mat4 segmentTransform = GetSegmentTransform(int(a_segmentIDs[i]));
+
+		vec4 segmentPosition = segmentTransform * vec4(a_position, 1.0f);
+		finalPosition += segmentPosition.xyz * a_segmentWeigths[i];
+
+		vec3 segmentNormal = mat3(segmentTransform) * a_normal;
+		finalNormal += segmentNormal * a_segmentWeigths[i];
+
+		vec3 segmentTangent = mat3(segmentTransform) * a_tangent;
+		finalTangent += segmentTangent.xyz * a_segmentWeigths[i];
+
+		//vec3 segmentBitangent = mat3(segmentTransform) * a_bitangent;
+		//finalBitangent += segmentBitangent * a_segmentWeigths[i];
+	}
+
+	vec4 position = u_transform * vec4(finalPosition + a_offset, 1.0f);
+
+	gl_Position = u_projectionView * position;
+	
+	v_Position = vec3(position);
+	v_texSlot = int(a_textureSlot);
+	v_textureCoordinates = a_textureCoordinates;
+
+	vec3 T = normalize(vec3(u_transform * vec4(finalTangent, 0.0)));
+	//vec3 B = normalize(vec3(u_transform * vec4(finalBitangent, 0.0)));
+	vec3 N = normalize(vec3(u_transform * vec4(finalNormal, 0.0)));
+
+	// re-orthogonalize T with respect to N
+	T = normalize(T - dot(T, N) * N);
+	// then retrieve perpendicular vector B with the cross product of T and N
+	vec3 B = cross(N, T);
+	
+	// pass the TBN matrix to pixel shader to transform normal samples to world space
+	v_TBN = mat3(T, B, N);
+
+	// or invert it before passing to insted transform light vectors into tangent space
+	v_TBN = transpose(v_TBN);
+
+	// or transform all the relevant light vectors to tangent space here and pass those
+	v_positionTan = v_TBN * v_Position;
+	for (int i = 0; i < 3; i++)
+	{
+		v_lightPosTan[i] = v_TBN * u_pointLight[i].position;
+	}
+	v_viewPosTan = v_TBN * u_viewPos;
+	v_normalTan = v_TBN * vec3(u_transform * vec4(finalNormal, 0.0f));
+}
@@ -0,0 +1,205 @@
+#version 460 core
+
+struct DirectionalLight
+{
+    vec3 color;
+    vec3 direction;
+};
+
+struct PointLight
+{
+    vec3 color;
+    vec3 position;
+    vec3 attenuation;// x = constant, y = linear, z = quadratic components
+};
+
+struct SpotLight
+{
+   vec3 color;
+   vec3 position;
+   vec3 attenuation; // x = constant, y = linear, z = quadratic components
+   vec3 direction;
+   vec2 cutoffAngle;
+};
+
+layout(location = 0) out vec4 a_color;
+
+// Camera and lights, written once per frame for all of the shaders
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 u_projectionView;
+	vec3 u_viewPos;
+	int u_numberOfPointLights;
+	DirectionalLight u_directionalLight;
+	PointLight u_pointLight[3];
+	SpotLight u_spotLight;
+	uvec4 u_clusterSize;
+	vec4 u_clusterDepth;
+};
+
+// Point and spot lights binned by LightClusters, used instead of the ones above if u_clusterSize.w isn't 0
+struct ClusterLight
+{
+    vec3 position;
+    float range;
+    vec3 color;
+    float spot;
+    vec3 attenuation;
+    float cosInner;
+    vec3 direction;
+    float cosOuter;
+};
+
+layout(std430, binding = 1) readonly buffer ClusterLights
+{
+    ClusterLight u_clusterLights[];
+};
+
+layout(std430, binding = 2) readonly buffer Clusters
+{
+    uvec2 u_clusters[]; // x = offset into the light indices, y = count
+};
+
+layout(std430, binding = 3) readonly buffer ClusterLightIndices
+{
+    uint u_clusterLightIndices[];
+};
+
+// Written by the G-buffer pass, same size as the window
+layout(binding = 0) uniform sampler2D t_gBufferAlbedo; // rgb = albedo, a = specular strength
+layout(binding = 1) uniform sampler2D t_gBufferNormal; // xyz = world space normal
+layout(binding = 2) uniform sampler2D t_gBufferPosition; // xyz = world space position, w = 1 where anything was drawn
+
+uint FindCluster(vec3 position) // world space pixel position
+{
+    vec4 clip = u_projectionView * vec4(position, 1.0f);
+    // w of a perspective clip position is the view space depth
+    vec2 screen = clamp(clip.xy / clip.w * 0.5f + 0.5f, 0.0f, 0.999f);
+    uvec2 tile = uvec2(screen * vec2(u_clusterSize.xy));
+    uint slice = uint(clamp(log(clip.w) * u_clusterDepth.x + u_clusterDepth.y, 0.0f, float(u_clusterSize.z - 1)));
+
+    return (slice * u_clusterSize.y + tile.y) * u_clusterSize.x + tile.x;
+}
+
+// Same lighting as the forward shaders, in world space
+vec3 CalculateDirectionalLight(vec3 objectColor,
+                               float specularStrength,
+                               vec3 lightDirection, // normalized direction from pixel to the light
+                               vec3 lightColor,
+                               vec3 position,       // pixel position
+                               vec3 normal)         // normalized pixel normal vector
+{
+    float diff = max(dot(normal, lightDirection), 0.0f);
+    vec3 diffuse = diff * lightColor;
+
+    vec3 viewDirection = normalize(u_viewPos - position);
+    vec3 reflectDirection = reflect(-lightDirection, normal);
+    float spec = pow(max(dot(viewDirection, reflectDirection), 0.0), 32);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    return (diffuse + specular) * objectColor;
+}
+
+vec3 CalculatePointLight(vec3 objectColor,
+                         float specularStrength,
+                         vec3 lightPosition,
+                         vec3 lightColor,
+                         vec3 attenuation,   // x = constant, y = linear, z = quadratic
+                         vec3 position,      // pixel position
+                         vec3 normal)        // normalized pixel normal vector
+{
+    vec3 lightDirection = normalize(lightPosition - position);
+
+    vec3 result = CalculateDirectionalLight(objectColor, specularStrength, lightDirection, lightColor, position, normal);
+
+    float lightDistance = length(lightPosition - position);
+    float att = 1.0f / (attenuation.x + lightDistance * attenuation.y + lightDistance * lightDistance * attenuation.z);
+
+    return att * result;
+}
+
+vec3 CalculateSpotLight(vec3 objectColor,
+                        float specularStrength,
+                        vec3 lightPosition,
+                        vec3 lightColor,
+                        vec3 lightDirection, // normalized direction into the spotlight
+                        vec2 cutoffAngle,    // cosine of the inner and outer cutoff angles
+                        vec3 attenuation,    // x = constant, y = linear, z = quadratic
+                        vec3 position,       // pixel position
+                        vec3 normal)         // normalized pixel normal vector
+{
+    vec3 lightDir = normalize(lightPosition - position);
+
+    float cosTheta = dot(lightDir, lightDirection);
+    float epsilon = cutoffAngle.x - cutoffAngle.y;
+    float intensity = smoothstep(0.0f, 1.0f, (cosTheta - cutoffAngle.y) / epsilon);
+
+    return intensity * CalculatePointLight(objectColor, specularStrength, lightPosition, lightColor, attenuation, position, normal);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 position = texelFetch(t_gBufferPosition, pixel, 0);
+    if (position.w == 0.0f)
+    {
+        // Nothing was drawn here, the clear color stays
+        discard;
+    }
+
+    vec4 albedo = texelFetch(t_gBufferAlbedo, pixel, 0);
+    vec3 normal = normalize(texelFetch(t_gBufferNormal, pixel, 0).xyz);
+    vec3 objectColor = albedo.rgb;
+    float specularStrength = albedo.a;
+
+    vec3 result = CalculateDirectionalLight(objectColor,
+                                            specularStrength,
+                                            normalize(-u_directionalLight.direction),
+                                            u_directionalLight.color,
+                                            position.xyz,
+                                            normal);
+
+    if (u_clusterSize.w != 0)
+    {
+        uvec2 cluster = u_clusters[FindCluster(position.xyz)];
+        for (uint i = cluster.x; i < cluster.x + cluster.y; i++)
+        {
+            ClusterLight light = u_clusterLights[u_clusterLightIndices[i]];
+            if (light.spot != 0.0f)
+            {
+                result += CalculateSpotLight(objectColor,
+                                             specularStrength,
+                                             light.position,
+                                             light.color,
+                                             normalize(-light.direction),
+                                             vec2(light.cosInner, light.cosOuter),
+                                             light.attenuation,
+                                             position.xyz,
+                                             normal);
+            }
+            else
+            {
+                result += CalculatePointLight(objectColor, specularStrength, light.position, light.color, light.attenuation, position.xyz, normal);
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < u_numberOfPointLights; i++)
+        {
+            result += CalculatePointLight(objectColor, specularStrength, u_pointLight[i].position, u_pointLight[i].color, u_pointLight[i].attenuation, position.xyz, normal);
+        }
+
+        result += CalculateSpotLight(objectColor,
+                                     specularStrength,
+                                     u_spotLight.position,
+                                     u_spotLight.color,
+                                     normalize(-u_spotLight.direction),
+                                     u_spotLight.cutoffAngle,
+                                     u_spotLight.attenuation,
+                                     position.xyz,
+                                     normal);
+    }
+
+    a_color = vec4(result, 1.0f);
+}
@@ -0,0 +1,9 @@
+#version 460 core
+
+// One triangle over the whole viewport
+layout(location = 0) in vec2 a_position;
+
+void main()
+{
+	gl_Position = vec4(a_position, 0.0f, 1.0f);
+}
@@ -0,0 +1,6 @@
+#version 460 core
+
+void main()
+{
+	// Depth only, color writes are off
+}
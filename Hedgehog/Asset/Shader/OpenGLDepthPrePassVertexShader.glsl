@@ -0,0 +1,32 @@
+#version 460 core
+
+layout(location = 0) in vec3 a_position;
+// Never in the vertex array, it reads as zero like in the model shader of the meshes without instance offsets
+// Those with them are left out of the pre-pass
+layout(location = 2) in vec3 a_offset;
+
+// Only the camera of the frame constants is needed
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 u_projectionView;
+};
+
+uniform mat4 u_transform;
+// World transforms of the entities drawn as the instances of one draw, u_instanceOffset is where those of the draw start
+layout(std430, binding = 4) readonly buffer InstanceTransforms
+{
+	mat4 u_instanceTransforms[];
+};
+uniform int u_instanceOffset;
+// Drawn as a batch of instances, u_transform is only the one of the first
+uniform int u_instanced;
+
+// Same math as the model shaders and invariant in both, so the main pass finds exactly the depth it wrote
+invariant gl_Position;
+
+void main()
+{
+	mat4 transform = u_instanced != 0 ? u_instanceTransforms[u_instanceOffset + gl_InstanceID] : u_transform;
+	vec4 position = transform * vec4(a_position + a_offset, 1.0f);
+	gl_Position = u_projectionView * position;
+}
@@ -7,7 +7,12 @@ layout(location = 3) in float a_segmentID;
 
 uniform mat4 u_projectionView;
 uniform mat4 u_transform;
-uniform mat4 u_segmentTransforms[65];
+// Palettes of all animated meshes, u_paletteOffset is where the one of this mesh starts
+layout(std430, binding = 0) readonly buffer SegmentPalettes
+{
+	mat4 u_segmentPalettes[];
+};
+uniform int u_paletteOffset;
 
 out vec4 v_position;
 out vec4 v_color;
@@ -17,7 +22,7 @@ void main()
 	mat4 finalTransform;
 	if (a_segmentID != -1.0f)
 	{
-		finalTransform = u_transform * u_segmentTransforms[int(a_segmentID)];
+		finalTransform = u_transform * u_segmentPalettes[u_paletteOffset + int(a_segmentID)];
 	}
 	else
 	{
@@ -5,9 +5,18 @@ layout(location = 1) in vec3 a_normal;
 
 uniform mat4 u_projectionView;
 uniform mat4 u_transform;
+// World transforms of the entities drawn as the instances of one draw, u_instanceOffset is where those of the draw start
+layout(std430, binding = 4) readonly buffer InstanceTransforms
+{
+	mat4 u_instanceTransforms[];
+};
+uniform int u_instanceOffset;
+// Drawn as a batch of instances, u_transform is only the one of the first
+uniform int u_instanced;
 
 
 void main()
 {
-	gl_Position = u_projectionView * u_transform * vec4(a_position, 1.0f);
+	mat4 transform = u_instanced != 0 ? u_instanceTransforms[u_instanceOffset + gl_InstanceID] : u_transform;
+	gl_Position = u_projectionView * transform * vec4(a_position, 1.0f);
 }
@@ -1,21 +1,67 @@
 #version 460 core
 
+struct DirectionalLight
+{
+    vec3 color;
+    vec3 direction;
+};
+
+struct PointLight
+{
+    vec3 color;
+    vec3 position;
+    vec3 attenuation;// x = constant, y = linear, z = quadratic components
+};
+
+struct SpotLight
+{
+   vec3 color;
+   vec3 position;
+   vec3 attenuation; // x = constant, y = linear, z = quadratic components
+   vec3 direction;
+   vec2 cutoffAngle;
+};
+
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec3 a_offset;
 
-uniform mat4 u_projectionView;
+// Camera and lights, written once per frame for all of the shaders
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 u_projectionView;
+	vec3 u_viewPos;
+	int u_numberOfPointLights;
+	DirectionalLight u_directionalLight;
+	PointLight u_pointLight[3];
+	SpotLight u_spotLight;
+	uvec4 u_clusterSize;
+	vec4 u_clusterDepth;
+};
+
 uniform mat4 u_transform;
+// World transforms of the entities drawn as the instances of one draw, u_instanceOffset is where those of the draw start
+layout(std430, binding = 4) readonly buffer InstanceTransforms
+{
+	mat4 u_instanceTransforms[];
+};
+uniform int u_instanceOffset;
+// Drawn as a batch of instances, u_transform is only the one of the first
+uniform int u_instanced;
 
 out vec3 v_Position;
 out vec3 v_Normal;
 
+// The depth pre-pass computes it the same way, the depth test would leave holes otherwise
+invariant gl_Position;
+
 void main()
 {
-	vec4 position = u_transform * vec4(a_position + a_offset, 1.0f);
+	mat4 transform = u_instanced != 0 ? u_instanceTransforms[u_instanceOffset + gl_InstanceID] : u_transform;
+	vec4 position = transform * vec4(a_position + a_offset, 1.0f);
 	
 	gl_Position = u_projectionView * position;
 
 	v_Position = vec3(position);
-	v_Normal = normalize(vec3(u_transform * vec4(a_normal, 0.0)));
+	v_Normal = normalize(vec3(transform * vec4(a_normal, 0.0)));
 }
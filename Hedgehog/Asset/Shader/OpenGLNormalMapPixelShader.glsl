@@ -23,6 +23,11 @@ struct SpotLight
 };
 
 layout(location = 0) out vec4 a_color;
+// With u_gBufferPass set the surface goes into the G-buffer for DeferredShading to light,
+// a_color gets the albedo and specular strength then
+// With u_transparencyPass set a_color gets the weighted color and g_normal the revealage for WeightedBlendedTransparency
+layout(location = 1) out vec4 g_normal;
+layout(location = 2) out vec4 g_position;
 
 in vec3 v_Position;
 flat in int v_texSlot;
@@ -33,13 +38,61 @@ in vec3 v_lightPosTan[3];
 in vec3 v_viewPosTan;
 in vec3 v_normalTan;
 
-uniform vec3 u_viewPos;
-uniform DirectionalLight u_directionalLight;
-uniform int u_numberOfPointLights;
-uniform PointLight u_pointLight[3];
-uniform SpotLight u_spotLight;
+// Camera and lights, written once per frame for all of the shaders
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 u_projectionView;
+	vec3 u_viewPos;
+	int u_numberOfPointLights;
+	DirectionalLight u_directionalLight;
+	PointLight u_pointLight[3];
+	SpotLight u_spotLight;
+	uvec4 u_clusterSize;
+	vec4 u_clusterDepth;
+};
+
+// Point and spot lights binned by LightClusters, used instead of the ones above if u_clusterSize.w isn't 0
+struct ClusterLight
+{
+    vec3 position;
+    float range;
+    vec3 color;
+    float spot;
+    vec3 attenuation;
+    float cosInner;
+    vec3 direction;
+    float cosOuter;
+};
+
+layout(std430, binding = 1) readonly buffer ClusterLights
+{
+    ClusterLight u_clusterLights[];
+};
+
+layout(std430, binding = 2) readonly buffer Clusters
+{
+    uvec2 u_clusters[]; // x = offset into the light indices, y = count
+};
+
+layout(std430, binding = 3) readonly buffer ClusterLightIndices
+{
+    uint u_clusterLightIndices[];
+};
+
+uint FindCluster(vec3 position) // world space pixel position
+{
+    vec4 clip = u_projectionView * vec4(position, 1.0f);
+    // w of a perspective clip position is the view space depth
+    vec2 screen = clamp(clip.xy / clip.w * 0.5f + 0.5f, 0.0f, 0.999f);
+    uvec2 tile = uvec2(screen * vec2(u_clusterSize.xy));
+    uint slice = uint(clamp(log(clip.w) * u_clusterDepth.x + u_clusterDepth.y, 0.0f, float(u_clusterSize.z - 1)));
+
+    return (slice * u_clusterSize.y + tile.y) * u_clusterSize.x + tile.x;
+}
 
 uniform bool u_normalMapping;
+uniform int u_gBufferPass;
+uniform int u_transparencyPass;
 uniform float u_specularStrength;
 
 uniform sampler2D t_diffuse[25];
@@ -140,6 +193,12 @@ vec3 CalculateSpotLight(vec3 objectColor,
 
 
 
+// Nearer and more opaque surfaces weigh more, from McGuire and Bavoil
+float TransparencyWeight(float alpha)
+{
+    return clamp(alpha * max(1e-2f, 3e3f * pow(1.0f - gl_FragCoord.z, 3.0f)), 1e-2f, 3e3f);
+}
+
 void main()
 {
     vec3 result = vec3(0.0f, 0.0f, 0.0f);
@@ -223,26 +282,69 @@ void main()
         normal = normalize(v_normalTan);
     }
 
+    if (u_gBufferPass != 0)
+    {
+        // v_TBN goes from world to tangent space, its transpose back
+        a_color = vec4(objectColor, u_specularStrength);
+        g_normal = vec4(normalize(transpose(v_TBN) * normal), 0.0f);
+        g_position = vec4(v_Position, 1.0f);
+        return;
+    }
+
     result += CalculateDirectionalLight(objectColor,
                                         normalize(v_TBN * -u_directionalLight.direction),
                                         u_directionalLight.color,
                                         v_positionTan,
                                         normal);
 
-    for (int i = 0; i < u_numberOfPointLights; i++)
+    if (u_clusterSize.w != 0)
+    {
+        uvec2 cluster = u_clusters[FindCluster(v_Position)];
+        for (uint i = cluster.x; i < cluster.x + cluster.y; i++)
+        {
+            ClusterLight light = u_clusterLights[u_clusterLightIndices[i]];
+            if (light.spot != 0.0f)
+            {
+                result += CalculateSpotLight(objectColor,
+                                             v_TBN * light.position,
+                                             light.color,
+                                             normalize(v_TBN * -light.direction),
+                                             vec2(light.cosInner, light.cosOuter),
+                                             light.attenuation,
+                                             v_positionTan,
+                                             normal);
+            }
+            else
+            {
+                result += CalculatePointLight(objectColor, v_TBN * light.position, light.color, light.attenuation, v_positionTan, normal);
+            }
+        }
+    }
+    else
     {
-        //result += CalculatePointLight(objectColor, u_pointLight[i].position, u_pointLight[i].color, u_pointLight[i].attenuation, v_Position, normal);
-        result += CalculatePointLight(objectColor, v_lightPosTan[i], u_pointLight[i].color, u_pointLight[i].attenuation, v_positionTan, normal);
+        for (int i = 0; i < u_numberOfPointLights; i++)
+        {
+            //result += CalculatePointLight(objectColor, u_pointLight[i].position, u_pointLight[i].color, u_pointLight[i].attenuation, v_Position, normal);
+            result += CalculatePointLight(objectColor, v_lightPosTan[i], u_pointLight[i].color, u_pointLight[i].attenuation, v_positionTan, normal);
+        }
+
+        result += CalculateSpotLight(objectColor,
+                                     v_TBN * u_spotLight.position,
+                                     u_spotLight.color,
+                                     normalize(v_TBN * -u_spotLight.direction),
+                                     u_spotLight.cutoffAngle,
+                                     u_spotLight.attenuation,
+                                     v_positionTan,
+                                     normal);
     }
 
-    result += CalculateSpotLight(objectColor,
-                                 v_TBN * u_spotLight.position,
-                                 u_spotLight.color,
-                                 normalize(v_TBN * -u_spotLight.direction),
-                                 u_spotLight.cutoffAngle,
-                                 u_spotLight.attenuation,
-                                 v_positionTan,
-                                 normal);
+    if (u_transparencyPass != 0)
+    {
+        float alpha = textureSample.a;
+        a_color = vec4(result * alpha, alpha) * TransparencyWeight(alpha);
+        g_normal = vec4(alpha);
+        return;
+    }
 
     a_color = vec4(result, textureSample.a);
 }
\ No newline at end of file
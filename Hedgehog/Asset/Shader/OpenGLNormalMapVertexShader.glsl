@@ -1,5 +1,11 @@
 #version 460 core
 
+struct DirectionalLight
+{
+    vec3 color;
+    vec3 direction;
+};
+
 struct PointLight
 {
     vec3 color;
@@ -7,6 +13,15 @@ struct PointLight
     vec3 attenuation;// x = constant, y = linear, z = quadratic components
 };
 
+struct SpotLight
+{
+   vec3 color;
+   vec3 position;
+   vec3 attenuation; // x = constant, y = linear, z = quadratic components
+   vec3 direction;
+   vec2 cutoffAngle;
+};
+
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in float a_textureSlot;
 layout(location = 2) in vec2 a_textureCoordinates;
@@ -18,10 +33,27 @@ layout(location = 7) in vec4 a_segmentWeigths;
 
 uniform mat4 u_ViewProjection;
 uniform mat4 u_Transform;
-uniform mat4 u_segmentTransforms[65];
+// Palettes of all animated meshes, u_paletteOffset is where the one of this mesh starts
+layout(std430, binding = 0) readonly buffer SegmentPalettes
+{
+	mat4 u_segmentPalettes[];
+};
+uniform int u_paletteOffset;
+// Vertices come already skinned by the CPU
+uniform int u_cpuSkinned;
 
-uniform vec3 u_viewPos;
-uniform PointLight u_pointLight[3];
+// Camera and lights, written once per frame for all of the shaders
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 u_projectionView;
+	vec3 u_viewPos;
+	int u_numberOfPointLights;
+	DirectionalLight u_directionalLight;
+	PointLight u_pointLight[3];
+	SpotLight u_spotLight;
+	uvec4 u_clusterSize;
+	vec4 u_clusterDepth;
+};
 
 out vec3 v_Position;
 flat out int v_texSlot;
@@ -39,26 +71,33 @@ void main()
 	vec3 finalTangent = vec3(0.0f);
 	//vec3 finalBitangent = vec3(0.0f);
 
-	for (int i = 0; i < 4; i++)
+	for (int i = 0; i < 4 && u_cpuSkinned == 0; i++)
 	{
 		if (a_segmentIDs[i] == -1.0f)
 		{
 			continue;
 		}
 
-		vec4 segmentPosition = u_segmentTransforms[int(a_segmentIDs[i])] * vec4(a_position, 1.0f);
+		vec4 segmentPosition = u_segmentPalettes[u_paletteOffset + int(a_segmentIDs[i])] * vec4(a_position, 1.0f);
 		finalPosition += segmentPosition.xyz * a_segmentWeigths[i];
 
-		vec3 segmentNormal = mat3(u_segmentTransforms[int(a_segmentIDs[i])]) * a_normal;
+		vec3 segmentNormal = mat3(u_segmentPalettes[u_paletteOffset + int(a_segmentIDs[i])]) * a_normal;
 		finalNormal += segmentNormal * a_segmentWeigths[i];
 
-		vec3 segmentTangent = mat3(u_segmentTransforms[int(a_segmentIDs[i])]) * a_tangent;
+		vec3 segmentTangent = mat3(u_segmentPalettes[u_paletteOffset + int(a_segmentIDs[i])]) * a_tangent;
 		finalTangent += segmentTangent.xyz * a_segmentWeigths[i];
 
-		//vec3 segmentBitangent = mat3(u_segmentTransforms[int(a_segmentIDs[i])]) * a_bitangent;
+		//vec3 segmentBitangent = mat3(u_segmentPalettes[u_paletteOffset + int(a_segmentIDs[i])]) * a_bitangent;
 		//finalBitangent += segmentBitangent * a_segmentWeigths[i];
 	}
 
+	if (u_cpuSkinned != 0)
+	{
+		finalPosition = a_position;
+		finalNormal = a_normal;
+		finalTangent = a_tangent;
+	}
+
 	vec4 position = u_Transform * vec4(finalPosition, 1.0f);
 
 	gl_Position = u_ViewProjection * position;
@@ -0,0 +1,9 @@
+#version 460 core
+
+layout(location = 0) out vec4 a_color;
+
+void main()
+{
+	// Color writes are off, only the depth test counts
+	a_color = vec4(1.0f);
+}
@@ -0,0 +1,11 @@
+#version 460 core
+
+layout(location = 0) in vec3 a_position;
+
+uniform mat4 u_projectionView;
+
+void main()
+{
+	// Corners of the boxes are already in world space
+	gl_Position = u_projectionView * vec4(a_position, 1.0f);
+}
@@ -0,0 +1,24 @@
+#version 460 core
+
+layout(location = 0) out vec4 a_color;
+
+// Sum of the weighted colors and alphas, and the product of one minus the alphas
+layout(binding = 0) uniform sampler2D t_accumulation;
+layout(binding = 1) uniform sampler2D t_revealage;
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float revealage = texelFetch(t_revealage, pixel, 0).r;
+    if (revealage == 1.0f)
+    {
+        // Nothing translucent here
+        discard;
+    }
+
+    vec4 accumulation = texelFetch(t_accumulation, pixel, 0);
+    vec3 color = accumulation.rgb / max(accumulation.a, 1e-5f);
+
+    // Blended over the opaque surfaces with the source alpha
+    a_color = vec4(color, 1.0f - revealage);
+}
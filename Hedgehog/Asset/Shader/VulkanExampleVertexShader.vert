@@ -7,15 +7,17 @@ layout(location = 2) in vec2 a_textureCoordinates;
 layout(location = 3) in float a_segmentID;
 
 
-layout(set = 0, binding = 0) uniform SceneConstantBuffer
+layout(set = 2, binding = 0) uniform SceneConstantBuffer
 {
     mat4 u_projectionView;
 } sceneConstantBuffer;
 
-layout(set = 1, binding = 0) uniform ObjectConstantBuffer
+layout(set = 3, binding = 0) uniform ObjectConstantBuffer
 {
     mat4 u_transform;
     mat4 u_segmentTransforms[65];
+    // Vertices come already skinned by the CPU
+    int u_cpuSkinned;
 } objectConstantBuffer;
 
 
@@ -25,7 +27,8 @@ layout(location = 1) out vec4 v_color;
 void main()
 {
 	mat4 finalTransform;
-	if (a_segmentID != -1.0f)
+	if (a_segmentID != -1.0f
+		&& objectConstantBuffer.u_cpuSkinned == 0)
 	{
 		finalTransform = objectConstantBuffer.u_transform * objectConstantBuffer.u_segmentTransforms[int(a_segmentID)];
 	}
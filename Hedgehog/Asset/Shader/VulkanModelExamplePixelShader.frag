@@ -1,7 +1,7 @@
 #version 460 core
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(set = 1, binding = 0) uniform ObjectConstantBuffer
+layout(set = 3, binding = 0) uniform ObjectConstantBuffer
 {
     mat4 u_transform;
     vec3 u_lightColor;
@@ -4,12 +4,12 @@
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_normal;
 
-layout(set = 0, binding = 0) uniform SceneConstantBuffer
+layout(set = 2, binding = 0) uniform SceneConstantBuffer
 {
     mat4 u_projectionView;
 } sceneConstantBuffer;
 
-layout(set = 1, binding = 0) uniform ObjectConstantBuffer
+layout(set = 3, binding = 0) uniform ObjectConstantBuffer
 {
     mat4 u_transform;
     vec3 u_lightColor;
@@ -3,12 +3,6 @@
 layout(location = 0) in vec3 v_Position;
 layout(location = 1) in vec3 v_Normal;
 
-layout(set = 0, binding = 0) uniform SceneConstantBuffer
-{
-	mat4 u_projectionView;
-    vec3 u_viewPos;
-} sceneConstantBuffer;
-
 struct DirectionalLight
 {
     vec3 color;
@@ -31,13 +25,19 @@ struct SpotLight
    vec2 cutoffAngle;
 };
 
-layout(set = 1, binding = 0) uniform SceneLightsBuffer
+// Camera and lights, written once per frame for all of the shaders
+// There are no light clusters on Vulkan yet, u_clusterSize.w stays 0
+layout(std140, set = 0, binding = 0) uniform FrameConstants
 {
-	DirectionalLight u_directionalLight;
+	mat4 u_projectionView;
+	vec3 u_viewPos;
 	int u_numberOfPointLights;
+	DirectionalLight u_directionalLight;
 	PointLight u_pointLight[3];
 	SpotLight u_spotLight;
-} sceneLightsBuffer;
+	uvec4 u_clusterSize;
+	vec4 u_clusterDepth;
+};
 
 layout(location = 0) out vec4 a_color;
 
@@ -56,7 +56,7 @@ vec3 CalculateDirectionalLight(vec3 lightDirection, // normalized direction from
     vec3 diffuse = diff * lightColor;
 
     float specularStrength = 0.2f;
-    vec3 viewDirection = normalize(sceneConstantBuffer.u_viewPos - position);
+    vec3 viewDirection = normalize(u_viewPos - position);
     vec3 reflectDirection = reflect(-lightDirection, normal);
     float spec = pow(max(dot(viewDirection, reflectDirection), 0.0), 32);
     vec3 specular = specularStrength * spec * lightColor;
@@ -130,23 +130,23 @@ void main()
 
     vec3 norm = normalize(v_Normal);
 
-    result += CalculateDirectionalLight(normalize(-sceneLightsBuffer.u_directionalLight.direction),
-                                        sceneLightsBuffer.u_directionalLight.color,
+    result += CalculateDirectionalLight(normalize(-u_directionalLight.direction),
+                                        u_directionalLight.color,
                                         v_Position,
                                         norm);
-    for (int i = 0; i < sceneLightsBuffer.u_numberOfPointLights; i++)
+    for (int i = 0; i < u_numberOfPointLights; i++)
     {
-        result += CalculatePointLight(sceneLightsBuffer.u_pointLight[i].position,
-                                      sceneLightsBuffer.u_pointLight[i].color,
-                                      sceneLightsBuffer.u_pointLight[i].attenuation,
+        result += CalculatePointLight(u_pointLight[i].position,
+                                      u_pointLight[i].color,
+                                      u_pointLight[i].attenuation,
                                       v_Position,
                                       norm);
     }
-    result += CalculateSpotLight(sceneLightsBuffer.u_spotLight.position,
-                                sceneLightsBuffer.u_spotLight.color,
-                                normalize(-sceneLightsBuffer.u_spotLight.direction),
-                                sceneLightsBuffer.u_spotLight.cutoffAngle,
-                                sceneLightsBuffer.u_spotLight.attenuation,
+    result += CalculateSpotLight(u_spotLight.position,
+                                u_spotLight.color,
+                                normalize(-u_spotLight.direction),
+                                u_spotLight.cutoffAngle,
+                                u_spotLight.attenuation,
                                 v_Position,
                                 norm);
 
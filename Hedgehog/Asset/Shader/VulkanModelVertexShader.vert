@@ -5,13 +5,14 @@ layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec3 a_offset;
 
-layout(set = 0, binding = 0) uniform SceneConstantBuffer
+// Camera and lights, written once per frame for all of the shaders, only the camera at the start of it is read here
+layout(std140, set = 0, binding = 0) uniform FrameConstants
 {
 	mat4 u_projectionView;
-    vec3 u_viewPos;
-} sceneConstantBuffer;
+	vec3 u_viewPos;
+};
 
-layout(set = 2, binding = 0) uniform ObjectConstantBuffer
+layout(set = 4, binding = 0) uniform ObjectConstantBuffer
 {
 	mat4 u_transform;
     float u_magnitude;
@@ -24,7 +25,7 @@ void main()
 {
 	vec4 position = objectConstantBuffer.u_transform * vec4(a_position + a_offset, 1.0f);
 	
-	gl_Position = sceneConstantBuffer.u_projectionView * position;
+	gl_Position = u_projectionView * position;
 
 	v_Position = vec3(position);
 	v_Normal = normalize(vec3(objectConstantBuffer.u_transform * vec4(a_normal, 0.0)));
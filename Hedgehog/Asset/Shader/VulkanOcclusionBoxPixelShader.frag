@@ -0,0 +1,10 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) out vec4 a_color;
+
+void main()
+{
+	// Color writes are off, only the depth test counts
+	a_color = vec4(1.0f);
+}
@@ -0,0 +1,17 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 a_position;
+
+
+layout(set = 2, binding = 0) uniform SceneConstantBuffer
+{
+    mat4 u_projectionView;
+} sceneConstantBuffer;
+
+
+void main()
+{
+	// Corners of the boxes are already in world space
+	gl_Position = sceneConstantBuffer.u_projectionView * vec4(a_position, 1.0f);
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Animation/Segment.h>
+#include <Animation/KeyframeTable.h>
+#include <Animation/CompressedClip.h>
+#include <Animation/Pose.h>
 
 
 namespace Hedge
@@ -13,16 +16,26 @@ public:
 	Animation(const std::vector<std::pair<Segment, int>>& segments);
 
 	float GetDuration() const { return duration; }
-	const std::vector<glm::mat4>& GetTransforms(float timeStamp);
+	int GetNumberOfSegments() const { return static_cast<int>(segments.size()); }
+	// Depth of the deepest segment, the root is at depth 0
+	int GetMaxDepth() const { return maxDepth; }
+
+	// Sampling doesn't touch the animation, so any number of Animators can share it, even across threads
+	// All per instance state lives in the pose and transforms passed in
+	void SamplePose(float timeStamp, Pose& pose) const;
+	// Concatenates a local pose down the hierarchy into the final segment transforms, indexed by segment ID
+	// Segments deeper than maxDepth aren't evaluated, they follow their parent rigidly instead (-1 evaluates everything)
+	void CalculateTransforms(const Pose& pose, std::vector<glm::mat4>& transforms, int maxDepth = -1) const;
+
+	// Replaces the keyframes with their compressed version, the uncompressed keys are released
+	void Compress(const CompressionSettings& settings = CompressionSettings());
+	void SetCompressedKeyframes(const CompressedClip& compressedKeyframes);
+	const CompressedClip& GetCompressedKeyframes() const { return compressedKeyframes; }
+	bool IsCompressed() const { return !compressedKeyframes.IsEmpty(); }
 
 private:
-	void CalculateTransforms(float timeStamp,
-							 int segmentIndex = 0,
-							 const Transform& parentTransform = Transform());
-
-	void CalculateTransformMatrices(float timeStamp,
-									int segmentIndex = 0,
-									const glm::mat4& parentTransform = glm::mat4(1.0f));
+	void CreateKeyframes();
+	void ReleaseKeyframes();
 
 
 private:
@@ -30,7 +43,13 @@ private:
 	int rootSegmentIndex = -1;
 	// pairs of segement and its parent
 	std::vector<std::pair<Segment, int>> segments;
-	std::vector<glm::mat4> transforms;
+	// Segment indices sorted parents first, so the hierarchy can be walked in a single pass
+	std::vector<int> evaluationOrder;
+	// Depth of each segment in the hierarchy, indexed the same as segments
+	std::vector<int> depths;
+	int maxDepth = 0;
+	KeyframeTable keyframes;
+	CompressedClip compressedKeyframes;
 };
 
 } // namespace Hedge
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Animation/Animation.h>
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+struct AnimationBenchmarkResult
+{
+	int numberOfEntities = 0;
+	unsigned int numberOfThreads = 0;
+	double frameDuration = 0.0; // in ms
+	bool matchesSerial = true;
+};
+
+// Updates crowds of Animators sharing one animation for every combination of entity and thread count,
+// the same way Scene::OnUpdate does, and prints the average update time per frame
+std::vector<AnimationBenchmarkResult> RunAnimationBenchmark(const Animation* animation,
+															const std::vector<int>& entityCounts = { 100, 1000, 10000 },
+															const std::vector<unsigned int>& threadCounts = { 1, 2, 4, 8 },
+															int numberOfFrames = 60);
+
+} // namespace Hedge
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Animation/Animation.h>
+#include <Animation/Pose.h>
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+enum class AnimationNodeType
+{
+	Free,
+	Clip,
+	Blend,
+	Additive
+};
+
+struct AnimationNode
+{
+	AnimationNodeType type = AnimationNodeType::Free;
+
+	// Clip
+	const Animation* animation = nullptr;
+	float time = 0.0f; // in seconds
+	float speed = 1.0f;
+	bool loop = true;
+
+	// Blend interpolates first -> second, additive layers second (relative to its first key) on top of first
+	int first = -1;
+	int second = -1;
+	float weight = 0.0f;
+
+	// Per node output, only the nodes that are actually blended write to it
+	Pose pose;
+	// Additive only, the pose the additive clip is expressed relative to
+	Pose reference;
+};
+
+// Small tree of clip, blend and additive nodes evaluated into a single local pose
+// Every clip has to animate the same skeleton as the one the graph was created with,
+// the graph is per instance, the animations are shared
+class AnimationGraph
+{
+public:
+	AnimationGraph(const Animation* skeleton);
+
+	int AddClip(const Animation* animation, float speed = 1.0f, bool loop = true);
+	int AddBlend(int first, int second, float weight = 0.0f);
+	int AddAdditive(int base, int additive, float weight = 1.0f);
+
+	// Frees every node the root can't reach, indices of the remaining nodes stay valid
+	void Prune();
+
+	void SetRoot(int node) { root = node; }
+	int GetRoot() const { return root; }
+
+	AnimationNode& GetNode(int node) { return nodes[node]; }
+	const AnimationNode& GetNode(int node) const { return nodes[node]; }
+
+	void SetWeight(int node, float weight) { nodes[node].weight = weight; }
+	void ResetTime();
+
+	// Advances every clip, timeStep in ms
+	void Advance(float timeStep);
+	const Pose& Evaluate();
+
+	// Returns true if anything changed
+	bool CreateGuiControls();
+
+private:
+	int AllocateNode(AnimationNodeType type);
+	const Pose& Evaluate(int node);
+	void MarkReachable(int node, std::vector<bool>& reachable) const;
+
+
+private:
+	const Animation* skeleton;
+	std::vector<AnimationNode> nodes;
+	int root = -1;
+};
+
+} // namespace Hedge
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+
+namespace Hedge
+{
+
+constexpr int NUMBER_OF_ANIMATION_LODS = 4;
+
+struct AnimationLod
+{
+	int level = 0;
+	// Graph is evaluated every n-th update, the updates in between blend towards a pose sampled ahead
+	int updateInterval = 1;
+	// Segments deeper than this follow their parents, -1 for all of them
+	int maxSegmentDepth = -1;
+	bool offScreen = false;
+};
+
+// Picks the animation LOD of an entity by its distance from the primary camera
+// Entities whose origin is off screen get the last level regardless of the distance
+class AnimationLodPolicy
+{
+public:
+	AnimationLod Select(const glm::vec3& position, const glm::vec3& cameraPosition, const glm::mat4& projectionView) const;
+
+	void ResetStatistics();
+	void Count(const AnimationLod& lod, bool evaluated);
+
+	void CreateGuiControls();
+
+
+public:
+	bool enabled = true;
+
+	// Distance where each level after the first one starts
+	float distances[NUMBER_OF_ANIMATION_LODS - 1] = { 10.0f, 25.0f, 50.0f };
+	int updateIntervals[NUMBER_OF_ANIMATION_LODS] = { 1, 2, 4, 8 };
+	int maxSegmentDepths[NUMBER_OF_ANIMATION_LODS] = { -1, -1, 6, 3 };
+	// Entities are treated as on screen a bit past the edges (in NDC), the origin is not the whole character
+	float offScreenMargin = 0.25f;
+
+	// Counters of the last update
+	int numberOfAnimators[NUMBER_OF_ANIMATION_LODS] = {};
+	int numberOfEvaluations[NUMBER_OF_ANIMATION_LODS] = {};
+	int numberOfOffScreen = 0;
+};
+
+} // namespace Hedge
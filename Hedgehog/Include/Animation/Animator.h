@@ -1,6 +1,10 @@
 #pragma once
 
 #include <Animation/Animation.h>
+#include <Animation/AnimationGraph.h>
+#include <Animation/AnimationLod.h>
+
+#include <Utilities/Stopwatch.h>
 
 #include <memory>
 
@@ -11,27 +15,76 @@ namespace Hedge
 class Animator
 {
 public:
-	Animator(Animation* animation) : animation(animation) {}
+	// Number of animators updated by one job of the parallel animation phase
+	static constexpr size_t UPDATE_CHUNK_SIZE = 16;
+
+	// The animation is played by default and defines the skeleton for everything blended in later
+	Animator(const Animation* animation);
 
 	void Update(float timeStep);
 
 	const std::vector<glm::mat4>& GetTransforms() const { return transforms; }
+	// Changes whenever the transforms do, starts at 1
+	unsigned int GetTransformsVersion() const { return transformsVersion; }
+
+	// For blend trees and additive layers beyond plain playback
+	AnimationGraph& GetGraph() { return graph; }
 
-	void Reset() { animationTime = 0.0f; resetRender = true; }
+	// Blends from whatever plays now to the animation over duration (in ms), both keep running meanwhile
+	// Returns the clip node of the new animation
+	int CrossFade(const Animation* animation, float duration, float speed = 1.0f, bool loop = true);
+	bool IsCrossFading() const { return crossFade.node >= 0; }
+
+	// Takes effect once the current interval is over, the phase staggers updates of animators with the same interval
+	void SetLod(const AnimationLod& lod, unsigned int phase = 0) { this->lod = lod; lodPhase = phase; }
+	const AnimationLod& GetLod() const { return lod; }
+	// Whether the last update evaluated the graph or only blended between poses
+	bool HasEvaluatedGraph() const { return evaluatedGraph; }
+
+	void Reset() { graph.ResetTime(); resetRender = true; }
 	void Pause() { running = false; }
 	void Resume() { running = true; }
 
 	void CreateGuiControls();
 
 private:
-	Animation* animation;
+	void UpdateCrossFade(float timeStep);
+	const Pose& AdvanceAndEvaluate(float timeStep);
+
+
+private:
+	struct CrossFadeState
+	{
+		int node = -1;
+		int target = -1;
+		float duration = 0.0f;
+		float elapsed = 0.0f;
+	};
+
+	const Animation* skeleton;
 
 	float animationSpeed = 1.0f;
 	bool running = true;
 	bool resetRender = false;
-	float animationTime = 0.0f;
 
+	Stopwatch samplingDuration;
+
+	// Per instance state and buffers, the animations are shared
+	AnimationGraph graph;
+	CrossFadeState crossFade;
 	std::vector<glm::mat4> transforms;
+	unsigned int transformsVersion = 1;
+
+	AnimationLod lod;
+	unsigned int lodPhase = 0;
+	bool evaluatedGraph = false;
+	// Reduced update rate blends from the previous to the next pose sampled an interval ahead
+	bool interpolating = false;
+	int interval = 1;
+	int intervalFrame = 0;
+	Pose previousPose;
+	Pose nextPose;
+	Pose pose;
 };
 
 } // namespace Hedge
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Animation/Animation.h>
+#include <Renderer/Texture.h>
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Palettes of whole clips sampled at a fixed rate, so crowds can play them without evaluating any poses
+// Every row of the table is one frame holding the top three rows of each segment's final transform,
+// the last row of an affine transform is always 0 0 0 1 so it isn't stored
+// Clips are stacked one after another, all of them have to animate the same skeleton
+class BakedAnimation
+{
+public:
+	static constexpr int ROWS_PER_SEGMENT = 3;
+
+	BakedAnimation(float frameRate = 30.0f);
+
+	// Returns the index of the clip
+	int AddClip(const Animation* animation);
+
+	int GetNumberOfClips() const { return static_cast<int>(clips.size()); }
+	int GetNumberOfSegments() const { return numberOfSegments; }
+	int GetNumberOfFrames() const { return numberOfFrames; }
+	float GetFrameRate() const { return frameRate; }
+	float GetDuration(int clip) const { return clips[clip].duration; }
+	size_t GetSizeInBytes() const { return table.size() * sizeof(glm::vec4); }
+
+	// Row of the table for a time within the clip (in seconds), the fractional part is the blend towards the next row
+	float GetFrame(int clip, float time) const;
+
+	const glm::vec4* GetFrameData(int frame) const { return &table[(size_t)frame * numberOfSegments * ROWS_PER_SEGMENT]; }
+	// Expands a frame back into full matrices for drawing a single instance the regular way
+	void GetTransforms(float frame, std::vector<glm::mat4>& transforms) const;
+
+	// The whole table as a float texture, 3 texels per segment wide and one row per frame
+	// Created on first use and recreated when clips are added
+	const std::shared_ptr<Texture>& GetTexture();
+
+private:
+	struct Clip
+	{
+		int firstFrame = 0;
+		int numberOfFrames = 0;
+		float duration = 0.0f;
+	};
+
+	float frameRate;
+	int numberOfSegments = 0;
+	int numberOfFrames = 0;
+	std::vector<Clip> clips;
+	std::vector<glm::vec4> table;
+
+	std::shared_ptr<Texture> texture;
+};
+
+} // namespace Hedge
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Animation/BakedAnimation.h>
+#include <Renderer/VertexArray.h>
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+
+namespace Hedge
+{
+
+struct BakedInstance
+{
+	glm::vec3 offset = glm::vec3(0.0f); // in model space, same as the a_offset of other instanced meshes
+	int clip = 0;
+	float time = 0.0f; // in seconds
+	float speed = 1.0f;
+};
+
+// Plays baked clips on every instance of an instanced skinned mesh
+// A frame costs advancing the instance clocks and uploading one small instance buffer,
+// the palettes are fetched from the baked table by the vertex shader
+// The mesh needs a Generic texture slot for the table and a shader that reads a_offset and a_bakedFrame
+class BakedAnimator
+{
+public:
+	BakedAnimator(const std::shared_ptr<BakedAnimation>& bakedAnimation,
+				  const std::vector<BakedInstance>& instances,
+				  const std::shared_ptr<VertexArray>& vertexArray);
+
+	void Update(float timeStep);
+
+	std::vector<BakedInstance>& GetInstances() { return instances; }
+	const std::shared_ptr<BakedAnimation>& GetBakedAnimation() const { return bakedAnimation; }
+
+	void Pause() { running = false; }
+	void Resume() { running = true; }
+
+	void CreateGuiControls();
+
+	static const BufferLayout& GetInstanceLayout();
+
+private:
+	std::shared_ptr<BakedAnimation> bakedAnimation;
+	std::vector<BakedInstance> instances;
+
+	float animationSpeed = 1.0f;
+	bool running = true;
+
+	// a_offset and a_bakedFrame for each instance
+	std::vector<float> instanceData;
+	std::shared_ptr<VertexBuffer> instanceBuffer;
+};
+
+} // namespace Hedge
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Animation/Pose.h>
+#include <Animation/Segment.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Keys that linear interpolation of the surrounding kept keys reconstructs within these tolerances are dropped
+struct CompressionSettings
+{
+	float translationTolerance = 0.001f; // in model units
+	float rotationTolerance = 0.05f; // in degrees
+	float scaleTolerance = 0.001f;
+};
+
+// Compressed keyframes of a clip
+// Every channel of every segment keeps only the keys it needs, key times are 16 bit fractions of the clip,
+// rotations are smallest-three quaternions packed into 48 bits and translations and scales are 16 bit per
+// component, quantized against the bounds of the whole clip
+class CompressedClip
+{
+public:
+	CompressedClip() = default;
+	CompressedClip(const std::vector<std::pair<Segment, int>>& segments, const CompressionSettings& settings = CompressionSettings());
+
+	void Sample(float timeStamp, Pose& pose) const;
+
+	bool Save(const std::string& filename) const;
+	bool Load(const std::string& filename);
+
+	bool IsEmpty() const { return tracks.empty(); }
+	int GetNumberOfSegments() const { return static_cast<int>(tracks.size()); }
+	size_t GetNumberOfKeys() const { return translationTimes.size() + rotationTimes.size() + scaleTimes.size(); }
+	size_t GetSizeInBytes() const;
+
+private:
+	struct Track
+	{
+		uint32_t firstKey = 0;
+		uint32_t numberOfKeys = 0;
+	};
+
+	struct SegmentTracks
+	{
+		Track translation;
+		Track rotation;
+		Track scale;
+	};
+
+	uint16_t QuantizeTime(float timeStamp) const;
+	float DequantizeTime(uint16_t time) const;
+
+	// Finds the pair of keys around time and the interpolant between them
+	int FindKey(const std::vector<uint16_t>& times, const Track& track, float timeStamp, float& interpolant) const;
+
+	glm::vec3 DecodeVector(const std::vector<uint16_t>& values, uint32_t key, const glm::vec3& minimum, const glm::vec3& extent) const;
+	glm::quat DecodeRotation(uint32_t key) const;
+
+
+private:
+	float startTime = 0.0f;
+	float endTime = 0.0f;
+
+	glm::vec3 translationMinimum{ 0.0f };
+	glm::vec3 translationExtent{ 0.0f };
+	glm::vec3 scaleMinimum{ 1.0f };
+	glm::vec3 scaleExtent{ 0.0f };
+
+	std::vector<SegmentTracks> tracks;
+
+	std::vector<uint16_t> translationTimes;
+	std::vector<uint16_t> rotationTimes;
+	std::vector<uint16_t> scaleTimes;
+
+	// Three components per key
+	std::vector<uint16_t> translations;
+	std::vector<uint16_t> rotations;
+	std::vector<uint16_t> scales;
+};
+
+} // namespace Hedge
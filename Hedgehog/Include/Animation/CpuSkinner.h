@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Animation/Animator.h>
+#include <Animation/SkinningKernels.h>
+#include <Renderer/VertexArray.h>
+
+#include <Utilities/Stopwatch.h>
+
+#include <memory>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Skins a mesh on the CPU into its own vertex buffer, for software rasterizers where vertex shaders are slow
+// and as a reference to check GPU skinning against
+// The shader has to skip its own skinning while u_cpuSkinned is set, the Scene uploads it
+class CpuSkinner
+{
+public:
+	// Number of vertices skinned by one job
+	static constexpr size_t SKINNING_CHUNK_SIZE = 2048;
+
+	// The vertices are the bind pose the mesh was created with, the first vertex buffer of the array gets overwritten
+	CpuSkinner(const float* vertices, unsigned int sizeOfVertices, const std::shared_ptr<VertexArray>& vertexArray);
+
+	// Skins whenever the animator has new transforms, puts the bind pose back once disabled
+	void Update(const Animator& animator);
+
+	void CreateGuiControls();
+
+
+public:
+	bool enabled = true;
+	// Scalar path instead of AVX2, to compare against
+	bool reference = false;
+
+private:
+	std::shared_ptr<VertexBuffer> vertexBuffer;
+	SkinningLayout layout;
+
+	std::vector<float> bindPose;
+	std::vector<float> skinned;
+	size_t numberOfVertices = 0;
+
+	// Transforms version of the animator the buffer holds, 0 for the bind pose
+	unsigned int skinnedVersion = 0;
+
+	Stopwatch skinningDuration;
+};
+
+} // namespace Hedge
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Animation/Pose.h>
+#include <Animation/Segment.h>
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Structure of arrays keyframe storage of a whole clip
+// The keys of all segments are resampled onto one shared timeline and every key is stored as a full Pose block,
+// so a single key index and interpolant apply to all segments and whole SIMD lanes of segments are interpolated at once
+class KeyframeTable
+{
+public:
+	KeyframeTable() = default;
+	KeyframeTable(const std::vector<std::pair<Segment, int>>& segments);
+
+	void Sample(float timeStamp, Pose& pose) const;
+
+	int GetNumberOfSegments() const { return numberOfSegments; }
+	int GetNumberOfKeys() const { return static_cast<int>(timeStamps.size()); }
+	float GetStartTime() const { return timeStamps.empty() ? 0.0f : timeStamps.front(); }
+	float GetEndTime() const { return timeStamps.empty() ? 0.0f : timeStamps.back(); }
+
+private:
+	const float* GetKey(int key) const { return keys.data() + static_cast<size_t>(key) * blockSize; }
+
+
+private:
+	int numberOfSegments = 0;
+	int stride = 0;
+	int blockSize = 0;
+
+	std::vector<float> timeStamps;
+	std::vector<float> keys;
+};
+
+} // namespace Hedge
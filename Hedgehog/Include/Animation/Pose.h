@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+
+namespace Hedge
+{
+
+enum PoseChannel
+{
+	TranslationX,
+	TranslationY,
+	TranslationZ,
+	RotationX,
+	RotationY,
+	RotationZ,
+	RotationW,
+	ScaleX,
+	ScaleY,
+	ScaleZ,
+	NumberOfPoseChannels
+};
+
+// Local (parent relative) transformations of all segments of a skeleton
+// stored as a structure of arrays, one array per channel
+// Every channel is padded to a multiple of LANE_WIDTH so the SIMD kernels can always process whole lanes,
+// the padding holds identity transformations
+class Pose
+{
+public:
+	static constexpr int LANE_WIDTH = 8;
+	static int GetStride(int numberOfSegments) { return (numberOfSegments + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH; }
+	static int GetBlockSize(int numberOfSegments) { return NumberOfPoseChannels * GetStride(numberOfSegments); }
+
+	Pose() = default;
+	Pose(int numberOfSegments) { Resize(numberOfSegments); }
+
+	static void SetIdentity(float* block, int stride);
+
+	void Resize(int numberOfSegments);
+	void SetIdentity() { SetIdentity(data.data(), stride); }
+
+	int GetNumberOfSegments() const { return numberOfSegments; }
+	int GetStride() const { return stride; }
+
+	float* GetData() { return data.data(); }
+	const float* GetData() const { return data.data(); }
+	float* GetChannel(PoseChannel channel) { return data.data() + channel * stride; }
+	const float* GetChannel(PoseChannel channel) const { return data.data() + channel * stride; }
+
+	glm::vec3 GetTranslation(int segment) const;
+	glm::quat GetRotation(int segment) const;
+	glm::vec3 GetScale(int segment) const;
+	glm::mat4 GetMatrix(int segment) const;
+
+	void Set(int segment, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+
+private:
+	int numberOfSegments = 0;
+	int stride = 0;
+	std::vector<float> data;
+};
+
+} // namespace Hedge
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Animation/Pose.h>
+
+
+namespace Hedge
+{
+
+// Rotations that are closer than this (dot product of the quaternions) are nlerped,
+// everything further apart (roughly 30 degrees and more) falls back to slerp
+constexpr float NLERP_MIN_DOT = 0.96f;
+
+// Interpolates two pose blocks with the Pose layout, result may alias either of the inputs
+// Translations and scales are interpolated linearly, rotations along the shortest arc
+// Dispatched at runtime to an AVX or SSE kernel, stride has to be a multiple of Pose::LANE_WIDTH
+void InterpolatePoses(const float* first, const float* second, float interpolant, float* result, int stride);
+
+inline void InterpolatePoses(const Pose& first, const Pose& second, float interpolant, Pose& result)
+{
+	InterpolatePoses(first.GetData(), second.GetData(), interpolant, result.GetData(), result.GetStride());
+}
+
+// Layers the difference between the additive and reference poses on top of base, scaled by weight
+// Translations are offset, scales multiplied and rotations rotated by inverse(reference) * additive
+// Same layout and aliasing rules as InterpolatePoses, result may alias any of the inputs
+void AddPoses(const float* base, const float* additive, const float* reference, float weight, float* result, int stride);
+
+inline void AddPoses(const Pose& base, const Pose& additive, const Pose& reference, float weight, Pose& result)
+{
+	AddPoses(base.GetData(), additive.GetData(), reference.GetData(), weight, result.GetData(), result.GetStride());
+}
+
+} // namespace Hedge
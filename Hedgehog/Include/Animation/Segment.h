@@ -29,12 +29,6 @@ struct KeyScale
 	glm::vec3 scale;
 };
 
-struct KeyTransform
-{
-	float timeStamp;
-	glm::mat4 transform;
-};
-
 
 class Segment
 {
@@ -44,7 +38,6 @@ public:
 	int GetID() const { return ID; }
 	const std::string& GetName() const { return name; }
 	const Transform GetTransform(float timeStamp) const;
-	const glm::mat4 GetTransformMatrix(float timeStamp) const;
 
 private:
 	const glm::vec3 GetTranslation(float timeStamp) const;
@@ -74,8 +67,6 @@ public:
 	std::vector<KeyRotation> keyRotations;
 	std::vector<KeyScale> keyScales;
 
-	std::vector<KeyTransform> keyTransforms;
-
 private:
 	std::string name;
 	int ID;
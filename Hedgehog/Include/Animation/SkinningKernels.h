@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Renderer/Buffer.h>
+
+#include <glm/glm.hpp>
+
+
+namespace Hedge
+{
+
+// Where skinning reads and writes in an interleaved vertex, all in floats, -1 if the vertex has no such attribute
+struct SkinningLayout
+{
+	unsigned int stride = 0;
+	int position = -1;
+	int normal = -1;
+	int tangent = -1;
+	int bitangent = -1;
+	int segmentIDs = -1;
+	int segmentWeights = -1;
+
+	bool IsSkinned() const { return position >= 0 && segmentIDs >= 0 && segmentWeights >= 0; }
+
+	// Looks the attributes up by the names the shaders use (a_position, a_segmentIDs, ...)
+	static SkinningLayout Create(const BufferLayout& bufferLayout);
+};
+
+// Skins count vertices starting at first from source to destination, both with the layout
+// Same math as the skinning vertex shaders: up to four segments per vertex, ID -1 ends the list, weights aren't normalized
+// Only positions, normals, tangents and bitangents are written, destination has to hold a copy of the rest already
+// Dispatched at runtime to an AVX2 kernel, reference forces the scalar one
+void SkinVertices(const float* source, float* destination, size_t first, size_t count,
+				  const SkinningLayout& layout, const glm::mat4* palette, bool reference = false);
+
+} // namespace Hedge
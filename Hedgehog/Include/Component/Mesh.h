@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Renderer/Geometry.h>
+#include <Renderer/MeshMaterial.h>
 #include <Renderer/VertexArray.h>
 #include <Component/Transform.h>
 #include <Model/Model.h>
@@ -8,6 +10,7 @@
 namespace Hedge
 {
 
+// Just handles to the shared geometry, material and the vertex array made of the two, cheap to copy
 class Mesh
 {
 public:
@@ -17,6 +20,7 @@ public:
 	//    loading model from a file
 	//    loading shaders' source code from files
 	//    [optionally] preparing textures from a description
+	// All of it goes through the resource cache, meshes of the same files share everything
 	Mesh(const std::string& modelFilename,
 		 PrimitiveTopology primitiveTopology, BufferLayout bufferLayout,
 		 ConstantBufferDescription constBufferDesc,
@@ -27,6 +31,7 @@ public:
 	//    using provided vertices and indices
 	//    loading shaders' source code from files
 	//    [optionally] preparing textures from a description
+	// The vertices get buffers of their own, they are often written to later
 	Mesh(const float* vertices, unsigned int sizeOfVertices,
 		 const unsigned int* indices, unsigned int numberOfIndices,
 		 PrimitiveTopology primitiveTopology, BufferLayout bufferLayout,
@@ -37,22 +42,28 @@ public:
 
 	const std::shared_ptr<VertexArray>& Get() const { return vertexArray; }
 	const std::shared_ptr<Shader> GetShader() const { return vertexArray->GetShader(); }
+	// Of the a_position attribute in model space, not valid if there is none
+	const BoundingBox& GetBounds() const { return geometry->bounds; }
+	// Only the a_position attribute with the same indices, for the depth pre-pass, nullptr if there is none
+	const std::shared_ptr<VertexArray>& GetDepthVertexArray() const { return depthVertexArray; }
+	const std::shared_ptr<Geometry>& GetGeometry() const { return geometry; }
+	const std::shared_ptr<MeshMaterial>& GetMaterial() const { return material; }
 
 private:
-	void CreateMesh(const float* vertices, unsigned int sizeOfVertices,
-					const unsigned int* indices, unsigned int numberOfIndices,
-					PrimitiveTopology primitiveTopology, BufferLayout bufferLayout,
+	void CreateMesh(const std::shared_ptr<Geometry>& geometry,
 					ConstantBufferDescription constBufferDesc,
 					const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
-					const std::vector<Hedge::TextureDescription>& textureDescriptions,
-					const std::vector<VertexGroup>& groups);
+					const std::vector<Hedge::TextureDescription>& textureDescriptions);
 
 
 public:
 	bool enabled = true;
 
 private:
+	std::shared_ptr<Geometry> geometry;
+	std::shared_ptr<MeshMaterial> material;
 	std::shared_ptr<VertexArray> vertexArray;
+	std::shared_ptr<VertexArray> depthVertexArray;
 };
 
 } // namespace Hedge
@@ -1,16 +1,29 @@
 #pragma once
 
 #include <Component/Entity.h>
+#include <Component/TransformBatch.h>
+#include <Component/WorldTransform.h>
 #include <entt.hpp>
 
 #include <Renderer/Camera.h>
+#include <Renderer/FrameConstants.h>
+#include <Renderer/LightClusters.h>
+#include <Animation/AnimationLod.h>
+#include <Renderer/OcclusionBuffer.h>
+#include <Renderer/OcclusionQueries.h>
+#include <Renderer/PaletteBuffer.h>
+#include <Spatial/BoundingVolumeHierarchy.h>
 
 #include <chrono>
+#include <vector>
 
 
 namespace Hedge
 {
 
+class Animator;
+class Mesh;
+
 class Scene
 {
 public:
@@ -26,11 +39,35 @@ public:
 	const Entity GetPrimaryCamera();
 
 private:
-	Transform GetParentTransform(entt::entity child);
+	void UpdateWorldTransforms();
+	void UpdateSpatialIndex();
+	void UpdateOcclusion();
+	void UpdateLightClusters(FrameConstants& frameConstants);
+	void SortHierarchy();
+	void OnHierarchyChanged(entt::registry& registry, entt::entity entity);
+
+	void UpdateAnimations(float timeStep);
+	void UpdatePalettes();
+	void UpdateSkinning();
+
+	// Model space bounds of the mesh, grown to fit the poses if it is animated
+	BoundingBox GetBounds(entt::entity entity, const Mesh& mesh);
+	bool IsVisible(entt::entity entity, const Mesh& mesh, const glm::mat4x4& transform);
 
 
 public:
 	int plUsed = 3;
+
+	AnimationLodPolicy animationLodPolicy;
+	PaletteBuffer paletteBuffer;
+	// World space boxes of the meshes by entity, instanced meshes are left out
+	BoundingVolumeHierarchy spatialIndex;
+	// Entities with an Occluder are rasterized into it every frame, meshes and their groups are tested against it
+	OcclusionBuffer occlusionBuffer;
+	// Vertex groups the GPU found hidden in the last frames are skipped
+	OcclusionQueries occlusionQueries;
+	// Point and spot lights binned into froxels, shaders go over the lights of their cluster instead of the fixed ones
+	LightClusters lightClusters;
 	
 	// TODO this should be private
 	// temporarily public so OnImGuiUpdate function can iterate over entities
@@ -38,6 +75,20 @@ public:
 	entt::registry registry;
 
 private:
+	// Scratch list of the animators to update this frame, kept around to avoid reallocating every frame
+	std::vector<Animator*> activeAnimators;
+
+	struct HierarchyNode
+	{
+		entt::entity entity;
+		int parent; // index into the hierarchy, -1 for roots
+		int depth;
+		int local = -1; // index into the transform batch if the Transform changed this frame
+	};
+	// Every entity with a Transform, parents before their children
+	std::vector<HierarchyNode> hierarchy;
+	bool hierarchyChanged = true;
+	TransformBatch transformBatch;
 };
 
 } // namespace Hedge
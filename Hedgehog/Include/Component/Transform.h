@@ -1,20 +1,32 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 
 namespace Hedge
 {
 
+// Translation, rotation and scale, 40 bytes, a version and a GUI flag, no matrices are kept
+// Get builds the matrix when asked, the Scene builds the ones that changed for all entities at once (TransformBatch)
+// Euler angles are only a view for setting things up and for the GUI, the rotation is a quaternion
 class Transform
 {
 public:
-	Transform();
+	Transform() = default;
+
+	glm::mat4 Get() const;
+	// Without the scale, what children are placed relative to
+	glm::mat4 GetTranslationRotation() const;
 
-	const glm::mat4& Get();
 	const glm::vec3& GetTranslation() const { return translation; }
-	const glm::vec3& GetRotation() const { return rotation; }
+	const glm::quat& GetRotation() const { return rotation; }
 	const glm::vec3& GetScale() const { return scale; }
+	// In degrees, X * Y * Z same as SetRotation, angles past gimbal lock may come back different from what was set
+	glm::vec3 GetEulerAngles() const;
+
+	// Changes with every modification
+	unsigned int GetVersion() const { return version; }
 
 	Transform operator*(const Transform& t1) const;
 
@@ -23,7 +35,7 @@ public:
 
 	// Set transformation components absolutely
 	void SetTranslation(const glm::vec3& translation);
-	void SetRotation(const glm::vec3& rotation);
+	void SetRotation(const glm::vec3& rotation); // Euler angles in degrees, X * Y * Z
 	void SetRotation(const glm::mat4& rotation);
 	void SetRotation(const glm::quat& rotation);
 	void SetScale(const glm::vec3& scale);
@@ -45,17 +57,11 @@ public:
 						   bool controlScale = true);
 
 private:
-	bool updateTransform = true;
-	glm::mat4 transform = glm::mat4(1.0f);
-
 	glm::vec3 translation = glm::vec3(0.0f);
-	// TODO quaternion for rotation
-	glm::vec3 rotation = glm::vec3(0.0f); // in degrees
+	glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
 	glm::vec3 scale = glm::vec3(1.0f);
 
-	glm::mat4 translationMatrix;
-	glm::mat4 rotationMatrix;
-	glm::mat4 scaleMatrix;
+	unsigned int version = 1;
 
 	bool GUIuniformScale = true;
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Component/Transform.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Transforms copied into a structure of arrays so their matrices can be built eight at a time
+// Meant to be refilled every frame with whatever changed, the memory is kept
+class TransformBatch
+{
+public:
+	void Clear() { size = 0; }
+
+	// Returns where the matrices of the transform will be
+	size_t Add(const Transform& transform);
+	size_t GetSize() const { return size; }
+
+	// Builds translation * rotation * scale and translation * rotation of everything added
+	// Dispatched at runtime to an AVX kernel
+	void Build();
+
+	const glm::mat4& GetMatrix(size_t index) const { return matrices[index]; }
+	const glm::mat4& GetTranslationRotation(size_t index) const { return translationRotations[index]; }
+
+private:
+	enum Component
+	{
+		TranslationX, TranslationY, TranslationZ,
+		RotationX, RotationY, RotationZ, RotationW,
+		ScaleX, ScaleY, ScaleZ,
+		NumberOfComponents
+	};
+
+
+private:
+	// Sized to a multiple of the SIMD width, the lanes past size hold leftovers that are built and ignored
+	std::vector<float> components[NumberOfComponents];
+	size_t size = 0;
+
+	std::vector<glm::mat4> matrices;
+	std::vector<glm::mat4> translationRotations;
+};
+
+} // namespace Hedge
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+
+namespace Hedge
+{
+
+// Where an entity ends up after its Transform and the Transforms of all its parents
+// Added to every entity with a Transform and kept up to date by the Scene, don't write into it
+struct WorldTransform
+{
+	// What the entity is rendered with
+	glm::mat4 transform = glm::mat4(1.0f);
+	// Children are placed relative to this, parents pass on their translation and rotation but not their scale
+	glm::mat4 childSpace = glm::mat4(1.0f);
+
+	// Bumped whenever the matrices change, so children know they have to follow
+	unsigned int version = 0;
+
+	// Versions of the Transform and the parent this was computed from
+	unsigned int transformVersion = 0;
+	unsigned int parentVersion = 0;
+};
+
+} // namespace Hedge
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Renderer/Texture.h>
+#include <Renderer/Culling.h>
 #include <Animation/Animation.h>
 
 #include <vector>
@@ -45,11 +46,17 @@ struct Face
 
 struct VertexGroup
 {
-	bool enabled = true;
 	std::string name;
 	unsigned int startIndex = 0;
 	unsigned int endIndex = 0;
 	glm::vec3 center{ 0.0f };
+	// In model space, groups without bounds are never culled
+	BoundingBox bounds;
+	// Of the diffuse texture its faces sample, -1 if they don't
+	int textureSlot = -1;
+	// Drawn after everything opaque, back to front or with the weighted blended transparency
+	// Set when a vertex array is made with the groups, if the diffuse texture of the slot is translucent
+	bool translucent = false;
 };
 
 struct Material
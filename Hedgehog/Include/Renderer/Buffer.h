@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -141,4 +142,97 @@ public:
 	static IndexBuffer* Create(const unsigned int* indices, unsigned int count);
 };
 
+// Block of arbitrary data the shaders can read (SSBO on OpenGL), written by the CPU
+// Meant for data that doesn't fit constant buffers, like palettes of many animated meshes
+class StorageBuffer
+{
+public:
+	virtual ~StorageBuffer() {}
+
+	// Binds a range of the buffer, the offset has to be a multiple of GetOffsetAlignment
+	virtual void Bind(unsigned int binding, unsigned int offset, unsigned int size) const = 0;
+
+	virtual void SetData(const void* data, unsigned int size, unsigned int offset = 0) = 0;
+
+	virtual unsigned int GetSize() const = 0;
+	virtual unsigned int GetOffsetAlignment() const = 0;
+
+	// Returns nullptr if the API doesn't support storage buffers (yet)
+	static StorageBuffer* Create(unsigned int size);
+};
+
+// Small block of constants shared by all of the shaders that declare it (UBO on OpenGL),
+// written once per frame instead of uploading the same values to every shader
+class ConstantBuffer
+{
+public:
+	virtual ~ConstantBuffer() {}
+
+	virtual void Bind(unsigned int binding) const = 0;
+
+	// Replaces all of the contents, size has to match the one the buffer was created with
+	virtual void SetData(const void* data, unsigned int size) = 0;
+
+	virtual unsigned int GetSize() const = 0;
+
+	// Returns nullptr if the API doesn't support shared constant buffers (yet)
+	static ConstantBuffer* Create(unsigned int size);
+};
+
+// Ring of persistently mapped memory for data written anew every frame, like streamed vertices, instances and constants
+// It has one region per frame the GPU may still be reading, a region is handed out again once the fence of the frame
+// that used it last signaled, so the CPU writes straight into it without going through the driver
+// Allocations only live until the end of their frame, owned by the renderer API, see RenderCommand::GetStreamBuffer
+class StreamBuffer
+{
+public:
+	static constexpr unsigned int REGION_SIZE = 8 * 1024 * 1024; // bytes per frame
+
+	struct Allocation
+	{
+		uint8_t* data = nullptr; // mapped, nullptr if the region of the frame has no room left
+		unsigned int offset = 0; // from the start of the buffer, for binding
+	};
+
+	virtual ~StreamBuffer() {}
+
+	// Called by the renderer API, BeginFrame waits until the region of the frame is no longer read
+	virtual void BeginFrame() = 0;
+	virtual void EndFrame() = 0;
+
+	// Aligned for any of the bindings
+	Allocation Allocate(unsigned int size);
+
+	// Ranges of allocations of this frame as storage or shared constant buffers
+	virtual void BindStorage(unsigned int binding, unsigned int offset, unsigned int size) const = 0;
+	virtual void BindConstants(unsigned int binding, unsigned int offset, unsigned int size) const = 0;
+
+	unsigned int GetRegionSize() const { return regionSize; }
+	// Counted up by every frame, allocations made in an earlier one may be overwritten already
+	unsigned long long GetFrame() const { return frame; }
+
+protected:
+	// Starts handing out the region once it is free
+	void BeginRegion(unsigned int region);
+
+
+public:
+	// Of the last frame
+	unsigned int usedBytes = 0;
+	unsigned int numberOfAllocations = 0;
+	unsigned int failedAllocations = 0;
+
+protected:
+	uint8_t* mappedData = nullptr; // start of all of the regions
+	unsigned int regionSize = 0;
+	unsigned int alignment = 256;
+
+private:
+	unsigned int regionOffset = 0;
+	unsigned int used = 0;
+	unsigned int allocations = 0;
+	unsigned int failures = 0;
+	unsigned long long frame = 0;
+};
+
 } // namespace Hedge
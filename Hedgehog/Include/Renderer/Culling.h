@@ -0,0 +1,131 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <limits>
+
+
+namespace Hedge
+{
+
+// Axis aligned, empty until something is added
+struct BoundingBox
+{
+	glm::vec3 min{ std::numeric_limits<float>::infinity() };
+	glm::vec3 max{ -std::numeric_limits<float>::infinity() };
+
+	bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+	void Add(const glm::vec3& point)
+	{
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+
+	void Add(const BoundingBox& box)
+	{
+		min = glm::min(min, box.min);
+		max = glm::max(max, box.max);
+	}
+
+	glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+	glm::vec3 GetExtent() const { return (max - min) * 0.5f; }
+
+	float GetSurfaceArea() const
+	{
+		glm::vec3 size = max - min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	bool Contains(const BoundingBox& box) const
+	{
+		return min.x <= box.min.x && min.y <= box.min.y && min.z <= box.min.z
+			&& box.max.x <= max.x && box.max.y <= max.y && box.max.z <= max.z;
+	}
+
+	bool Overlaps(const BoundingBox& box) const
+	{
+		return min.x <= box.max.x && min.y <= box.max.y && min.z <= box.max.z
+			&& box.min.x <= max.x && box.min.y <= max.y && box.min.z <= max.z;
+	}
+
+	// Box around the transformed one, the center goes through the transform and the extent through its absolute value
+	BoundingBox Transform(const glm::mat4& transform) const
+	{
+		if (!IsValid())
+		{
+			return *this;
+		}
+
+		glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+		glm::vec3 extent = GetExtent();
+		glm::vec3 transformedExtent(0.0f);
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				transformedExtent[row] += std::abs(transform[column][row]) * extent[column];
+			}
+		}
+
+		BoundingBox box;
+		box.min = center - transformedExtent;
+		box.max = center + transformedExtent;
+		return box;
+	}
+};
+
+// Planes of the view frustum, kept as a structure of arrays so a box is tested against all of them at once
+// A point p is inside of a plane if dot(normal, p) + w >= 0, the planes aren't normalized
+class FrustumPlanes
+{
+public:
+	static constexpr int NUMBER_OF_PLANES = 6;
+
+	FrustumPlanes();
+
+	// Works for both the OpenGL and zero to one depth ranges,
+	// the near plane of the latter ends up a bit behind the real one which only makes culling more conservative
+	static FrustumPlanes Create(const glm::mat4& projectionView);
+
+	// The same planes in the space the transform maps from, boxes of a mesh can then be tested without transforming them
+	FrustumPlanes Transform(const glm::mat4& transform) const;
+
+	// False only if the box is entirely outside of one of the planes, boxes around the corners may pass
+	bool Intersects(const BoundingBox& box) const;
+
+private:
+	void SetPlane(int plane, const glm::vec4& value);
+	glm::vec4 GetPlane(int plane) const;
+
+
+private:
+	// Two padding planes that never cull anything, eight make two SSE registers
+	alignas(16) float x[8];
+	alignas(16) float y[8];
+	alignas(16) float z[8];
+	alignas(16) float w[8];
+};
+
+struct CullingStatistics
+{
+	unsigned int visibleMeshes = 0;
+	unsigned int culledMeshes = 0;
+	unsigned int visibleGroups = 0;
+	unsigned int culledGroups = 0;
+	// Inside of the frustum but behind the occluders, not counted as culled
+	unsigned int occludedMeshes = 0;
+	unsigned int occludedGroups = 0;
+};
+
+// Hardware occlusion query state of a vertex group, carried from one frame to the next by the OcclusionQueries
+struct OcclusionQueryState
+{
+	int query = -1; // in flight, -1 if there is none
+	unsigned int queryFrame = 0; // frame the query in flight was issued in
+	unsigned int lastFrame = 0; // last frame the group was in the frustum
+	bool occluded = false; // by the last query that came back
+};
+
+} // namespace Hedge
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Renderer/Buffer.h>
+#include <Renderer/RenderTarget.h>
+#include <Renderer/VertexArray.h>
+
+#include <memory>
+
+
+namespace Hedge
+{
+
+// Opaque surfaces are drawn into a G-buffer first, albedo with specular strength, normal and position,
+// and lit afterwards in one pass over the screen, so every pixel goes over the lights of its cluster just once
+// Only shaders with the G-buffer outputs take part, see Shader::HasGBufferOutput,
+// everything else and whatever is translucent is drawn forward after the lighting, against the depth of the G-buffer
+class DeferredShading
+{
+public:
+	enum GBufferAttachment
+	{
+		Albedo = 0, // rgb = albedo, a = specular strength
+		Normal = 1, // world space
+		Position = 2, // world space, w = 1 where anything was drawn
+	};
+
+	// False if the API has no render targets
+	bool IsSupported() const;
+	bool IsActive() const;
+
+	// Sets up the G-buffer for the size of the window and draws go into it
+	void BeginGeometryPass();
+	// Lights the G-buffer into the window and copies its depth there for the forward draws
+	void EndGeometryPass();
+
+	void CreateGuiControls();
+
+private:
+	void CreateLightingVertexArray();
+
+
+public:
+	bool enabled = false;
+
+	// Of the last frame, counted by the renderer
+	unsigned int geometryDraws = 0;
+	unsigned int forwardDraws = 0;
+
+private:
+	std::unique_ptr<RenderTarget> gBuffer;
+	std::shared_ptr<VertexArray> lightingVertexArray;
+};
+
+} // namespace Hedge
@@ -53,4 +53,26 @@ private:
 	D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
 };
 
+
+// One slice per frame in flight in an upload heap, bound as the shared root parameter of every root signature
+class DirectX12ConstantBuffer : public ConstantBuffer
+{
+public:
+	DirectX12ConstantBuffer(unsigned int size);
+	virtual ~DirectX12ConstantBuffer() override;
+
+	virtual void Bind(unsigned int binding) const override;
+
+	virtual void SetData(const void* data, unsigned int size) override;
+
+	virtual unsigned int GetSize() const override { return size; }
+
+private:
+	unsigned int size = 0;
+	unsigned long long sliceSize = 0;
+
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+	UINT8* mappedData = nullptr;
+};
+
 } // namespace Hedge
@@ -72,6 +72,12 @@ public:
 	D3D12_CPU_DESCRIPTOR_HANDLE  g_mainRenderTargetDescriptor[NUM_BACK_BUFFERS] = {};
 	ID3D12DescriptorHeap* dsDescriptorHeap;
 	ID3D12Resource* depthStencilBuffer;
+
+	// Constants shared by all of the shaders, like the FrameConstants, are in this register space
+	// The root signatures have a parameter for them after those of the shader, see DirectX12ConstantBuffer
+	static UINT const SHARED_CONSTANTS_SPACE = 1;
+	// Of the frame in flight, 0 if nothing was bound
+	D3D12_GPU_VIRTUAL_ADDRESS sharedConstantsAddress = 0;
 };
 
 } // namespace Hedge
@@ -18,11 +18,17 @@ public:
 	virtual void SetDepthTest(bool enable) override { depthTest = enable; }
 	virtual void SetFaceCulling(bool enable) override { faceCulling = enable; }
 	virtual void SetBlending(bool enable) override { blending = enable; }
+	virtual void SetDepthWrite(bool enable) override { depthWrite = enable; }
+	virtual void SetColorWrite(bool enable) override { colorWrite = enable; }
+	virtual void SetBlendMode(BlendMode mode) override { blendMode = mode; }
 
 	virtual bool GetWireframeMode() const override { return wireframeMode; }
 	virtual bool GetDepthTest() const override { return depthTest; }
 	virtual bool GetFaceCulling() const override { return faceCulling; }
 	virtual bool GetBlending() const override { return blending; }
+	virtual bool GetDepthWrite() const override { return depthWrite; }
+	virtual bool GetColorWrite() const override { return colorWrite; }
+	virtual BlendMode GetBlendMode() const override { return blendMode; }
 
 	virtual void Resize(int width, int height, bool fillViewport = true) override;
 	virtual void SetViewport(int x, int y, int width, int height) override;
@@ -36,7 +42,21 @@ public:
 
 	virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray,
 							 unsigned int count = 0,
-							 unsigned int offset = 0) override;
+							 unsigned int offset = 0,
+							 unsigned int instanceCount = 0) override;
+
+	virtual bool SupportsRenderTargets() const override { return false; }
+
+	// TODO occlusion queries, need a query heap and a resolve buffer to read them back from
+	virtual bool SupportsOcclusionQueries() const override { return false; }
+	virtual bool SupportsConditionalRendering() const override { return false; }
+	virtual int CreateOcclusionQuery() override { return -1; }
+	virtual void DestroyOcclusionQuery(int query) override {}
+	virtual void BeginOcclusionQuery(int query) override {}
+	virtual void EndOcclusionQuery(int query) override {}
+	virtual bool GetOcclusionQueryResult(int query, unsigned long long& samples) override { return false; }
+	virtual void BeginConditionalRendering(int query) override {}
+	virtual void EndConditionalRendering() override {}
 
 private:
 	DirectX12Context* renderContext;
@@ -45,6 +65,9 @@ private:
 	bool depthTest = false;
 	bool faceCulling = false;
 	bool blending = false;
+	bool depthWrite = true;
+	bool colorWrite = true;
+	BlendMode blendMode = BlendMode::Alpha;
 
 	glm::vec4 clearColor;
 	CD3DX12_VIEWPORT viewport = {};
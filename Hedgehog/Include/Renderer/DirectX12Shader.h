@@ -42,6 +42,9 @@ public:
 	virtual void Bind() override;
 	virtual void Unbind() override;
 
+	virtual unsigned int CommitConstants() override;
+	virtual void SelectConstants(unsigned int slot) override { selectedSlot = (int)slot; }
+
 	virtual void SetupConstantBuffers(ConstantBufferDescription constBufferDesc) override;
 
 	virtual void UploadConstant(const std::string& name, float constant) override;
@@ -121,6 +124,7 @@ private:
 	};
 
 	long long int objectNum = 0;
+	int selectedSlot = -1;
 };
 
 } // namespace Hedge
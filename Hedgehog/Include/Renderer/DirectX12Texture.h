@@ -20,6 +20,7 @@ public:
 
 	virtual unsigned int GetWidth() const override { return width; }
 	virtual unsigned int GetHeight() const override { return height; }
+	virtual bool IsTranslucent() const override { return translucent; }
 
 	const D3D12_RESOURCE_DESC& GetDesc() const { return textureDesc; }
 	ID3D12Resource* Get() const { return texture.Get(); }
@@ -29,6 +30,7 @@ private:
 
 	unsigned int width;
 	unsigned int height;
+	bool translucent = false;
 
 	D3D12_RESOURCE_DESC textureDesc{};
 	Microsoft::WRL::ComPtr<ID3D12Resource> texture;
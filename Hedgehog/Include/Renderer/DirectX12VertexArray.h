@@ -69,6 +69,7 @@ private:
 	BufferLayout bufferLayout;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvHeap;
 	unsigned int texturesRootParamIndex;
+	unsigned int sharedConstantsRootParamIndex;
 	std::vector<Hedge::TextureDescription> textureDescriptions;
 	std::vector<std::shared_ptr<Texture>> textures;
 	std::vector<std::shared_ptr<VertexBuffer>> vertexBuffers;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Component/Light.h>
+
+#include <glm/glm.hpp>
+
+
+namespace Hedge
+{
+
+// Camera and lights of the frame, laid out by the std140 rules of the FrameConstants uniform block in the shaders
+struct FrameConstants
+{
+	static constexpr unsigned int BINDING = 0;
+	static constexpr int MAX_POINT_LIGHTS = 3;
+
+	glm::mat4 projectionView = glm::mat4(1.0f);
+	glm::vec3 viewPosition = glm::vec3(0.0f);
+	int numberOfPointLights = 0;
+	DirectionalLight directionalLight;
+	PointLight pointLights[MAX_POINT_LIGHTS];
+	SpotLight spotLight;
+	// Set by LightClusters, w of the size is 0 if the lights above are used instead
+	glm::uvec4 clusterSize = glm::uvec4(0);
+	glm::vec4 clusterDepth = glm::vec4(0.0f); // slice = log(depth) * x + y
+};
+
+static_assert(sizeof(FrameConstants) == 368, "FrameConstants has to match the std140 layout of the shaders");
+
+} // namespace Hedge
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Renderer/Buffer.h>
+#include <Renderer/Culling.h>
+#include <Renderer/VertexArray.h>
+#include <Model/Model.h>
+
+#include <memory>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Vertex and index buffers of a model with its groups, shared by all of the meshes drawn with them
+// Vertex arrays only reference the buffers, any number of them can be made from the one geometry
+struct Geometry
+{
+	PrimitiveTopology primitiveTopology = PrimitiveTopology::Triangle;
+	std::shared_ptr<VertexBuffer> vertexBuffer;
+	std::shared_ptr<IndexBuffer> indexBuffer;
+	std::vector<VertexGroup> groups;
+	// Of the a_position attribute in model space, not valid if there is none
+	BoundingBox bounds;
+	// Only the a_position attribute with the same indices, for the depth pre-pass, nullptr if there is none
+	std::shared_ptr<VertexArray> depthVertexArray;
+
+	static Geometry* Create(const float* vertices, unsigned int sizeOfVertices,
+							const unsigned int* indices, unsigned int numberOfIndices,
+							PrimitiveTopology primitiveTopology, BufferLayout bufferLayout,
+							const std::vector<VertexGroup>& groups = {});
+};
+
+} // namespace Hedge
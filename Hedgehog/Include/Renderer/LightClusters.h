@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Component/Light.h>
+#include <Renderer/Buffer.h>
+#include <Renderer/Camera.h>
+#include <Renderer/FrameConstants.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Point or spot light as the shaders read it, std430 layout
+struct ClusterLight
+{
+	glm::vec3 position;
+	float range; // past this it is too dim to matter
+	glm::vec3 color;
+	float spot; // 1 for spot lights, 0 for point lights
+	glm::vec3 attenuation;
+	float cosInner;
+	glm::vec3 direction;
+	float cosOuter;
+};
+
+// Point and spot lights binned into a grid of froxels over the view frustum, tiles across the screen
+// and depth slices spaced exponentially from the near to the far clip, so a pixel only goes over the lights near it
+// The grid is built on the CPU every frame, the slices in parallel with the lights tested four at a time,
+// and uploaded into storage buffers: the lights, an offset and count per cluster and the light indices of all clusters
+class LightClusters
+{
+public:
+	static constexpr unsigned int SIZE_X = 16;
+	static constexpr unsigned int SIZE_Y = 9;
+	static constexpr unsigned int SIZE_Z = 24;
+	static constexpr unsigned int NUMBER_OF_CLUSTERS = SIZE_X * SIZE_Y * SIZE_Z;
+
+	static constexpr unsigned int LIGHT_BINDING = 1;
+	static constexpr unsigned int CLUSTER_BINDING = 2;
+	static constexpr unsigned int INDEX_BINDING = 3;
+
+	// False if the API has no storage buffers
+	bool IsSupported();
+	// Only if enabled and supported, for perspective cameras
+	bool IsActive(const Camera& camera);
+
+	void Begin(const Camera& camera, const glm::mat4& view);
+	void AddPointLight(const PointLight& light);
+	void AddSpotLight(const SpotLight& light);
+
+	// Bins the lights, uploads and binds the buffers and sets up the constants the shaders find their cluster with
+	void Build(FrameConstants& frameConstants);
+
+	void CreateGuiControls();
+
+private:
+	float GetRange(const glm::vec3& color, const glm::vec3& attenuation) const;
+	void Add(const ClusterLight& light);
+	void BuildSlice(unsigned int slice);
+	void Upload();
+
+
+public:
+	bool enabled = true;
+	float threshold = 1.0f / 256.0f; // brightness the range of a light ends at
+
+	// Of the last frame
+	unsigned int numberOfLights = 0;
+	unsigned int numberOfIndices = 0;
+	unsigned int maxLightsPerCluster = 0;
+	double buildDuration = 0.0; // in ms
+
+private:
+	struct Cluster
+	{
+		uint32_t offset; // into the light indices
+		uint32_t count;
+	};
+
+	// View space bounding spheres, one array per component so four lights load at once
+	struct LightBounds
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+		std::vector<float> radius;
+
+		void Clear();
+		void Add(const glm::vec3& center, float radius);
+	};
+
+	struct Slice
+	{
+		// Lights that reach into the depth range of the slice, their bounds padded to a multiple of four
+		std::vector<uint32_t> candidates;
+		LightBounds candidateBounds;
+		// Of all of the clusters of the slice, their offsets are relative to the slice until merged
+		std::vector<uint32_t> indices;
+	};
+
+	std::unique_ptr<StorageBuffer> lightBuffer;
+	std::unique_ptr<StorageBuffer> clusterBuffer;
+	std::unique_ptr<StorageBuffer> indexBuffer;
+	bool supported = true;
+
+	Frustum frustum;
+	glm::mat4 view{ 1.0f };
+	float depthScale = 0.0f; // slice = log(depth) * depthScale + depthBias
+	float depthBias = 0.0f;
+
+	std::vector<ClusterLight> lights;
+	LightBounds bounds; // in view space
+	std::vector<Cluster> clusters;
+	std::vector<uint32_t> indices;
+	Slice slices[SIZE_Z];
+};
+
+} // namespace Hedge
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Renderer/Shader.h>
+#include <Renderer/Texture.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Shader with its constant buffers and the textures it samples, shared by all of the meshes drawn the same way
+// Not the Material of a loaded model, that one only names the texture files of the model's groups
+struct MeshMaterial
+{
+	std::shared_ptr<Shader> shader;
+	// Of the descriptions with a file, in their order
+	std::vector<std::pair<TextureType, std::shared_ptr<Texture>>> textures;
+	std::vector<TextureDescription> textureDescriptions;
+
+	static MeshMaterial* Create(const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
+								ConstantBufferDescription constBufferDesc,
+								const std::vector<TextureDescription>& textureDescriptions = {});
+};
+
+} // namespace Hedge
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+struct OcclusionBenchmarkResult
+{
+	int numberOfOccluders = 0;
+	int numberOfTriangles = 0;
+	int numberOfBoxes = 0;
+	double rasterizeDuration = 0.0; // in ms per frame
+	double testDuration = 0.0; // in ms per frame
+	int numberOfOccluded = 0;
+};
+
+// Rasterizes rows of box occluders in front of a field of small boxes and tests all of them,
+// runs entirely on the CPU so it works without a GPU
+std::vector<OcclusionBenchmarkResult> RunOcclusionBenchmark(const std::vector<int>& occluderCounts = { 100, 1000, 10000 },
+															int numberOfBoxes = 100000,
+															int numberOfFrames = 30);
+
+} // namespace Hedge
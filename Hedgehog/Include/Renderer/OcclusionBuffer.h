@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Renderer/Buffer.h>
+#include <Renderer/Culling.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Low detail stand-in of a mesh that hides whatever is behind it, rasterized into the OcclusionBuffer
+// Has to stay inside of the real mesh, otherwise it hides things that are visible around it
+class Occluder
+{
+public:
+	// Positions are taken from the a_position attribute
+	Occluder(const float* vertices, unsigned int sizeOfVertices,
+			 const unsigned int* indices, unsigned int numberOfIndices,
+			 const BufferLayout& bufferLayout);
+
+	// Solid box, good enough for walls and floors
+	Occluder(const BoundingBox& box);
+
+	const std::vector<glm::vec3>& GetPositions() const { return positions; }
+	const std::vector<unsigned int>& GetIndices() const { return indices; }
+
+
+public:
+	bool enabled = true;
+
+private:
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> indices;
+};
+
+// Low resolution depth buffer of the occluders, rasterized on the CPU, with a min depth hierarchy on top to test boxes against
+// Depth is stored as 1 / w so it works the same for every API's depth range, larger is closer and 0 is empty
+// Orthographic projections have the same w everywhere, so nothing is ever occluded with them
+class OcclusionBuffer
+{
+public:
+	static constexpr int NUMBER_OF_LEVELS = 6;
+
+	// Width has to be a multiple of 4, rows are rasterized 4 pixels at a time
+	OcclusionBuffer(int width = 256, int height = 128);
+
+	// Clears the buffer, everything is visible until the occluders are rasterized
+	void Begin(const glm::mat4& projectionView);
+	// The occluder has to stay alive until Rasterize
+	void AddOccluder(const Occluder& occluder, const glm::mat4& transform);
+	// Sets up the triangles and rasterizes bands of rows on the job system, then builds the hierarchy
+	void Rasterize();
+
+	// False only if the box is behind the occluders at every pixel it covers
+	bool IsVisible(const BoundingBox& bounds, const glm::mat4& transform) const;
+
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+	const std::vector<float>& GetDepth() const { return levels[0]; }
+
+	void CreateGuiControls();
+
+private:
+	struct OccluderInstance
+	{
+		const Occluder* occluder;
+		glm::mat4 transform;
+		size_t firstVertex;
+		size_t firstTriangle;
+	};
+
+	// Edge functions and the 1 / w plane, all of them affine in pixel coordinates
+	struct Triangle
+	{
+		glm::vec3 edges[3];
+		glm::vec3 depth;
+		int minX, maxX;
+		int minY, maxY;
+
+		bool IsEmpty() const { return minX > maxX || minY > maxY; }
+	};
+
+	void SetupTriangles(const OccluderInstance& instance);
+	void RasterizeRows(int firstRow, int endRow);
+	void BuildHierarchy();
+
+
+public:
+	bool enabled = true;
+
+	// Of the last Rasterize
+	int numberOfOccluders = 0;
+	int numberOfTriangles = 0;
+	double rasterizeDuration = 0.0; // in ms
+
+private:
+	int width;
+	int height;
+	glm::mat4 projectionView = glm::mat4(1.0f);
+
+	std::vector<OccluderInstance> instances;
+	std::vector<glm::vec4> clipVertices;
+	std::vector<Triangle> triangles;
+
+	// Level 0 is the buffer itself, every next one keeps the farthest depth of 2x2 texels of the previous
+	std::vector<float> levels[NUMBER_OF_LEVELS];
+	bool rasterized = false;
+};
+
+} // namespace Hedge
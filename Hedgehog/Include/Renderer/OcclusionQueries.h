@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Model/Model.h>
+#include <Renderer/Buffer.h>
+#include <Renderer/Culling.h>
+#include <Renderer/VertexArray.h>
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Skips vertex groups that were hidden in the last frames according to hardware occlusion queries
+// Results come back a frame or more later, a group coming out from behind something can be missing for as long,
+// with conditional rendering it is drawn until the GPU knows better instead
+// Occluded groups are tested again with their bounding box drawn at the end of the frame,
+// visible ones every few frames with their own draw wrapped in a query
+class OcclusionQueries
+{
+public:
+	// Boxes Flush can draw in one frame, occluded groups past that are drawn instead
+	static constexpr unsigned int MAX_BOXES = 1024;
+
+	void BeginFrame(const glm::vec3& cameraPosition);
+
+	// False if the group is to be skipped, otherwise EndGroup has to come right after its draw
+	bool BeginGroup(const VertexGroup& group, OcclusionQueryState& state, const glm::mat4& transform);
+	void EndGroup();
+
+	// Draws the boxes of the occluded groups with their queries, after everything else in the frame is drawn
+	void Flush(const glm::mat4& projectionView);
+
+	// Only if enabled and the renderer has occlusion queries
+	bool IsActive() const;
+
+	void CreateGuiControls();
+
+private:
+	void ReadResult(OcclusionQueryState& state);
+	void CreateBoxVertexArray();
+
+
+public:
+	bool enabled = true;
+	bool conditionalRendering = true;
+	int retestInterval = 4; // frames in between the queries of a visible group
+	int maxQueryAge = 8; // frames until a query that hasn't come back is given up on and its group drawn again
+
+	// Of the last frame
+	unsigned int issuedQueries = 0;
+	unsigned int boxQueries = 0;
+	unsigned int conditionalDraws = 0;
+	unsigned int skippedGroups = 0;
+	unsigned int droppedQueries = 0;
+	// In frames from issuing a query to reading its result, over the results read in the last frame
+	float averageLatency = 0.0f;
+	unsigned int maxLatency = 0;
+
+private:
+	unsigned int frame = 0;
+	glm::vec3 cameraPosition{ 0.0f };
+
+	// Of the group in between BeginGroup and EndGroup
+	int activeQuery = -1;
+	bool activeConditional = false;
+
+	// World space corners of the boxes to Flush, eight each
+	std::vector<glm::vec3> boxCorners;
+	std::vector<int> boxQueryHandles;
+	std::shared_ptr<VertexArray> boxVertexArray;
+	std::shared_ptr<VertexBuffer> boxVertexBuffer;
+
+	unsigned int latencySum = 0;
+	unsigned int numberOfResults = 0;
+};
+
+} // namespace Hedge
@@ -2,6 +2,8 @@
 
 #include <Renderer/Buffer.h>
 
+#include <glad/glad.h>
+
 
 namespace Hedge
 {
@@ -24,6 +26,7 @@ public:
 
 private:
 	unsigned int rendererID = 0;
+	unsigned int capacity = 0; // in bytes
 	BufferLayout layout;
 };
 
@@ -44,4 +47,69 @@ private:
 	unsigned int count = 0;
 };
 
+
+class OpenGLStorageBuffer : public StorageBuffer
+{
+public:
+	OpenGLStorageBuffer(unsigned int size);
+	virtual ~OpenGLStorageBuffer();
+
+	virtual void Bind(unsigned int binding, unsigned int offset, unsigned int size) const override;
+
+	virtual void SetData(const void* data, unsigned int size, unsigned int offset = 0) override;
+
+	virtual unsigned int GetSize() const override { return size; }
+	virtual unsigned int GetOffsetAlignment() const override { return offsetAlignment; }
+
+private:
+	unsigned int rendererID = 0;
+	unsigned int size = 0;
+	unsigned int offsetAlignment = 256;
+};
+
+class OpenGLConstantBuffer : public ConstantBuffer
+{
+public:
+	OpenGLConstantBuffer(unsigned int size);
+	virtual ~OpenGLConstantBuffer();
+
+	virtual void Bind(unsigned int binding) const override;
+
+	virtual void SetData(const void* data, unsigned int size) override;
+
+	virtual unsigned int GetSize() const override { return size; }
+
+private:
+	unsigned int rendererID = 0;
+	unsigned int size = 0;
+
+	// Where SetData put the constants in the stream buffer, bound from there while it is still the same frame
+	unsigned int streamOffset = 0;
+	unsigned long long streamFrame = 0;
+	bool streamed = false;
+};
+
+class OpenGLStreamBuffer : public StreamBuffer
+{
+public:
+	static constexpr unsigned int NUMBER_OF_REGIONS = 3;
+
+	OpenGLStreamBuffer(unsigned int regionSize);
+	virtual ~OpenGLStreamBuffer();
+
+	virtual void BeginFrame() override;
+	virtual void EndFrame() override;
+
+	virtual void BindStorage(unsigned int binding, unsigned int offset, unsigned int size) const override;
+	virtual void BindConstants(unsigned int binding, unsigned int offset, unsigned int size) const override;
+
+	// For copies out of the buffer
+	unsigned int GetRendererID() const { return rendererID; }
+
+private:
+	unsigned int rendererID = 0;
+	unsigned int region = 0;
+	GLsync fences[NUMBER_OF_REGIONS] = {};
+};
+
 } // namespace Hedge
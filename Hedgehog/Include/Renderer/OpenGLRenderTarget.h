@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Renderer/RenderTarget.h>
+
+
+namespace Hedge
+{
+
+class OpenGLRenderTarget : public RenderTarget
+{
+public:
+	OpenGLRenderTarget(const RenderTargetDescription& description);
+	virtual ~OpenGLRenderTarget();
+
+	virtual void Bind() override;
+	virtual void Unbind() override;
+
+	virtual void Clear(const glm::vec4& color) override;
+	virtual void ClearColor(unsigned int attachment, const glm::vec4& color) override;
+
+	virtual void BindColorTexture(unsigned int attachment, unsigned int slot) const override;
+
+	virtual void CopyDepthToWindow() const override;
+	virtual void CopyDepthFromWindow() override;
+
+	virtual const RenderTargetDescription& GetDescription() const override { return description; }
+
+private:
+	RenderTargetDescription description;
+
+	unsigned int framebufferID = 0;
+	std::vector<unsigned int> colorTextureIDs;
+	unsigned int depthTextureID = 0;
+};
+
+} // namespace Hedge
@@ -2,9 +2,13 @@
 
 #include <Renderer/RendererAPI.h>
 #include <Renderer/OpenGLContext.h>
+#include <Renderer/OpenGLBuffer.h>
 
 #include <glad/glad.h>
 
+#include <memory>
+#include <vector>
+
 
 namespace Hedge
 {
@@ -18,25 +22,46 @@ public:
 	virtual void SetDepthTest(bool enable) override;
 	virtual void SetFaceCulling(bool enable) override;
 	virtual void SetBlending(bool enable) override;
+	virtual void SetDepthWrite(bool enable) override;
+	virtual void SetColorWrite(bool enable) override;
+	virtual void SetBlendMode(BlendMode mode) override;
 
 	virtual bool GetWireframeMode() const override { return wireframeMode; }
 	virtual bool GetDepthTest() const override { return depthTest; }
 	virtual bool GetFaceCulling() const override { return faceCulling; }
 	virtual bool GetBlending() const override { return blending; }
+	virtual bool GetDepthWrite() const override { return depthWrite; }
+	virtual bool GetColorWrite() const override { return colorWrite; }
+	virtual BlendMode GetBlendMode() const override { return blendMode; }
 
 	virtual void Resize(int width, int height, bool fillViewport = true) override;
 	virtual void SetViewport(int x, int y, int width, int height) override;
 	virtual void SetScissor(int x, int y, int width, int height) override;
 
 	virtual void SetClearColor(const glm::vec4& color) override;
-	virtual void End() override { /* do nothing */ }
-	virtual void Begin() override { /* do nothing */ }
+	virtual void End() override;
+	virtual void Begin() override;
 	virtual void BeginFrame() override;
 	virtual void EndFrame() override;
 
+	virtual StreamBuffer* GetStreamBuffer() override { return streamBuffer.get(); }
+
 	virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray,
 							 unsigned int count = 0,
-							 unsigned int offset = 0) override;
+							 unsigned int offset = 0,
+							 unsigned int instanceCount = 0) override;
+
+	virtual bool SupportsRenderTargets() const override { return true; }
+
+	virtual bool SupportsOcclusionQueries() const override { return true; }
+	virtual bool SupportsConditionalRendering() const override { return true; }
+	virtual int CreateOcclusionQuery() override;
+	virtual void DestroyOcclusionQuery(int query) override;
+	virtual void BeginOcclusionQuery(int query) override;
+	virtual void EndOcclusionQuery(int query) override;
+	virtual bool GetOcclusionQueryResult(int query, unsigned long long& samples) override;
+	virtual void BeginConditionalRendering(int query) override;
+	virtual void EndConditionalRendering() override;
 
 private:
 	GLenum GetPipelinePrimitiveTopology(PrimitiveTopology topology) const { return pipelinePrimitiveTopologies[(int)topology]; }
@@ -49,6 +74,14 @@ private:
 	bool depthTest = false; // in OpenGL it is disabled by default
 	bool faceCulling = false; // in OpenGL it is disabled by default
 	bool blending = false; // in OpenGL it is disabled by default
+	bool depthWrite = true; // in OpenGL it is enabled by default
+	bool colorWrite = true; // in OpenGL it is enabled by default
+	BlendMode blendMode = BlendMode::Alpha; // set up by SetBlending
+
+	// Query objects are kept around for reuse instead of being deleted
+	std::vector<GLuint> freeQueries;
+
+	std::unique_ptr<OpenGLStreamBuffer> streamBuffer;
 
 	const GLenum pipelinePrimitiveTopologies[4]
 	{
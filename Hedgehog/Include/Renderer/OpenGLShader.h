@@ -3,6 +3,7 @@
 #include <Renderer/Shader.h>
 
 #include <glad/glad.h>
+#include <unordered_map>
 #include <vector>
 
 
@@ -20,6 +21,9 @@ public:
 	virtual void Bind() override;
 	virtual void Unbind() override;
 
+	virtual unsigned int CommitConstants() override { return numberOfSlots++; }
+	virtual void SelectConstants(unsigned int slot) override;
+
 	virtual void UploadConstant(const std::string& name, float constant) override;
 	virtual void UploadConstant(const std::string& name, glm::vec2 constant) override;
 	virtual void UploadConstant(const std::string& name, glm::vec3 constant) override;
@@ -42,14 +46,45 @@ public:
 
 	virtual void UploadConstant(const std::string& name, const void* constant, unsigned long long size) override;
 
+	virtual bool HasGBufferOutput() const override { return gBufferOutput; }
+	virtual bool HasInstanceTransforms() const override { return instanceTransforms; }
+
 private:
+	// Value of a uniform as it was uploaded, ints are kept in the bits of the first float
+	struct UniformValue
+	{
+		unsigned int slot; // first of the slots it is the value of
+		GLenum type;
+		float data[16];
+	};
+
+	// The program has one set of uniforms, the values of the committed slots are kept here
+	// so a recorded draw gets its own values back when its slot is selected
+	struct Uniform
+	{
+		GLint location;
+		std::vector<UniformValue> values; // in the order of their slots
+		size_t uploaded = 0; // into the values, the one the program has
+	};
+
 	GLuint CompileShader(GLenum shaderType, const std::string& srcFilePath);
 	std::string ReadFile(const std::string& filePath);
 
 	std::vector<GLchar> getShaderInfoLog(GLint id);
 
+	// Keeps the value for the slots committed from now on and uploads it
+	void SetUniform(const std::string& name, GLenum type, const void* data);
+	static void Upload(GLint location, const UniformValue& value);
+
 private:
 	unsigned int shaderID = 0;
+	bool gBufferOutput = false;
+	bool instanceTransforms = false;
+
+	std::vector<Uniform> uniforms;
+	std::unordered_map<GLint, unsigned int> uniformIndices; // by location
+	std::vector<unsigned int> varyingUniforms; // with different values in different slots
+	unsigned int numberOfSlots = 0;
 };
 
 } // namespace Hedge
\ No newline at end of file
@@ -10,12 +10,14 @@ class OpenGLTexture2D : public Texture2D
 {
 public:
 	OpenGLTexture2D(const std::string& filename);
+	OpenGLTexture2D(unsigned int width, unsigned int height, const float* data);
 	virtual ~OpenGLTexture2D();
 
 	virtual void Bind(unsigned int slot = 0) const override;
 
 	virtual unsigned int GetWidth() const override { return width; }
 	virtual unsigned int GetHeight() const override { return height; }
+	virtual bool IsTranslucent() const override { return translucent; }
 
 private:
 	unsigned int textureID = 0;
@@ -24,6 +26,7 @@ private:
 
 	unsigned int width;
 	unsigned int height;
+	bool translucent = false;
 };
 
 } // namespace Hedge
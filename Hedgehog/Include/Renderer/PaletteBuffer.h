@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Renderer/Buffer.h>
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Where the segment palette of one animated mesh lives in the PaletteBuffer
+struct PaletteAllocation
+{
+	unsigned int offset = 0; // in matrices
+	unsigned int count = 0;
+	// Version of the animator palette copied in last, animators start counting at 1
+	unsigned int version = 0;
+};
+
+// Segment palettes of all animated meshes in a single storage buffer
+// Each palette keeps its slot and is copied in only when its animator produced a new pose,
+// whatever changed is uploaded once per frame with one call
+// The buffer holds NUMBER_OF_REGIONS copies used round robin, so the CPU doesn't write where the GPU may still read
+class PaletteBuffer
+{
+public:
+	static constexpr unsigned int NUMBER_OF_REGIONS = 3;
+	static constexpr unsigned int BINDING = 0;
+
+	// False if the API has no storage buffers, the palettes have to be uploaded as shader constants then
+	bool IsSupported();
+
+	PaletteAllocation Allocate(unsigned int count);
+	void Free(const PaletteAllocation& allocation);
+
+	void Write(const PaletteAllocation& allocation, const std::vector<glm::mat4>& palette);
+
+	// Uploads the changes into the next region and binds it for the draws of this frame
+	void Upload();
+
+	void CreateGuiControls();
+
+private:
+	void Reserve(unsigned int count);
+
+
+private:
+	struct DirtyRange
+	{
+		unsigned int first = 0;
+		unsigned int last = 0; // one past
+
+		bool IsEmpty() const { return first >= last; }
+		void Add(unsigned int first, unsigned int last);
+	};
+
+	std::unique_ptr<StorageBuffer> buffer;
+	bool supported = true;
+
+	// CPU copy of one region
+	std::vector<glm::mat4> palettes;
+	unsigned int used = 0;
+	std::vector<PaletteAllocation> freeAllocations;
+
+	unsigned int regionSize = 0; // in bytes, aligned for binding
+	unsigned int region = 0;
+	// Every region has to catch up with the changes made since it was uploaded last
+	DirtyRange dirtyRanges[NUMBER_OF_REGIONS];
+
+	// Counters of the last frame
+	unsigned int numberOfWrites = 0;
+	unsigned int writesSinceUpload = 0;
+	unsigned int uploadedBytes = 0;
+};
+
+} // namespace Hedge
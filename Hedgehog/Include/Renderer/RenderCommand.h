@@ -38,10 +38,28 @@ public:
 		rendererAPI->SetBlending(enable);
 	}
 
+	static void SetDepthWrite(bool enable)
+	{
+		rendererAPI->SetDepthWrite(enable);
+	}
+
+	static void SetColorWrite(bool enable)
+	{
+		rendererAPI->SetColorWrite(enable);
+	}
+
+	static void SetBlendMode(BlendMode mode)
+	{
+		rendererAPI->SetBlendMode(mode);
+	}
+
 	static bool GetWireframeMode() { return rendererAPI->GetWireframeMode(); }
 	static bool GetDepthTest() { return rendererAPI->GetDepthTest(); }
 	static bool GetFaceCulling() { return rendererAPI->GetFaceCulling(); }
 	static bool GetBlending() { return rendererAPI->GetBlending(); }
+	static bool GetDepthWrite() { return rendererAPI->GetDepthWrite(); }
+	static bool GetColorWrite() { return rendererAPI->GetColorWrite(); }
+	static BlendMode GetBlendMode() { return rendererAPI->GetBlendMode(); }
 
 
 	static void Resize(int width, int height, bool fillViewport = true)
@@ -85,12 +103,56 @@ public:
 		rendererAPI->EndFrame();
 	}
 
+	static StreamBuffer* GetStreamBuffer() { return rendererAPI->GetStreamBuffer(); }
+
 
 	static void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray,
 							unsigned int count = 0,
-							unsigned int offset = 0)
+							unsigned int offset = 0,
+							unsigned int instanceCount = 0)
+	{
+		rendererAPI->DrawIndexed(vertexArray, count, offset, instanceCount);
+	}
+
+
+	static bool SupportsRenderTargets() { return rendererAPI->SupportsRenderTargets(); }
+
+	static bool SupportsOcclusionQueries() { return rendererAPI->SupportsOcclusionQueries(); }
+	static bool SupportsConditionalRendering() { return rendererAPI->SupportsConditionalRendering(); }
+
+	static int CreateOcclusionQuery()
+	{
+		return rendererAPI->CreateOcclusionQuery();
+	}
+
+	static void DestroyOcclusionQuery(int query)
+	{
+		rendererAPI->DestroyOcclusionQuery(query);
+	}
+
+	static void BeginOcclusionQuery(int query)
+	{
+		rendererAPI->BeginOcclusionQuery(query);
+	}
+
+	static void EndOcclusionQuery(int query)
+	{
+		rendererAPI->EndOcclusionQuery(query);
+	}
+
+	static bool GetOcclusionQueryResult(int query, unsigned long long& samples)
+	{
+		return rendererAPI->GetOcclusionQueryResult(query, samples);
+	}
+
+	static void BeginConditionalRendering(int query)
+	{
+		rendererAPI->BeginConditionalRendering(query);
+	}
+
+	static void EndConditionalRendering()
 	{
-		rendererAPI->DrawIndexed(vertexArray, count, offset);
+		rendererAPI->EndConditionalRendering();
 	}
 
 private:
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Renderer/OcclusionQueries.h>
+#include <Renderer/Shader.h>
+#include <Renderer/VertexArray.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Passes are drawn in this order, everything of one before the next
+enum class RenderPass
+{
+	Depth = 0, // depth only pre-pass of the opaque groups, so the passes after it shade each pixel once
+	GBuffer = 1, // opaque surfaces of deferred shading, lit before anything else is drawn
+	Main = 2,
+	Transparency = 3, // translucent groups of weighted blended transparency, in no particular order
+};
+
+// Per object part of the draws, shared by the packets of all of its groups
+struct ObjectConstants
+{
+	std::shared_ptr<VertexArray> vertexArray;
+	glm::mat4 transform;
+	unsigned int constantSlot; // committed by the shader when the object was submitted
+	OcclusionQueries* occlusionQueries; // nullptr if the groups aren't queried
+	std::shared_ptr<VertexArray> depthVertexArray; // positions only, nullptr if it isn't in the depth pre-pass
+	unsigned int instanceOffset; // into the instance transforms of the frame
+	unsigned int instanceCount; // entities drawn by the object, 0 if it isn't a batch of them
+	MeshGroups* groups; // of the entity, nullptr if it was submitted without, always set if the groups are queried
+};
+
+struct DrawPacket
+{
+	uint64_t key;
+	unsigned int object; // into the objects of the queue
+	int group; // into the groups of the vertex array, -1 to draw all of it
+};
+
+// Draws recorded during the scene, sorted by their keys and executed at its end
+// From the most significant bits down a key is the pass, translucency and then
+// shader, material and depth front to back for opaque draws,
+// depth back to front, shader and material for translucent ones
+class RenderQueue
+{
+public:
+	static uint64_t CreateKey(RenderPass pass, bool translucent, unsigned int shader, unsigned int material, float depth);
+	static RenderPass GetPass(uint64_t key);
+
+	// Small ids for the keys, given out the first time they are seen in the scene
+	unsigned int GetShaderId(const Shader* shader);
+	unsigned int GetMaterialId(const VertexArray* vertexArray);
+
+	unsigned int AddObject(const ObjectConstants& object);
+	void Add(uint64_t key, unsigned int object, int group = -1);
+
+	// Radix sort on the keys, skipped if they are in order already
+	void Sort();
+	void Clear();
+
+	const std::vector<DrawPacket>& GetPackets() const { return packets; }
+	const ObjectConstants& GetObject(unsigned int object) const { return objects[object]; }
+
+
+public:
+	// Of the last executed scene
+	unsigned int numberOfPackets = 0;
+	unsigned int numberOfBinds = 0;
+	unsigned int numberOfDepthDraws = 0;
+	unsigned int numberOfBatches = 0;
+	unsigned int numberOfBatchedInstances = 0;
+	double sortDuration = 0.0; // in ms
+
+private:
+	std::vector<ObjectConstants> objects;
+	std::vector<DrawPacket> packets;
+	std::vector<DrawPacket> sortedPackets; // scratch for the sort
+
+	std::unordered_map<const Shader*, unsigned int> shaderIds;
+	std::unordered_map<const VertexArray*, unsigned int> materialIds;
+};
+
+} // namespace Hedge
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+enum class RenderTargetFormat
+{
+	RGBA8,
+	RGBA16F,
+	RGBA32F,
+};
+
+struct RenderTargetDescription
+{
+	unsigned int width = 0;
+	unsigned int height = 0;
+	// Attachment i is written by the pixel shader output at location i
+	std::vector<RenderTargetFormat> colorFormats;
+	// Same format as the depth buffer of the window, so it can be copied over
+	bool depth = true;
+};
+
+// Color and depth textures to draw into instead of the window, to be read by later passes
+class RenderTarget
+{
+public:
+	virtual ~RenderTarget() {}
+
+	// Draws go into the target until Unbind, the viewport stays as it is
+	virtual void Bind() = 0;
+	virtual void Unbind() = 0;
+
+	// Every color attachment and the depth
+	virtual void Clear(const glm::vec4& color) = 0;
+	// Only the one color attachment
+	virtual void ClearColor(unsigned int attachment, const glm::vec4& color) = 0;
+
+	virtual void BindColorTexture(unsigned int attachment, unsigned int slot) const = 0;
+
+	// Copies the depth into the depth buffer of the window, so draws done there afterwards are hidden by what the target has
+	virtual void CopyDepthToWindow() const = 0;
+	// The other way around, so draws into the target are hidden by what the window has
+	virtual void CopyDepthFromWindow() = 0;
+
+	virtual const RenderTargetDescription& GetDescription() const = 0;
+
+	// Returns nullptr if the API doesn't support render targets (yet)
+	static RenderTarget* Create(const RenderTargetDescription& description);
+};
+
+} // namespace Hedge
@@ -8,10 +8,19 @@
 #include <Renderer/Shader.h>
 #include <Renderer/Camera.h>
 #include <Renderer/Texture.h>
+#include <Renderer/Culling.h>
+#include <Renderer/FrameConstants.h>
+#include <Renderer/OcclusionBuffer.h>
+#include <Renderer/OcclusionQueries.h>
+#include <Renderer/RenderQueue.h>
+#include <Renderer/DeferredShading.h>
+#include <Renderer/WeightedBlendedTransparency.h>
 
 #include <Component/Entity.h>
 
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 
 namespace Hedge
@@ -24,20 +33,123 @@ public:
 	static void SetDepthTest(bool enable);
 	static void SetFaceCulling(bool enable);
 	static void SetBlending(bool enable);
+	// Opaque groups of the meshes with a position only vertex array go into the depth buffer first
+	static void SetDepthPrePass(bool enable) { depthPrePass = enable; }
+	static bool GetDepthPrePass() { return depthPrePass; }
+	// Entities of the same vertex array are drawn as the instances of one draw, their transforms streamed into a storage buffer
+	// Only for shaders that read them from there, see Shader::HasInstanceTransforms, and vertex arrays without instance data of their own
+	// Entities submitted with constants of their own are left out, the batch draws with the constants of its first entity
+	static void SetInstancing(bool enable) { instancing = enable; }
+	static bool GetInstancing() { return instancing; }
+	static void SetFrustumCulling(bool enable) { frustumCulling = enable; }
+	static bool GetFrustumCulling() { return frustumCulling; }
+	// Taken into account by the next BeginScene, forward shading is used if the API has no render targets
+	static DeferredShading& GetDeferredShading() { return deferredShading; }
+	// Also taken into account by the next BeginScene, translucent groups are sorted back to front without it
+	static WeightedBlendedTransparency& GetTransparency() { return transparency; }
 
 	static void BeginScene(Entity camera);
+	// Sorts and executes the draws of the scene
 	static void EndScene();
 
+	// Uploads the camera and lights once for all of the shaders, the camera part is filled in from the scene camera
+	// False if the API has no shared constant buffer, the constants have to be uploaded to every shader then
+	static bool SetFrameConstants(const FrameConstants& constants);
+
+	// Records the draws of the visible vertex groups, they are executed by EndScene
+	// The constants of the shader have to be uploaded before, they are committed here
+	// Vertex groups hidden behind the occluders are skipped if an occlusion buffer is given,
+	// and those the GPU found hidden in the last frames if occlusion queries are given
+	// The depth vertex array draws the same positions for the depth pre-pass, only for meshes the shader doesn't move the vertices of
+	// Object constants tell that more than the transform was uploaded for this entity alone, like a light color or a palette offset
+	// Vertex groups of a mesh that isn't rigid are drawn without any tests, their bounds only hold the bind pose
+	// The groups of the entity keep its enabled groups, their order and query results, the vertex array may be shared
+	// Without them all of the groups are drawn and none are queried
 	static void Submit(const std::shared_ptr<VertexArray>& vertexArray,
-					   const glm::mat4x4& transform = glm::mat4x4(1.0f));
+					   const glm::mat4x4& transform = glm::mat4x4(1.0f),
+					   const OcclusionBuffer* occlusionBuffer = nullptr,
+					   OcclusionQueries* occlusionQueries = nullptr,
+					   const std::shared_ptr<VertexArray>& depthVertexArray = nullptr,
+					   bool objectConstants = false,
+					   bool rigid = true,
+					   MeshGroups* groups = nullptr);
+
+	// Tests model space bounds against the frustum of the scene camera and then the occluders, counts towards the statistics as a mesh
+	static bool IsVisible(const BoundingBox& bounds, const glm::mat4x4& transform,
+						  const OcclusionBuffer* occlusionBuffer = nullptr);
+
+	// Reset by BeginScene
+	static const CullingStatistics& GetCullingStatistics() { return cullingStatistics; }
+	static const RenderQueue& GetRenderQueue() { return renderQueue; }
 
 	static RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
 
+	static constexpr unsigned int INSTANCE_BINDING = 4;
+
+private:
+	// Submitted entities of one vertex array, recorded as a single object at the end of the scene
+	struct InstanceBatch
+	{
+		std::shared_ptr<VertexArray> vertexArray;
+		std::shared_ptr<VertexArray> depthVertexArray;
+		const OcclusionBuffer* occlusionBuffer;
+		OcclusionQueries* occlusionQueries;
+		unsigned int constantSlot;
+		MeshGroups* groups; // of its first entity, the others have all of theirs enabled too
+		std::vector<glm::mat4> transforms;
+	};
+
+	// Vertex buffers stepped per instance, like offsets
+	static bool HasInstanceData(const VertexArray& vertexArray);
+	static bool IsInstanceable(const VertexArray& vertexArray);
+	// Adds the object and the packets of its visible groups to the render queue
+	// Groups of a batch of instances aren't culled or queried, the transform only sorts them
+	static void Record(const std::shared_ptr<VertexArray>& vertexArray,
+					   const glm::mat4x4& transform,
+					   unsigned int constantSlot,
+					   const OcclusionBuffer* occlusionBuffer,
+					   OcclusionQueries* occlusionQueries,
+					   const std::shared_ptr<VertexArray>& depthVertexArray,
+					   MeshGroups* groups,
+					   unsigned int instanceOffset = 0,
+					   unsigned int instanceCount = 0,
+					   bool rigid = true);
+	// Writes the transforms of all of the batches into the instance buffer before the queue is sorted
+	static void RecordInstanceBatches();
+	// Distances of the groups are only updated if the camera or the transform moved since the last Submit
+	static void UpdateGroupOrder(VertexArray& vertexArray, GroupOrder& order, const glm::vec3& cameraPosition, const glm::mat4x4& transform);
+
 private:
 	// C++17 has inline static for static member definition
 	inline static Entity sceneCamera;
 
 	inline static std::set<std::shared_ptr<Shader>> usedShaders;
+	inline static std::set<OcclusionQueries*> usedOcclusionQueries;
+
+	inline static RenderQueue renderQueue;
+	// For the vertex arrays submitted without the groups of an entity, sorted again every time
+	inline static GroupOrder unkeptGroupOrder;
+
+	inline static std::unique_ptr<ConstantBuffer> frameConstantBuffer;
+	inline static bool frameConstantBufferCreated = false;
+
+	inline static bool depthPrePass = false;
+
+	inline static bool instancing = true;
+	inline static std::vector<InstanceBatch> instanceBatches;
+	inline static std::unordered_map<const VertexArray*, unsigned int> instanceBatchIndices;
+	inline static std::vector<glm::mat4> instanceTransforms;
+	inline static std::unique_ptr<StorageBuffer> instanceBuffer;
+	inline static bool instanceBufferSupported = true;
+
+	inline static DeferredShading deferredShading;
+	inline static bool deferredActive = false; // for the current scene
+	inline static WeightedBlendedTransparency transparency;
+	inline static bool transparencyActive = false; // for the current scene
+
+	inline static bool frustumCulling = true;
+	inline static FrustumPlanes frustumPlanes;
+	inline static CullingStatistics cullingStatistics;
 };
 
 } // namespace Hedge
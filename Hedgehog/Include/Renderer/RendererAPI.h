@@ -10,6 +10,12 @@
 namespace Hedge
 {
 
+enum class BlendMode
+{
+	Alpha = 0, // source alpha over the destination, in every attachment
+	WeightedBlended = 1, // attachment 0 adds up, attachment 1 is multiplied by one minus the source, see WeightedBlendedTransparency
+};
+
 class RendererAPI
 {
 public:
@@ -28,11 +34,19 @@ public:
 	virtual void SetDepthTest(bool enable) = 0;
 	virtual void SetFaceCulling(bool enable) = 0;
 	virtual void SetBlending(bool enable) = 0;
+	// Vulkan and DirectX12 bake these into the pipeline when a vertex array is created, like the depth test
+	virtual void SetDepthWrite(bool enable) = 0;
+	virtual void SetColorWrite(bool enable) = 0;
+	// Only while blending is enabled
+	virtual void SetBlendMode(BlendMode mode) = 0;
 
 	virtual bool GetWireframeMode() const = 0;
 	virtual bool GetDepthTest() const = 0;
 	virtual bool GetFaceCulling() const = 0;
 	virtual bool GetBlending() const = 0;
+	virtual bool GetDepthWrite() const = 0;
+	virtual bool GetColorWrite() const = 0;
+	virtual BlendMode GetBlendMode() const = 0;
 
 	virtual void Resize(int width, int height, bool fillViewport = true) = 0;
 	virtual void SetViewport(int x, int y, int width, int height) = 0;
@@ -44,9 +58,31 @@ public:
 	virtual void BeginFrame() = 0;
 	virtual void EndFrame() = 0;
 
+	// Per frame ring of mapped memory, begun and ended with the frames, nullptr if the API doesn't have one (yet)
+	virtual StreamBuffer* GetStreamBuffer() { return nullptr; }
+
+	// Instance count of the vertex array unless one is given
 	virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray,
 							 unsigned int count = 0,
-							 unsigned int offset = 0) = 0;
+							 unsigned int offset = 0,
+							 unsigned int instanceCount = 0) = 0;
+
+	// If RenderTarget::Create gives offscreen targets to draw into
+	virtual bool SupportsRenderTargets() const = 0;
+
+	// Occlusion queries tell if any samples passed the depth test in between Begin and End
+	// Results come back frames later, GetOcclusionQueryResult never waits for the GPU and returns false until then
+	virtual bool SupportsOcclusionQueries() const = 0;
+	virtual bool SupportsConditionalRendering() const = 0;
+	// Returns -1 if there are no queries left
+	virtual int CreateOcclusionQuery() = 0;
+	virtual void DestroyOcclusionQuery(int query) = 0;
+	virtual void BeginOcclusionQuery(int query) = 0;
+	virtual void EndOcclusionQuery(int query) = 0;
+	virtual bool GetOcclusionQueryResult(int query, unsigned long long& samples) = 0;
+	// Draws in between are skipped by the GPU if the query found no samples, and done if its result isn't there yet
+	virtual void BeginConditionalRendering(int query) = 0;
+	virtual void EndConditionalRendering() = 0;
 
 	static API GetAPI() { return api; }
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Renderer/Geometry.h>
+#include <Renderer/MeshMaterial.h>
+#include <Renderer/VertexArray.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+
+namespace Hedge
+{
+
+// Geometries, materials and textures by the files they were made from, so meshes loading the same files share them
+// and the vertex arrays of the meshes with the same geometry and material are the one, which the renderer batches
+// Only weak references are kept, a resource goes away with the last mesh using it
+class ResourceCache
+{
+public:
+	static std::shared_ptr<Geometry> GetGeometry(const std::string& modelFilename,
+												 PrimitiveTopology primitiveTopology, const BufferLayout& bufferLayout);
+	// OpenGL keeps a single set of uniforms per program, there the per object ones would be those of the last geometry drawn,
+	// so a material is only shared by the meshes of the one geometry
+	static std::shared_ptr<MeshMaterial> GetMaterial(const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
+													 const ConstantBufferDescription& constBufferDesc,
+													 const std::vector<TextureDescription>& textureDescriptions,
+													 const Geometry* geometry);
+	static std::shared_ptr<Texture> GetTexture(const std::string& filename);
+	// Changes to it, like added vertex buffers or an instance count, show up on every mesh sharing it
+	static std::shared_ptr<VertexArray> GetVertexArray(const std::shared_ptr<Geometry>& geometry, const std::shared_ptr<MeshMaterial>& material);
+
+	static void CreateGuiControls();
+
+private:
+	template <typename Key, typename Resource>
+	static std::shared_ptr<Resource> Find(std::map<Key, std::weak_ptr<Resource>>& resources, const Key& key)
+	{
+		requests++;
+
+		auto resource = resources.find(key);
+		if (resource != resources.end())
+		{
+			if (auto shared = resource->second.lock())
+			{
+				hits++;
+				return shared;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// Drops the expired ones and returns how many are left
+	template <typename Key, typename Resource>
+	static unsigned int Count(std::map<Key, std::weak_ptr<Resource>>& resources)
+	{
+		std::erase_if(resources, [](const auto& resource) { return resource.second.expired(); });
+		return (unsigned int)resources.size();
+	}
+
+
+public:
+	// Since the start
+	inline static unsigned int requests = 0;
+	inline static unsigned int hits = 0;
+
+private:
+	inline static std::map<std::string, std::weak_ptr<Geometry>> geometries;
+	inline static std::map<std::string, std::weak_ptr<MeshMaterial>> materials;
+	inline static std::map<std::string, std::weak_ptr<Texture>> textures;
+	inline static std::map<std::pair<const Geometry*, const MeshMaterial*>, std::weak_ptr<VertexArray>> vertexArrays;
+};
+
+} // namespace Hedge
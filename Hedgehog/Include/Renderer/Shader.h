@@ -66,6 +66,13 @@ public:
 	virtual void Bind() = 0;
 	virtual void Unbind() = 0;
 
+	// For draws that are recorded now and executed later, after other draws have uploaded their own constants
+	// The constants uploaded so far are kept in a slot of their own and the next uploads go into a new one
+	// OpenGL keeps a single set of uniforms per program, its shader uploads the values of the slot again when it is selected
+	virtual unsigned int CommitConstants() { return 0; }
+	// The next Bind uses the constants of the committed slot
+	virtual void SelectConstants(unsigned int slot) { /* Do Nothing by default */ }
+
 	virtual void SetupConstantBuffers(ConstantBufferDescription constBufferDesc) { /* Do Nothing by default */ }
 
 	virtual void UploadConstant(const std::string& name, float constant) = 0;
@@ -92,6 +99,13 @@ public:
 
 	virtual const size_t GetConstBufferCount() const { return 0; }
 
+	// The pixel shader can also write the G-buffer of deferred shading, it does so while u_gBufferPass is set,
+	// and the targets of the weighted blended transparency while u_transparencyPass is set
+	virtual bool HasGBufferOutput() const { return false; }
+	// The vertex shader takes the transforms of batched instances from the instance buffer while u_instanced is set,
+	// starting at u_instanceOffset, see Renderer::SetInstancing
+	virtual bool HasInstanceTransforms() const { return false; }
+
 	static Shader* Create(const std::string& filePath);
 	static Shader* Create(const std::string& vertexFilePath,
 						  const std::string& pixelFilePath,
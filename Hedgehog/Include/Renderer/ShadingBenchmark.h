@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Component/Scene.h>
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+enum class ShadingConfiguration
+{
+	Forward = 0,
+	ForwardDepthPrePass = 1,
+	Deferred = 2,
+	DeferredDepthPrePass = 3,
+	Count = 4,
+};
+
+struct ShadingBenchmarkResult
+{
+	int numberOfLights = 0;
+	double durations[(int)ShadingConfiguration::Count] = {}; // in ms per frame
+};
+
+// Forward against deferred shading of the scene, each with and without the depth pre-pass,
+// as the number of point lights grows, all with the light clusters
+// Frame times have to include the GPU, so it runs over the next frames of the application instead of in one call,
+// for every light count one configuration after another. The lights are scattered around the camera and removed again
+// Turn vsync off for meaningful numbers and keep the camera still while it runs
+class ShadingBenchmark
+{
+public:
+	void Start(Scene& scene,
+			   const std::vector<int>& lightCounts = { 0, 16, 64, 256, 1024 },
+			   int numberOfFrames = 120);
+	bool IsRunning() const { return running; }
+
+	// Once every frame before the scene is updated, with the duration of the last frame
+	void OnFrame(Scene& scene, double frameDuration);
+
+	const std::vector<ShadingBenchmarkResult>& GetResults() const { return results; }
+
+private:
+	void BeginRun(Scene& scene);
+	void EndRun(Scene& scene);
+	void Finish();
+
+private:
+	static constexpr int WARMUP_FRAMES = 10; // after every switch, the first one still has the old settings
+
+	std::vector<int> lightCounts;
+	int numberOfFrames = 0;
+
+	bool running = false;
+	size_t run = 0; // light count and configuration
+	int frame = 0;
+	double durationSum = 0.0;
+
+	std::vector<Entity> lights;
+	bool deferredWasEnabled = false;
+	bool depthPrePassWasEnabled = false;
+	bool clustersWereEnabled = false;
+
+	std::vector<ShadingBenchmarkResult> results;
+};
+
+} // namespace Hedge
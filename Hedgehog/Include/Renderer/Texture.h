@@ -33,6 +33,8 @@ public:
 
 	virtual unsigned int GetWidth() const = 0;
 	virtual unsigned int GetHeight() const = 0;
+	// Some texels aren't fully opaque, found while decoding the file
+	virtual bool IsTranslucent() const = 0;
 };
 
 
@@ -40,6 +42,12 @@ class Texture2D : public Texture
 {
 public:
 	static Texture2D* Create(const std::string& filename);
+	// Unfiltered RGBA float texture for data tables, width * height * 4 floats
+	static Texture2D* Create(unsigned int width, unsigned int height, const float* data);
+
+protected:
+	// An alpha channel alone doesn't say much, plenty of textures have one that is opaque everywhere
+	static bool HasTranslucentTexels(const unsigned char* data, unsigned int width, unsigned int height, int channels);
 };
 
 } // namespace Hedge
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include <Renderer/Buffer.h>
 #include <Renderer/Shader.h>
@@ -11,6 +13,37 @@
 namespace Hedge
 {
 
+// Groups of a vertex array by their distance from the camera, nearest first
+// Kept from one Submit to the next, the distances are only updated when the camera or the transform moved
+struct GroupOrder
+{
+	struct GroupDistance
+	{
+		float distance;
+		int group; // into the groups of the vertex array
+	};
+
+	// NaN never compares equal, so the first Submit always fills it in
+	glm::vec3 cameraPosition{ std::numeric_limits<float>::quiet_NaN() };
+	glm::mat4 transform{ 0.0f };
+	std::vector<GroupDistance> groups;
+};
+
+// Of one entity for one of the groups of its vertex array
+struct GroupState
+{
+	bool enabled = true;
+	OcclusionQueryState occlusion;
+};
+
+// Vertex arrays are shared by the meshes of the same geometry and material, what differs between the entities lives here
+// Added to the entity by the scene, the groups are sized to those of the vertex array by Renderer::Submit
+struct MeshGroups
+{
+	std::vector<GroupState> groups;
+	GroupOrder order;
+};
+
 // TODO
 // multiple vertex/index buffers rendering
 // maybe submit with name so it can be selected what will be rendered, defaulting to rendering everything in order
@@ -48,6 +81,7 @@ public:
 							   PrimitiveTopology primitiveTopology, const BufferLayout& inputLayout,
 							   const std::vector<Hedge::TextureDescription>& textureDescriptions);
 
+
 protected:
 	int FindIndex(TextureType type, const std::vector<Hedge::TextureDescription>& textureDescriptions) const;
 	std::vector<int> FindIndices(TextureType type, const std::vector<Hedge::TextureDescription>& textureDescriptions) const;
@@ -4,6 +4,9 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cassert>
+#include <vector>
+
 
 namespace Hedge
 {
@@ -23,11 +26,30 @@ public:
 
 	virtual void SetData(const float* vertices, unsigned int size) override;
 
+private:
+	// Copies the data to where the draws of this frame read it from, the stream buffer if there is room left in it
+	void Stream() const;
+
 private:
 	BufferLayout layout;
 
 	VkBuffer vertexBuffer = VK_NULL_HANDLE;
 	VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
+	unsigned int size = 0;
+
+	// Once SetData is called, the data is drawn from the stream buffer
+	// A copy stays on the CPU, frames that don't set it stream it again when it is bound
+	std::vector<float> dynamicData;
+	mutable VkBuffer streamSource = VK_NULL_HANDLE;
+	mutable VkDeviceSize streamOffset = 0;
+	mutable unsigned long long streamFrame = 0;
+	mutable bool streamed = false;
+
+	// Without room in the stream buffer the data goes here, one slice per frame in flight
+	// Only the last data of a frame survives in it, draws recorded before that read it too
+	mutable VkBuffer fallbackBuffer = VK_NULL_HANDLE;
+	mutable VkDeviceMemory fallbackBufferMemory = VK_NULL_HANDLE;
+	mutable uint8_t* fallbackData = nullptr;
 };
 
 
@@ -49,4 +71,63 @@ private:
 	VkDeviceMemory indexBufferMemory = VK_NULL_HANDLE;
 };
 
+
+// Bound to the shared constants set, see VulkanContext::BindSharedDescriptorSets
+// Every frame in flight writes its own slice, so SetData doesn't overwrite what the GPU may still be reading
+class VulkanConstantBuffer : public ConstantBuffer
+{
+public:
+	VulkanConstantBuffer(unsigned int size);
+	virtual ~VulkanConstantBuffer() override;
+
+	virtual void Bind(unsigned int binding) const override;
+
+	virtual void SetData(const void* data, unsigned int size) override;
+
+	virtual unsigned int GetSize() const override { return size; }
+
+private:
+	unsigned int size = 0;
+	VkDeviceSize sliceSize = 0;
+
+	// Where SetData put the constants in the stream buffer, bound from there while it is still the same frame
+	unsigned int streamOffset = 0;
+	unsigned long long streamFrame = 0;
+	bool streamed = false;
+
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
+	uint8_t* mappedData = nullptr;
+
+	VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+};
+
+
+// Regions go round with the frames in flight, their fences are waited on before the frame begins
+class VulkanStreamBuffer : public StreamBuffer
+{
+public:
+	VulkanStreamBuffer(unsigned int regionSize);
+	virtual ~VulkanStreamBuffer();
+
+	virtual void BeginFrame() override;
+	virtual void EndFrame() override {}
+
+	// Point the shared sets of the context at the allocation, see VulkanContext::BindSharedDescriptorSets
+	virtual void BindStorage(unsigned int binding, unsigned int offset, unsigned int size) const override;
+	virtual void BindConstants(unsigned int binding, unsigned int offset, unsigned int size) const override;
+
+	VkBuffer GetBuffer() const { return buffer; }
+
+private:
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
+
+	// The sets cover a fixed range from the dynamic offset, bound allocations can't be any bigger
+	VkDescriptorSet constantsSet = VK_NULL_HANDLE;
+	VkDescriptorSet storageSet = VK_NULL_HANDLE;
+	VkDeviceSize constantsRange = 0;
+	VkDeviceSize storageRange = 0;
+};
+
 } // namespace Hedge
@@ -34,6 +34,8 @@ public:
 	friend class VulkanVertexArray;
 	friend class VulkanVertexBuffer;
 	friend class VulkanIndexBuffer;
+	friend class VulkanStreamBuffer;
+	friend class VulkanConstantBuffer;
 
 private:
 	vkb::Instance CreateInstance();
@@ -45,6 +47,8 @@ private:
 	void CreateFrameBuffers(unsigned int width, unsigned int height);
 	void CreateSyncObjects();
 	void CreateDescriptorPool();
+	void CreateQueryPool();
+	void CreateSharedDescriptorSetLayouts();
 
 	void DestroySwapChain();
 	void DestroyFrameBuffers();
@@ -52,6 +56,9 @@ private:
 
 	void ResizeSwapChain(unsigned int width, unsigned int height);
 
+	// Binds the sets every shader shares, like the frame constants, to the first set numbers of the pipeline layout
+	void BindSharedDescriptorSets(VkPipelineLayout pipelineLayout);
+
 	uint32_t WaitForNextFrame();
 
 	uint32_t FindMemoryType(uint32_t requiredType, VkMemoryPropertyFlags requiredProperties);
@@ -95,11 +102,18 @@ private:
 
 private:
 	static int const NUM_FRAMES_IN_FLIGHT = 3;
+	static uint32_t const NUM_OCCLUSION_QUERIES = 4096;
+	// Shader sets are numbered after the shared ones
+	static uint32_t const NUM_SHARED_DESCRIPTOR_SETS = 2;
+	// Storage bindings of the renderer, palettes, light clusters and instances, see Renderer::INSTANCE_BINDING
+	static uint32_t const NUM_SHARED_STORAGE_BINDINGS = 5;
 
 	HWND windowHandle = NULL;
 	int swapInterval = 0;
 	uint32_t swapChainImageIndex = 0;
 	int frameInFlightIndex = 0;
+	// Submitted so far, the one being recorded while in between BeginFrame and EndFrame
+	unsigned long long frameNumber = 0;
 
 	VkInstance instance; // Vulkan library handle
 	VkDebugUtilsMessengerEXT debugMessenger; // Vulkan debug output handle
@@ -138,6 +152,17 @@ private:
 	std::vector<VkFence> swapChainImageFences;
 
 	VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+
+	// Set 0, the constant buffer bound to binding 0, with the offset of the current frame
+	VkDescriptorSetLayout sharedConstantsLayout = VK_NULL_HANDLE;
+	VkDescriptorSet sharedConstantsSet = VK_NULL_HANDLE;
+	uint32_t sharedConstantsOffset = 0;
+	// Set 1, the storage buffers, every binding has an offset of its own
+	VkDescriptorSetLayout sharedStorageLayout = VK_NULL_HANDLE;
+	VkDescriptorSet sharedStorageSet = VK_NULL_HANDLE;
+	uint32_t sharedStorageOffsets[NUM_SHARED_STORAGE_BINDINGS] = {};
+
+	VkQueryPool occlusionQueryPool = VK_NULL_HANDLE;
 };
 
 }  // namespace Hedge
@@ -3,6 +3,9 @@
 #include <Renderer/RendererAPI.h>
 
 #include <Renderer/VulkanContext.h>
+#include <Renderer/VulkanBuffer.h>
+
+#include <memory>
 
 
 namespace Hedge
@@ -17,25 +20,47 @@ public:
 	virtual void SetDepthTest(bool enable) override { depthTest = enable; }
 	virtual void SetFaceCulling(bool enable) override { faceCulling = enable; }
 	virtual void SetBlending(bool enable) override { blending = enable; }
+	virtual void SetDepthWrite(bool enable) override { depthWrite = enable; }
+	virtual void SetColorWrite(bool enable) override { colorWrite = enable; }
+	virtual void SetBlendMode(BlendMode mode) override { blendMode = mode; }
 
 	virtual bool GetWireframeMode() const override { return wireframeMode; }
 	virtual bool GetDepthTest() const override { return depthTest; }
 	virtual bool GetFaceCulling() const override { return faceCulling; }
 	virtual bool GetBlending() const override { return blending; }
+	virtual bool GetDepthWrite() const override { return depthWrite; }
+	virtual bool GetColorWrite() const override { return colorWrite; }
+	virtual BlendMode GetBlendMode() const override { return blendMode; }
 
 	virtual void Resize(int width, int height, bool fillViewport = true) override;
 	virtual void SetViewport(int x, int y, int width, int height) override;
 	virtual void SetScissor(int x, int y, int width, int height) override;
 
 	virtual void SetClearColor(const glm::vec4& color) override { clearColor = color; }
-	virtual void Begin() override {}
+	virtual void Begin() override;
 	virtual void End() override;
 	virtual void BeginFrame() override;
 	virtual void EndFrame() override;
 
+	virtual StreamBuffer* GetStreamBuffer() override { return streamBuffer.get(); }
+
 	virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray,
 							 unsigned int count = 0,
-							 unsigned int offset = 0) override;
+							 unsigned int offset = 0,
+							 unsigned int instanceCount = 0) override;
+
+	virtual bool SupportsRenderTargets() const override { return false; }
+
+	// Conditional rendering needs VK_EXT_conditional_rendering and the results copied to a buffer, not there yet
+	virtual bool SupportsOcclusionQueries() const override { return true; }
+	virtual bool SupportsConditionalRendering() const override { return false; }
+	virtual int CreateOcclusionQuery() override;
+	virtual void DestroyOcclusionQuery(int query) override;
+	virtual void BeginOcclusionQuery(int query) override;
+	virtual void EndOcclusionQuery(int query) override;
+	virtual bool GetOcclusionQueryResult(int query, unsigned long long& samples) override;
+	virtual void BeginConditionalRendering(int query) override {}
+	virtual void EndConditionalRendering() override {}
 
 
 	const VkViewport& GetViewport() const { return viewport; }
@@ -48,6 +73,16 @@ private:
 	bool depthTest = false;
 	bool faceCulling = false;
 	bool blending = false;
+	bool depthWrite = true;
+	bool colorWrite = true;
+	BlendMode blendMode = BlendMode::Alpha;
+
+	// Queries have to be reset outside of the render pass before they can be used again,
+	// so destroyed ones wait for the next BeginFrame before they are handed out
+	std::vector<uint32_t> freeQueries;
+	std::vector<uint32_t> queriesToReset;
+
+	std::unique_ptr<VulkanStreamBuffer> streamBuffer;
 
 	glm::vec4 clearColor;
 	VkViewport viewport = {};
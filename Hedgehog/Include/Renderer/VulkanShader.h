@@ -26,6 +26,9 @@ public:
 	virtual void Bind() override;
 	virtual void Unbind() override;
 
+	virtual unsigned int CommitConstants() override;
+	virtual void SelectConstants(unsigned int slot) override { selectedSlot = (int)slot; }
+
 	virtual void SetupConstantBuffers(ConstantBufferDescription constBufferDesc) override;
 
 	virtual void UploadConstant(const std::string& name, float constant) override;
@@ -110,6 +113,7 @@ private:
 	};
 
 	size_t bindCount = 0;
+	int selectedSlot = -1;
 };
 
 } // namespace Hedge
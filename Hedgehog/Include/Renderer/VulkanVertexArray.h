@@ -5,6 +5,10 @@
 #include <Renderer/VulkanShader.h>
 #include <Renderer/VulkanContext.h>
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 
 namespace Hedge
 {
@@ -38,7 +42,18 @@ public:
 	void ResizeViewport();
 
 private:
+	// Shared by all of the vertex arrays with the same state, destroyed with the last one of them
+	struct Pipeline
+	{
+		VkDevice device = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+
+		~Pipeline() { vkDestroyPipeline(device, pipeline, nullptr); }
+	};
+
 	void CreatePipeline();
+	// Everything the pipeline is created from, packed into bytes
+	std::string CreatePipelineKey() const;
 	VkPipelineVertexInputStateCreateInfo CreateVertexInputState();
 	VkPipelineInputAssemblyStateCreateInfo CreateInputAssemblyState(PrimitiveTopology primitiveTopology) const;
 	VkPipelineViewportStateCreateInfo CreateViewportState() const;
@@ -70,7 +85,10 @@ private:
 	std::vector<std::pair<VertexGroup, float>> groups;
 	std::vector<std::shared_ptr<Texture>> textures;
 
-	VkPipeline pipeline = VK_NULL_HANDLE;
+	std::shared_ptr<Pipeline> pipeline;
+	// Replaced by ResizeViewport while the frames in flight most likely still use them
+	// Kept with the frame they were replaced in until its fence signaled, see Bind
+	std::vector<std::pair<std::shared_ptr<Pipeline>, unsigned long long>> retiredPipelines;
 
 	std::vector<VkVertexInputBindingDescription> vertexBindingDescriptions;
 	std::vector< VkVertexInputBindingDivisorDescriptionEXT> vertexBindingDivisorDescriptions;
@@ -94,6 +112,8 @@ private:
 	VkViewport viewport{};
 	VkRect2D scissor{};
 
+	inline static std::unordered_map<std::string, std::weak_ptr<Pipeline>> pipelineCache;
+
 	// These arrays are inline static so we can use them in constructor
 	// and not worry about order of initializtion
 	inline static const VkPrimitiveTopology pipelinePrimitiveTopologies[4]
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Renderer/RenderTarget.h>
+#include <Renderer/VertexArray.h>
+
+#include <memory>
+
+
+namespace Hedge
+{
+
+// Order independent transparency, the translucent surfaces are added up in any order with weights
+// that favor the near and opaque ones, so they don't have to be sorted back to front
+// One target sums up the weighted colors and alphas, another multiplies what is still seen of the surfaces behind,
+// the average color is then blended over the window with what is covered of it
+// Only shaders with the extra outputs take part, see Shader::HasGBufferOutput, the others are still sorted
+class WeightedBlendedTransparency
+{
+public:
+	enum Attachment
+	{
+		Accumulation = 0, // rgb = sum of the weighted premultiplied colors, a = sum of the weighted alphas
+		Revealage = 1, // r = product of one minus the alphas
+	};
+
+	// False if the API has no render targets
+	bool IsSupported() const;
+	bool IsActive() const;
+
+	// Draws go into the targets, tested against the depth of the window without writing it
+	void Begin();
+	// Blends the average color over the window
+	void End();
+
+	void CreateGuiControls();
+
+private:
+	void CreateCompositeVertexArray();
+
+
+public:
+	bool enabled = true;
+
+	// Of the last frame, counted by the renderer
+	unsigned int numberOfDraws = 0;
+
+private:
+	std::unique_ptr<RenderTarget> target;
+	std::shared_ptr<VertexArray> compositeVertexArray;
+
+	bool depthWrite = true;
+	bool blending = false;
+};
+
+} // namespace Hedge
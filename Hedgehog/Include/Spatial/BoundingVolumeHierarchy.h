@@ -0,0 +1,192 @@
+#pragma once
+
+#include <Renderer/Culling.h>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Leaf of an entity in the spatial index of the Scene
+struct SpatialProxy
+{
+	int proxy = -1;
+	// WorldTransform version the leaf was last moved with
+	unsigned int version = 0;
+};
+
+// Dynamic AABB tree, leaves can be added, moved and removed at any time
+// Leaves are stored fattened by a margin, so a leaf that moves a bit stays where it is
+// and only the leaves that got out of their fat box are reinserted, with the ancestors refitted and rebalanced on the way up
+class BoundingVolumeHierarchy
+{
+public:
+	static constexpr int NULL_NODE = -1;
+
+	BoundingVolumeHierarchy(float margin = 0.1f);
+
+	int CreateProxy(const BoundingBox& bounds, unsigned int userData);
+	void DestroyProxy(int proxy);
+	// Returns true if the leaf had to be reinserted
+	bool MoveProxy(int proxy, const BoundingBox& bounds);
+
+	void Clear();
+
+	unsigned int GetUserData(int proxy) const { return nodes[proxy].userData; }
+	const BoundingBox& GetFatBounds(int proxy) const { return nodes[proxy].bounds; }
+
+	int GetNumberOfProxies() const { return numberOfProxies; }
+	int GetHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+	// All the queries call function(userData) for every leaf whose fat box passes the test,
+	// leaves can be reported even though the exact bounds would fail it
+	template<typename Function>
+	void Query(const BoundingBox& box, Function&& function) const
+	{
+		Traverse([&box](const BoundingBox& bounds) { return bounds.Overlaps(box); }, function);
+	}
+
+	template<typename Function>
+	void Query(const FrustumPlanes& frustum, Function&& function) const
+	{
+		Traverse([&frustum](const BoundingBox& bounds) { return frustum.Intersects(bounds); }, function);
+	}
+
+	template<typename Function>
+	void QuerySphere(const glm::vec3& center, float radius, Function&& function) const
+	{
+		Traverse([&center, radius](const BoundingBox& bounds)
+			{
+				glm::vec3 closest = glm::min(glm::max(center, bounds.min), bounds.max);
+				glm::vec3 offset = closest - center;
+				return glm::dot(offset, offset) <= radius * radius;
+			},
+			function);
+	}
+
+	// Direction doesn't have to be normalized, distances are in its units
+	// function(userData) returns the distance of the hit within the leaf or a negative value if there isn't one,
+	// nodes further than the closest hit so far are skipped
+	template<typename Function>
+	void RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Function&& function) const
+	{
+		glm::vec3 inverseDirection = 1.0f / direction;
+
+		Traverse([&origin, &inverseDirection, &maxDistance](const BoundingBox& bounds)
+			{
+				return RayIntersects(bounds, origin, inverseDirection, maxDistance);
+			},
+			[&function, &maxDistance](unsigned int userData)
+			{
+				float distance = function(userData);
+				if (distance >= 0.0f)
+				{
+					maxDistance = std::min(maxDistance, distance);
+				}
+			});
+	}
+
+private:
+	struct Node
+	{
+		BoundingBox bounds;
+		unsigned int userData = 0;
+		// Free nodes are linked through their parent
+		int parent = NULL_NODE;
+		int left = NULL_NODE;
+		int right = NULL_NODE;
+		// Leaves are 0, free nodes -1
+		int height = -1;
+
+		bool IsLeaf() const { return left == NULL_NODE; }
+	};
+
+	// Deep enough for any balanced tree that fits in memory
+	static constexpr int TRAVERSAL_STACK_SIZE = 256;
+
+	template<typename Test, typename Function>
+	void Traverse(const Test& test, Function&& function) const
+	{
+		if (root == NULL_NODE)
+		{
+			return;
+		}
+
+		int stack[TRAVERSAL_STACK_SIZE];
+		int size = 0;
+		stack[size++] = root;
+
+		while (size > 0)
+		{
+			const Node& node = nodes[stack[--size]];
+			if (!test(node.bounds))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				function(node.userData);
+			}
+			else
+			{
+				assert(size + 2 <= TRAVERSAL_STACK_SIZE);
+				stack[size++] = node.right;
+				stack[size++] = node.left;
+			}
+		}
+	}
+
+	static bool RayIntersects(const BoundingBox& bounds, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance)
+	{
+		float entryDistance = 0.0f;
+		float exitDistance = maxDistance;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			// Parallel to the slab, an origin on one of its planes would give 0 * inf = NaN
+			if (std::isinf(inverseDirection[axis]))
+			{
+				if (origin[axis] < bounds.min[axis]
+					|| origin[axis] > bounds.max[axis])
+				{
+					return false;
+				}
+				continue;
+			}
+
+			float first = (bounds.min[axis] - origin[axis]) * inverseDirection[axis];
+			float second = (bounds.max[axis] - origin[axis]) * inverseDirection[axis];
+			entryDistance = std::max(entryDistance, std::min(first, second));
+			exitDistance = std::min(exitDistance, std::max(first, second));
+		}
+
+		return entryDistance <= exitDistance;
+	}
+
+	int AllocateNode();
+	void FreeNode(int node);
+
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	// Walks up from the node, rebalancing and recomputing the boxes and heights of every ancestor
+	void Refit(int node);
+	// Rotates the taller grandchild up if the children differ in height by more than one, returns the new root of the subtree
+	int Balance(int node);
+
+
+private:
+	float margin;
+
+	std::vector<Node> nodes;
+	int root = NULL_NODE;
+	int freeList = NULL_NODE;
+	int numberOfProxies = 0;
+};
+
+} // namespace Hedge
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+
+namespace Hedge
+{
+
+struct SpatialBenchmarkResult
+{
+	int numberOfEntities = 0;
+	int treeHeight = 0;
+	// All in ms, queries are per query and updates per frame
+	double buildDuration = 0.0;
+	double updateDuration = 0.0;
+	double frustumQueryDuration = 0.0;
+	double bruteForceDuration = 0.0;
+	double sphereQueryDuration = 0.0;
+	double boxQueryDuration = 0.0;
+	double rayCastDuration = 0.0;
+	// Every entity the brute force frustum test found was reported by the tree too
+	bool matchesBruteForce = true;
+};
+
+// Scatters boxes over a volume that grows with the entity count, keeps a tenth of them moving
+// and runs the queries of the BoundingVolumeHierarchy against them, frustum queries are compared to testing every box
+std::vector<SpatialBenchmarkResult> RunSpatialBenchmark(const std::vector<int>& entityCounts = { 10000, 100000, 1000000 },
+														int numberOfFrames = 30,
+														int numberOfQueries = 100);
+
+} // namespace Hedge
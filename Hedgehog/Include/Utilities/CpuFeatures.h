@@ -0,0 +1,63 @@
+#pragma once
+
+#include <intrin.h>
+
+
+namespace Hedge
+{
+
+// Instruction set extensions available at runtime
+// SIMD code paths are compiled unconditionally and selected with these flags,
+// so the binary still runs on CPUs without AVX
+struct CpuFeatures
+{
+	bool sse41 = false;
+	bool avx = false;
+	bool avx2 = false;
+	bool fma = false;
+};
+
+inline CpuFeatures DetectCpuFeatures()
+{
+	CpuFeatures features;
+
+	int info[4] = {};
+	__cpuid(info, 0);
+	int highestLeaf = info[0];
+
+	if (highestLeaf >= 1)
+	{
+		__cpuid(info, 1);
+		features.sse41 = (info[2] & (1 << 19)) != 0;
+		features.fma = (info[2] & (1 << 12)) != 0;
+
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+
+		// The OS has to save the YMM registers on context switches as well
+		if (osxsave && avx)
+		{
+			unsigned long long xcr0 = _xgetbv(0);
+			features.avx = (xcr0 & 0x6) == 0x6;
+		}
+	}
+
+	if (highestLeaf >= 7
+		&& features.avx)
+	{
+		__cpuidex(info, 7, 0);
+		features.avx2 = (info[1] & (1 << 5)) != 0;
+	}
+
+	features.fma = features.fma && features.avx;
+
+	return features;
+}
+
+inline const CpuFeatures& GetCpuFeatures()
+{
+	static const CpuFeatures features = DetectCpuFeatures();
+	return features;
+}
+
+} // namespace Hedge
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Hedge
+{
+
+// Fixed pool of worker threads for data parallel loops
+// The calling thread works on the loop as well and ParallelFor returns only after every chunk is done,
+// chunks are disjoint index ranges, so as long as iterations don't share data the result is the same as a serial loop
+class JobSystem
+{
+public:
+	// Number of threads includes the calling thread, so 1 runs everything inline
+	JobSystem(unsigned int numberOfThreads = std::thread::hardware_concurrency());
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	unsigned int GetNumberOfThreads() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+	// Calls function(begin, end) for consecutive chunks of [0, count) and waits for all of them
+	// Not reentrant, don't call ParallelFor from within a job
+	void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function);
+
+	static JobSystem& Get();
+
+private:
+	void WorkerLoop();
+	void RunChunks();
+
+
+private:
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::condition_variable done;
+	bool quit = false;
+
+	// Current job, written under the mutex before the workers are woken up
+	bool jobActive = false;
+	unsigned long long jobGeneration = 0;
+	unsigned int activeWorkers = 0;
+	const std::function<void(size_t, size_t)>* job = nullptr;
+	size_t jobCount = 0;
+	size_t jobChunkSize = 0;
+	size_t numberOfChunks = 0;
+	std::atomic<size_t> nextChunk = 0;
+};
+
+} // namespace Hedge
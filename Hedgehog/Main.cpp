@@ -1,4 +1,5 @@
 #include <iostream>
+#include <random>
 
 // TODO: Applications using the Hedgehog engine should just include some Hedgehog.h header
 //       and then create a concrete application class inheriting from the Hedgehog Application class
@@ -16,6 +17,13 @@
 #include <Model/Model.h>
 
 #include <Animation/Animator.h>
+#include <Animation/BakedAnimator.h>
+#include <Animation/CpuSkinner.h>
+#include <Animation/AnimationBenchmark.h>
+#include <Spatial/SpatialBenchmark.h>
+#include <Renderer/OcclusionBenchmark.h>
+#include <Renderer/ShadingBenchmark.h>
+#include <Renderer/ResourceCache.h>
 
 //#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 //#include <spdlog/spdlog.h>
@@ -70,6 +78,7 @@ public:
 			{ "u_projectionView", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Scene },
 			{ "u_transform", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Object },
 			{ "u_segmentTransforms", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Object, 65 },
+			{ "u_cpuSkinned", sizeof(int), Hedge::ConstantBufferUsage::Object },
 		};
 
 		auto frustumPrimitiveTopology = Hedge::PrimitiveTopology::Line;
@@ -390,6 +399,7 @@ public:
 			{ "u_spotLight", sizeof(Hedge::SpotLight), Hedge::ConstantBufferUsage::Light },
 			{ "u_Transform", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Object },
 			{ "u_segmentTransforms", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Object, 65 },
+			{ "u_cpuSkinned", sizeof(int), Hedge::ConstantBufferUsage::Object },
 		};
 
 		float squareVertices[] =
@@ -501,6 +511,10 @@ public:
 		//spoznaMesh.enabled = false;
 		//auto& spozaTransform = spozaTestEntity.Add<Hedge::Transform>();
 		//spozaTransform.SetUniformScale(0.01f);
+		// The walls hide most of the interior, a simplified model makes a cheaper occluder than the full one
+		//spozaTestEntity.Add<Hedge::Occluder>(sponzaModel.GetVertices(), sponzaModel.GetSizeOfVertices(),
+		//									 sponzaModel.GetIndices(), sponzaModel.GetNumberOfIndices(),
+		//									 squareBufferLayout);
 
 		//Hedge::BufferLayout TBNBL =
 		//{
@@ -545,6 +559,7 @@ public:
 		//}
 
 		//vampireModel.LoadDae("..\\..\\vampire\\dancing_vampire.dae");
+		//vampireModel.GetAnimation()->Compress();
 		//vampireEntity = scene.CreateEntity("Vampire");
 		//auto& vampireMesh = vampireEntity.Add<Hedge::Mesh>(vampireModel.GetVertices(), vampireModel.GetSizeOfVertices(),
 		//												   vampireModel.GetIndices(), vampireModel.GetNumberOfIndices(),
@@ -557,6 +572,35 @@ public:
 		//auto& vampireTransform = vampireEntity.Add<Hedge::Transform>();
 		//vampireTransform.SetUniformScale(0.01f);
 		//vampireEntity.Add<Hedge::Animator>(vampireModel.GetAnimation());
+		// Skinning on the CPU, for software rasterizers
+		//vampireEntity.Add<Hedge::CpuSkinner>(vampireModel.GetVertices(), vampireModel.GetSizeOfVertices(), vampireMesh.Get());
+
+		// Crowd of vampires playing the baked dance at different phases, OpenGL only for now
+		//auto vampireCrowdTextureDescriptions = vampireTextureDescriptions;
+		//vampireCrowdTextureDescriptions.push_back({ Hedge::TextureType::Generic });
+		//vampireBakedAnimation = std::make_shared<Hedge::BakedAnimation>(30.0f);
+		//vampireBakedAnimation->AddClip(vampireModel.GetAnimation());
+		//std::vector<Hedge::BakedInstance> vampireInstances;
+		//for (int x = 0; x < 32; x++)
+		//{
+		//	for (int z = 0; z < 32; z++)
+		//	{
+		//		Hedge::BakedInstance instance;
+		//		instance.offset = glm::vec3(x * 150.0f, 0.0f, z * -150.0f);
+		//		instance.time = (x * 32 + z) * 0.37f;
+		//		vampireInstances.push_back(instance);
+		//	}
+		//}
+		//auto vampireCrowdEntity = scene.CreateEntity("Vampire Crowd");
+		//auto& vampireCrowdMesh = vampireCrowdEntity.Add<Hedge::Mesh>(vampireModel.GetVertices(), vampireModel.GetSizeOfVertices(),
+		//															 vampireModel.GetIndices(), vampireModel.GetNumberOfIndices(),
+		//															 Hedge::PrimitiveTopology::Triangle, squareBufferLayout,
+		//															 squareConstBufferDesc,
+		//															 "..\\Hedgehog\\Asset\\Shader\\OpenGLBakedSkinningVertexShader.glsl", fragmentSrcTexture, "",
+		//															 vampireCrowdTextureDescriptions
+		//															 );
+		//vampireCrowdEntity.Add<Hedge::Transform>().SetUniformScale(0.01f);
+		//vampireCrowdEntity.Add<Hedge::BakedAnimator>(vampireBakedAnimation, vampireInstances, vampireCrowdMesh.Get());
 
 
 
@@ -734,6 +778,7 @@ public:
 			{ "u_projectionView", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Scene },
 			{ "u_transform", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Object },
 			{ "u_segmentTransforms", sizeof(glm::mat4), Hedge::ConstantBufferUsage::Object, 65 },
+			{ "u_cpuSkinned", sizeof(int), Hedge::ConstantBufferUsage::Object },
 		};
 
 		axesEntity = scene.CreateEntity("Axes");
@@ -827,6 +872,8 @@ public:
 		yRotation = 0;
 		zRotation = 0;
 
+		shadingBenchmark.OnFrame(scene, duration.count());
+
 		Hedge::Renderer::BeginScene(primaryCamera);
 		{
 			//squareMesh.GetShader()->UploadConstant("u_normalMapping", (int)normalMapping);
@@ -839,8 +886,7 @@ public:
 
 			scene.OnUpdate(duration);
 			
-			// Order matters when we want to blend
-			// TODO there needs to be a way to sort meshes for blending, especially when using the EnTT registry
+			// Draws are sorted by EndScene, translucent groups are blended in any order after everything opaque
 			//Hedge::Renderer::Submit(squareMesh.Get(), squareTransform.Get());
 		}
 		Hedge::Renderer::EndScene();
@@ -949,6 +995,31 @@ public:
 		ImGui::End();
 
 
+		ImGui::Begin("Benchmarks");
+		ImGui::Text("Results are printed to the console");
+		if (ImGui::Button("Animation Update"))
+		{
+			Hedge::RunAnimationBenchmark(&animation);
+		}
+		if (ImGui::Button("Spatial Index"))
+		{
+			Hedge::RunSpatialBenchmark();
+		}
+		if (ImGui::Button("Occlusion Buffer"))
+		{
+			Hedge::RunOcclusionBenchmark();
+		}
+		if (shadingBenchmark.IsRunning())
+		{
+			ImGui::Text("Forward vs Deferred Shading running...");
+		}
+		else if (ImGui::Button("Forward vs Deferred Shading, Depth Pre-Pass"))
+		{
+			shadingBenchmark.Start(scene);
+		}
+		ImGui::End();
+
+
 		ImGui::Begin("Rendering Settings");
 		if (Hedge::Renderer::GetAPI() == Hedge::RendererAPI::API::OpenGL)
 		{
@@ -981,8 +1052,46 @@ public:
 		ImGui::SameLine(); ImGui::Checkbox("Face Culling", &faceCulling);
 		ImGui::SameLine(); ImGui::Checkbox("Blending", &blending);
 
+		bool depthPrePass = Hedge::Renderer::GetDepthPrePass();
+		if (ImGui::Checkbox("Depth Pre-Pass", &depthPrePass))
+		{
+			Hedge::Renderer::SetDepthPrePass(depthPrePass);
+		}
+		ImGui::SameLine(); ImGui::Text("%u depth draws, %.3f ms/frame", Hedge::Renderer::GetRenderQueue().numberOfDepthDraws, 1000.0f / ImGui::GetIO().Framerate);
+
 		ImGui::Checkbox("Use Normal Mapping", &normalMapping);
 
+		bool instancing = Hedge::Renderer::GetInstancing();
+		if (ImGui::Checkbox("Automatic Instancing", &instancing))
+		{
+			Hedge::Renderer::SetInstancing(instancing);
+		}
+		ImGui::SameLine(); ImGui::Text("%u batches, %u instances", Hedge::Renderer::GetRenderQueue().numberOfBatches, Hedge::Renderer::GetRenderQueue().numberOfBatchedInstances);
+
+		bool frustumCulling = Hedge::Renderer::GetFrustumCulling();
+		if (ImGui::Checkbox("Frustum Culling", &frustumCulling))
+		{
+			Hedge::Renderer::SetFrustumCulling(frustumCulling);
+		}
+		const auto& culling = Hedge::Renderer::GetCullingStatistics();
+		ImGui::Text("Meshes: %u visible, %u culled", culling.visibleMeshes, culling.culledMeshes);
+		ImGui::Text("Groups: %u visible, %u culled", culling.visibleGroups, culling.culledGroups);
+		scene.occlusionBuffer.CreateGuiControls();
+		scene.occlusionQueries.CreateGuiControls();
+		ImGui::Text("Occluded: %u meshes, %u groups", culling.occludedMeshes, culling.occludedGroups);
+		ImGui::Text("Spatial index: %d meshes, height %d", scene.spatialIndex.GetNumberOfProxies(), scene.spatialIndex.GetHeight());
+		const auto& renderQueue = Hedge::Renderer::GetRenderQueue();
+		ImGui::Text("Render queue: %u draws, %u binds, sorted in %.3f ms", renderQueue.numberOfPackets, renderQueue.numberOfBinds, renderQueue.sortDuration);
+		if (auto streamBuffer = Hedge::RenderCommand::GetStreamBuffer())
+		{
+			ImGui::Text("Stream buffer: %.1f of %.1f KB, %u allocations, %u didn't fit",
+						streamBuffer->usedBytes / 1024.0f, streamBuffer->GetRegionSize() / 1024.0f,
+						streamBuffer->numberOfAllocations, streamBuffer->failedAllocations);
+		}
+		Hedge::ResourceCache::CreateGuiControls();
+		Hedge::Renderer::GetDeferredShading().CreateGuiControls();
+		Hedge::Renderer::GetTransparency().CreateGuiControls();
+
 		ImGui::End();
 
 
@@ -995,6 +1104,15 @@ public:
 
 		ImGui::Separator();
 
+		if (ImGui::TreeNode("Animation LOD"))
+		{
+			scene.animationLodPolicy.CreateGuiControls();
+			scene.paletteBuffer.CreateGuiControls();
+			ImGui::TreePop();
+		}
+
+		ImGui::Separator();
+
 		ImGui::SetNextItemOpen(true, ImGuiCond_Once);
 		if (ImGui::TreeNode("Meshes"))
 		{
@@ -1024,15 +1142,32 @@ public:
 						scene.registry.get<Hedge::Animator>(entity).CreateGuiControls();
 					}
 
+					if (scene.registry.has<Hedge::CpuSkinner>(entity))
+					{
+						scene.registry.get<Hedge::CpuSkinner>(entity).CreateGuiControls();
+					}
+
+					if (scene.registry.has<Hedge::BakedAnimator>(entity))
+					{
+						ImGui::Separator();
+						ImGui::Text("Baked Animation");
+
+						scene.registry.get<Hedge::BakedAnimator>(entity).CreateGuiControls();
+					}
+
 					auto& groups = mesh.Get()->GetGroups();
 
+					// Of this entity alone, the vertex array is shared with the others of the same model
+					auto& meshGroups = scene.registry.get_or_emplace<Hedge::MeshGroups>(entity);
+					meshGroups.groups.resize(groups.size());
+
 					if (!groups.empty())
 					{
 						if (ImGui::TreeNode("Groups"))
 						{
 							if (ImGui::Button("Enable All"))
 							{
-								for (auto& [group, distance] : groups)
+								for (auto& group : meshGroups.groups)
 								{
 									group.enabled = true;
 								}
@@ -1041,15 +1176,15 @@ public:
 							ImGui::SameLine();
 							if (ImGui::Button("Disable All"))
 							{
-								for (auto& [group, distance] : groups)
+								for (auto& group : meshGroups.groups)
 								{
 									group.enabled = false;
 								}
 							}
 
-							for (auto& [group, distance] : groups)
+							for (size_t index = 0; index < groups.size(); index++)
 							{
-								ImGui::Checkbox(group.name.c_str(), &group.enabled);
+								ImGui::Checkbox(groups[index].first.name.c_str(), &meshGroups.groups[index].enabled);
 							}
 
 							ImGui::TreePop();
@@ -1090,6 +1225,24 @@ public:
 			{
 				ImGui::SliderInt("# of PLights used", &scene.plUsed, 0, 3);
 
+				scene.lightClusters.CreateGuiControls();
+				if (ImGui::Button("Scatter 100 Point Lights"))
+				{
+					// Around the camera, without meshes so they only show in the lighting
+					static std::mt19937 random(42);
+					std::uniform_real_distribution<float> offset(-30.0f, 30.0f);
+					std::uniform_real_distribution<float> hue(0.0f, 1.0f);
+					glm::vec3 center = scene.GetPrimaryCamera().Get<Hedge::Transform>().GetTranslation();
+					for (int i = 0; i < 100; i++)
+					{
+						auto scattered = scene.CreateEntity("Scattered Point Light");
+						auto& light = scattered.Add<Hedge::PointLight>();
+						light.color = glm::vec3(hue(random), hue(random), hue(random));
+						light.attenuation = glm::vec3(1.0f, 0.35f, 0.44f);
+						light.position = center + glm::vec3(offset(random), offset(random) * 0.25f, offset(random));
+					}
+				}
+
 				auto view = scene.registry.view<std::string, Hedge::Mesh, Hedge::Transform, Hedge::PointLight>();
 				for (auto [entity, name, mesh, transform, light] : view.each())
 				{
@@ -1210,6 +1363,7 @@ public:
 
 private:
 	Hedge::Scene scene;
+	Hedge::ShadingBenchmark shadingBenchmark;
 
 	Hedge::Entity axesEntity;
 	Hedge::Entity gridEntity;
@@ -1303,6 +1457,7 @@ private:
 
 	Hedge::Entity vampireEntity;
 	Hedge::Model vampireModel;
+	std::shared_ptr<Hedge::BakedAnimation> vampireBakedAnimation;
 
 	Hedge::Entity bunnyEntity;
 	float magnitude = 0.0f;
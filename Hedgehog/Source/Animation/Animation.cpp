@@ -2,6 +2,8 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+
 
 namespace Hedge
 {
@@ -15,8 +17,6 @@ Animation::Animation()
 	segments.push_back({ Segment("pinky1", 1), 0 } );
 	segments.push_back({ Segment("pinky2", 2), 1 } );
 
-	transforms.resize(segments.size());
-
 	segments[0].first.offset = glm::mat4(1.0f);
 	segments[0].first.keyPositions.push_back({  0.0f, { 0.0f, 1.5f, 0.0f } });
 	segments[0].first.keyPositions.push_back({  5.0f, { 0.0f, 1.5f, 0.0f } });
@@ -49,6 +49,8 @@ Animation::Animation()
 	segments[2].first.keyScales.push_back({  0.0f, { 1.0f, 1.0f, 1.0f } });
 	segments[2].first.keyScales.push_back({  5.0f, { 1.0f, 1.0f, 1.0f } });
 	segments[2].first.keyScales.push_back({ 10.0f, { 1.0f, 1.0f, 1.0f } });
+
+	CreateKeyframes();
 }
 
 Animation::Animation(const std::vector<std::pair<Segment, int>>& segments)
@@ -56,7 +58,6 @@ Animation::Animation(const std::vector<std::pair<Segment, int>>& segments)
 	// TODO ideally segments should be sorted in a breadth first fashion
 	this->segments = segments;
 	duration = segments.back().first.keyPositions.back().timeStamp;
-	transforms.resize(segments.size());
 
 	// Find the root segment
 	// Assume there is exactly one root segment
@@ -69,51 +70,119 @@ Animation::Animation(const std::vector<std::pair<Segment, int>>& segments)
 		}
 	}
 	assert(rootSegmentIndex != -1);
+
+	CreateKeyframes();
+}
+
+void Animation::CreateKeyframes()
+{
+	keyframes = KeyframeTable(segments);
+
+	// Breadth first from the root
+	evaluationOrder.clear();
+	evaluationOrder.push_back(rootSegmentIndex);
+	depths.assign(segments.size(), 0);
+	maxDepth = 0;
+	for (size_t i = 0; i < evaluationOrder.size(); i++)
+	{
+		for (int segment = 0; segment < static_cast<int>(segments.size()); segment++)
+		{
+			if (segments[segment].second == evaluationOrder[i])
+			{
+				evaluationOrder.push_back(segment);
+				depths[segment] = depths[evaluationOrder[i]] + 1;
+				maxDepth = std::max(maxDepth, depths[segment]);
+			}
+		}
+	}
 }
 
-const std::vector<glm::mat4>& Animation::GetTransforms(float timeStamp)
+void Animation::Compress(const CompressionSettings& settings)
 {
-	CalculateTransforms(timeStamp, rootSegmentIndex);
+	if (IsCompressed())
+	{
+		return;
+	}
 
-	return transforms;
+	compressedKeyframes = CompressedClip(segments, settings);
+	ReleaseKeyframes();
 }
 
-void Animation::CalculateTransforms(float timeStamp,
-									int segmentIndex,
-									const Transform& parentTransform)
+void Animation::SetCompressedKeyframes(const CompressedClip& compressedKeyframes)
 {
-	Segment& segment = segments[segmentIndex].first;
+	assert(compressedKeyframes.GetNumberOfSegments() == static_cast<int>(segments.size()));
 
-	Transform finalTransform = parentTransform * segment.GetTransform(timeStamp);
-	transforms[segment.GetID()] = finalTransform.Get() * segment.offset;
+	this->compressedKeyframes = compressedKeyframes;
+	ReleaseKeyframes();
+}
 
-	for (auto segment = segments.begin(); segment != segments.end(); ++segment)
+void Animation::ReleaseKeyframes()
+{
+	keyframes = KeyframeTable();
+
+	for (auto& [segment, parent] : segments)
 	{
-		if (segment->second == segmentIndex)
-		{
-			CalculateTransforms(timeStamp,
-								static_cast<int>(std::distance(segments.begin(), segment)),
-								finalTransform);
-		}
+		segment.keyPositions = std::vector<KeyPosition>();
+		segment.keyRotations = std::vector<KeyRotation>();
+		segment.keyScales = std::vector<KeyScale>();
 	}
 }
 
-void Animation::CalculateTransformMatrices(float timeStamp,
-										   int segmentIndex,
-										   const glm::mat4& parentTransform)
+void Animation::SamplePose(float timeStamp, Pose& pose) const
 {
-	Segment& segment = segments[segmentIndex].first;
+	if (IsCompressed())
+	{
+		compressedKeyframes.Sample(timeStamp, pose);
+	}
+	else
+	{
+		keyframes.Sample(timeStamp, pose);
+	}
+}
 
-	glm::mat4 finalTransform = parentTransform * segment.GetTransformMatrix(timeStamp);
-	transforms[segment.GetID()] = finalTransform * segment.offset;
+void Animation::CalculateTransforms(const Pose& pose, std::vector<glm::mat4>& transforms, int maxDepth) const
+{
+	transforms.resize(segments.size());
 
-	for (auto segment = segments.begin(); segment != segments.end(); ++segment)
+	if (maxDepth < 0)
+	{
+		maxDepth = this->maxDepth;
+	}
+
+	// World transforms first, parents are always done before their children
+	for (int segmentIndex : evaluationOrder)
 	{
-		if (segment->second == segmentIndex)
+		if (depths[segmentIndex] > maxDepth)
+		{
+			// Breadth first, so everything from here on is too deep as well
+			break;
+		}
+
+		const auto& [segment, parent] = segments[segmentIndex];
+
+		if (parent == -1)
+		{
+			transforms[segment.GetID()] = pose.GetMatrix(segmentIndex);
+		}
+		else
+		{
+			transforms[segment.GetID()] = transforms[segments[parent].first.GetID()] * pose.GetMatrix(segmentIndex);
+		}
+	}
+
+	// Same order again, so a segment that isn't evaluated can take its parent's final transform
+	// and its vertices move along with the parent as if they were bound to it
+	for (int segmentIndex : evaluationOrder)
+	{
+		const auto& [segment, parent] = segments[segmentIndex];
+
+		if (depths[segmentIndex] > maxDepth)
+		{
+			transforms[segment.GetID()] = transforms[segments[parent].first.GetID()];
+		}
+		else
 		{
-			CalculateTransformMatrices(timeStamp,
-									   static_cast<int>(std::distance(segments.begin(), segment)),
-									   finalTransform);
+			transforms[segment.GetID()] = transforms[segment.GetID()] * segment.offset;
 		}
 	}
 }
@@ -0,0 +1,89 @@
+#include <Animation/AnimationBenchmark.h>
+
+#include <Animation/Animator.h>
+#include <Utilities/JobSystem.h>
+#include <Utilities/Stopwatch.h>
+
+#include <cstdio>
+
+
+namespace Hedge
+{
+
+std::vector<AnimationBenchmarkResult> RunAnimationBenchmark(const Animation* animation,
+															const std::vector<int>& entityCounts,
+															const std::vector<unsigned int>& threadCounts,
+															int numberOfFrames)
+{
+	const float timeStep = 1000.0f / 60.0f;
+
+	std::vector<AnimationBenchmarkResult> results;
+
+	printf("Animation update benchmark, %d segments, %d frames\n", animation->GetNumberOfSegments(), numberOfFrames);
+	printf("%10s %8s %12s %8s %8s\n", "entities", "threads", "ms/frame", "speedup", "serial");
+
+	for (int numberOfEntities : entityCounts)
+	{
+		// The first thread count is the baseline, both for the speedup and for the results
+		std::vector<Animator> reference;
+		double baselineDuration = 0.0;
+
+		for (unsigned int numberOfThreads : threadCounts)
+		{
+			JobSystem jobSystem(numberOfThreads);
+
+			std::vector<Animator> animators(numberOfEntities, Animator(animation));
+			for (int i = 0; i < numberOfEntities; i++)
+			{
+				// Spread the crowd over the whole clip
+				animators[i].Update(i * 37.0f);
+			}
+
+			Stopwatch stopwatch;
+			stopwatch.Start();
+			for (int frame = 0; frame < numberOfFrames; frame++)
+			{
+				jobSystem.ParallelFor(animators.size(), Animator::UPDATE_CHUNK_SIZE,
+					[&animators, timeStep](size_t begin, size_t end)
+					{
+						for (size_t i = begin; i < end; i++)
+						{
+							animators[i].Update(timeStep);
+						}
+					});
+			}
+			stopwatch.Stop();
+
+			AnimationBenchmarkResult result;
+			result.numberOfEntities = numberOfEntities;
+			result.numberOfThreads = jobSystem.GetNumberOfThreads();
+			result.frameDuration = stopwatch.GetDuration().count() / numberOfFrames;
+
+			if (reference.empty())
+			{
+				reference = animators;
+				baselineDuration = result.frameDuration;
+			}
+			else
+			{
+				for (int i = 0; i < numberOfEntities && result.matchesSerial; i++)
+				{
+					result.matchesSerial = animators[i].GetTransforms() == reference[i].GetTransforms();
+				}
+			}
+
+			printf("%10d %8u %12.3f %7.2fx %8s\n",
+				   result.numberOfEntities,
+				   result.numberOfThreads,
+				   result.frameDuration,
+				   baselineDuration / result.frameDuration,
+				   result.matchesSerial ? "match" : "DIFFER");
+
+			results.push_back(result);
+		}
+	}
+
+	return results;
+}
+
+} // namespace Hedge
@@ -0,0 +1,231 @@
+#include <Animation/AnimationGraph.h>
+
+#include <Animation/PoseKernels.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace Hedge
+{
+
+AnimationGraph::AnimationGraph(const Animation* skeleton)
+	: skeleton(skeleton)
+{
+}
+
+int AnimationGraph::AllocateNode(AnimationNodeType type)
+{
+	int index = -1;
+	for (int i = 0; i < static_cast<int>(nodes.size()); i++)
+	{
+		if (nodes[i].type == AnimationNodeType::Free)
+		{
+			index = i;
+			break;
+		}
+	}
+
+	if (index < 0)
+	{
+		index = static_cast<int>(nodes.size());
+		nodes.emplace_back();
+	}
+
+	// Reusing a slot keeps its pose buffers, they are all the same size anyway
+	AnimationNode& node = nodes[index];
+	node.type = type;
+	node.animation = nullptr;
+	node.time = 0.0f;
+	node.speed = 1.0f;
+	node.loop = true;
+	node.first = -1;
+	node.second = -1;
+	node.weight = 0.0f;
+	if (node.pose.GetNumberOfSegments() != skeleton->GetNumberOfSegments())
+	{
+		node.pose.Resize(skeleton->GetNumberOfSegments());
+	}
+
+	if (root < 0)
+	{
+		root = index;
+	}
+
+	return index;
+}
+
+int AnimationGraph::AddClip(const Animation* animation, float speed, bool loop)
+{
+	assert(animation->GetNumberOfSegments() == skeleton->GetNumberOfSegments());
+
+	int index = AllocateNode(AnimationNodeType::Clip);
+	AnimationNode& node = nodes[index];
+	node.animation = animation;
+	node.speed = speed;
+	node.loop = loop;
+
+	return index;
+}
+
+int AnimationGraph::AddBlend(int first, int second, float weight)
+{
+	assert(first != second);
+
+	int index = AllocateNode(AnimationNodeType::Blend);
+	AnimationNode& node = nodes[index];
+	node.first = first;
+	node.second = second;
+	node.weight = weight;
+
+	return index;
+}
+
+int AnimationGraph::AddAdditive(int base, int additive, float weight)
+{
+	// The reference is the first key of the additive clip
+	assert(nodes[additive].type == AnimationNodeType::Clip);
+
+	int index = AllocateNode(AnimationNodeType::Additive);
+	AnimationNode& node = nodes[index];
+	node.first = base;
+	node.second = additive;
+	node.weight = weight;
+
+	node.reference.Resize(skeleton->GetNumberOfSegments());
+	nodes[additive].animation->SamplePose(0.0f, node.reference);
+
+	return index;
+}
+
+void AnimationGraph::MarkReachable(int node, std::vector<bool>& reachable) const
+{
+	if (node < 0
+		|| reachable[node])
+	{
+		return;
+	}
+
+	reachable[node] = true;
+	MarkReachable(nodes[node].first, reachable);
+	MarkReachable(nodes[node].second, reachable);
+}
+
+void AnimationGraph::Prune()
+{
+	std::vector<bool> reachable(nodes.size(), false);
+	MarkReachable(root, reachable);
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		if (!reachable[i])
+		{
+			nodes[i].type = AnimationNodeType::Free;
+		}
+	}
+}
+
+void AnimationGraph::ResetTime()
+{
+	for (AnimationNode& node : nodes)
+	{
+		node.time = 0.0f;
+	}
+}
+
+void AnimationGraph::Advance(float timeStep)
+{
+	for (AnimationNode& node : nodes)
+	{
+		if (node.type != AnimationNodeType::Clip)
+		{
+			continue;
+		}
+
+		float duration = node.animation->GetDuration();
+		node.time += timeStep / 1000.0f * node.speed;
+		node.time = node.loop ? fmod(node.time, duration) : std::min(node.time, duration);
+	}
+}
+
+const Pose& AnimationGraph::Evaluate()
+{
+	assert(root >= 0);
+
+	return Evaluate(root);
+}
+
+const Pose& AnimationGraph::Evaluate(int index)
+{
+	AnimationNode& node = nodes[index];
+
+	switch (node.type)
+	{
+	case AnimationNodeType::Clip:
+		node.animation->SamplePose(node.time, node.pose);
+		return node.pose;
+
+	case AnimationNodeType::Blend:
+		// Settled blends cost as much as the one input that shows
+		if (node.weight <= 0.0f)
+		{
+			return Evaluate(node.first);
+		}
+		if (node.weight >= 1.0f)
+		{
+			return Evaluate(node.second);
+		}
+		InterpolatePoses(Evaluate(node.first), Evaluate(node.second), node.weight, node.pose);
+		return node.pose;
+
+	case AnimationNodeType::Additive:
+		if (node.weight <= 0.0f)
+		{
+			return Evaluate(node.first);
+		}
+		AddPoses(Evaluate(node.first), Evaluate(node.second), node.reference, node.weight, node.pose);
+		return node.pose;
+
+	default:
+		assert(false);
+		return node.pose;
+	}
+}
+
+bool AnimationGraph::CreateGuiControls()
+{
+	bool changed = false;
+
+	for (int i = 0; i < static_cast<int>(nodes.size()); i++)
+	{
+		AnimationNode& node = nodes[i];
+
+		ImGui::PushID(i);
+		switch (node.type)
+		{
+		case AnimationNodeType::Clip:
+			changed |= ImGui::SliderFloat("Position", &node.time, 0.0f, node.animation->GetDuration());
+			ImGui::SliderFloat("Speed", &node.speed, 0.0f, 10.0f);
+			break;
+
+		case AnimationNodeType::Blend:
+			changed |= ImGui::SliderFloat("Blend", &node.weight, 0.0f, 1.0f);
+			break;
+
+		case AnimationNodeType::Additive:
+			changed |= ImGui::SliderFloat("Additive", &node.weight, 0.0f, 1.0f);
+			break;
+
+		default:
+			break;
+		}
+		ImGui::PopID();
+	}
+
+	return changed;
+}
+
+} // namespace Hedge
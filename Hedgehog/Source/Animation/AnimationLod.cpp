@@ -0,0 +1,82 @@
+#include <Animation/AnimationLod.h>
+
+#include <imgui.h>
+
+#include <cmath>
+
+
+namespace Hedge
+{
+
+AnimationLod AnimationLodPolicy::Select(const glm::vec3& position, const glm::vec3& cameraPosition, const glm::mat4& projectionView) const
+{
+	AnimationLod lod;
+
+	if (!enabled)
+	{
+		return lod;
+	}
+
+	glm::vec4 clip = projectionView * glm::vec4(position, 1.0f);
+	float extent = clip.w * (1.0f + offScreenMargin);
+	lod.offScreen = clip.w <= 0.0f
+		|| std::abs(clip.x) > extent
+		|| std::abs(clip.y) > extent;
+
+	if (lod.offScreen)
+	{
+		lod.level = NUMBER_OF_ANIMATION_LODS - 1;
+	}
+	else
+	{
+		float distance = glm::distance(position, cameraPosition);
+		while (lod.level < NUMBER_OF_ANIMATION_LODS - 1
+			   && distance >= distances[lod.level])
+		{
+			lod.level++;
+		}
+	}
+
+	lod.updateInterval = updateIntervals[lod.level];
+	lod.maxSegmentDepth = maxSegmentDepths[lod.level];
+
+	return lod;
+}
+
+void AnimationLodPolicy::ResetStatistics()
+{
+	for (int level = 0; level < NUMBER_OF_ANIMATION_LODS; level++)
+	{
+		numberOfAnimators[level] = 0;
+		numberOfEvaluations[level] = 0;
+	}
+	numberOfOffScreen = 0;
+}
+
+void AnimationLodPolicy::Count(const AnimationLod& lod, bool evaluated)
+{
+	numberOfAnimators[lod.level]++;
+	numberOfEvaluations[lod.level] += evaluated ? 1 : 0;
+	numberOfOffScreen += lod.offScreen ? 1 : 0;
+}
+
+void AnimationLodPolicy::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	ImGui::Checkbox("Animation LOD", &enabled);
+	ImGui::SliderFloat3("LOD Distances", distances, 0.0f, 100.0f);
+	ImGui::SliderInt4("Update Intervals", updateIntervals, 1, 16);
+	ImGui::SliderInt4("Max Segment Depths", maxSegmentDepths, -1, 16);
+	ImGui::SliderFloat("Off Screen Margin", &offScreenMargin, 0.0f, 1.0f);
+
+	for (int level = 0; level < NUMBER_OF_ANIMATION_LODS; level++)
+	{
+		ImGui::Text("LOD %d: %d animators, %d evaluated", level, numberOfAnimators[level], numberOfEvaluations[level]);
+	}
+	ImGui::Text("Off screen: %d", numberOfOffScreen);
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
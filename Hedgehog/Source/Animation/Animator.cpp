@@ -1,27 +1,146 @@
 #include <Animation/Animator.h>
 
+#include <Animation/PoseKernels.h>
+
 #include <imgui.h>
 
-#include <cmath>
+#include <algorithm>
 
 
 namespace Hedge
 {
 
+Animator::Animator(const Animation* animation)
+	: skeleton(animation)
+	, graph(animation)
+	, transforms(animation->GetNumberOfSegments(), glm::mat4(1.0f))
+	, pose(animation->GetNumberOfSegments())
+{
+	graph.AddClip(animation);
+}
+
+int Animator::CrossFade(const Animation* animation, float duration, float speed, bool loop)
+{
+	int target = graph.AddClip(animation, speed, loop);
+
+	if (duration <= 0.0f)
+	{
+		graph.SetRoot(target);
+		graph.Prune();
+		crossFade = CrossFadeState();
+	}
+	else
+	{
+		// Fading in the middle of a fade blends from the current blend, nothing pops
+		crossFade.node = graph.AddBlend(graph.GetRoot(), target, 0.0f);
+		crossFade.target = target;
+		crossFade.duration = duration;
+		crossFade.elapsed = 0.0f;
+		graph.SetRoot(crossFade.node);
+	}
+
+	resetRender = true;
+
+	return target;
+}
+
+void Animator::UpdateCrossFade(float timeStep)
+{
+	if (crossFade.node < 0)
+	{
+		return;
+	}
+
+	crossFade.elapsed += timeStep;
+	float weight = std::min(crossFade.elapsed / crossFade.duration, 1.0f);
+	graph.SetWeight(crossFade.node, weight);
+
+	if (weight >= 1.0f)
+	{
+		// Drop the faded out subtree so it stops costing anything
+		graph.SetRoot(crossFade.target);
+		graph.Prune();
+		crossFade = CrossFadeState();
+	}
+}
+
+const Pose& Animator::AdvanceAndEvaluate(float timeStep)
+{
+	graph.Advance(timeStep);
+	UpdateCrossFade(timeStep);
+	evaluatedGraph = true;
+
+	return graph.Evaluate();
+}
+
 void Animator::Update(float timeStep)
 {
-	if (running)
+	evaluatedGraph = false;
+
+	if (!running
+		&& !resetRender)
 	{
-		animationTime += timeStep / 1000.0f * animationSpeed;
-		animationTime = fmod(animationTime, animation->GetDuration());
+		return;
 	}
 
-	if (running
+	samplingDuration.Start();
+
+	if (!running
 		|| resetRender)
 	{
-		transforms = animation->GetTransforms(animationTime);
-		resetRender = false;
+		// Whatever was sampled ahead is stale now
+		interpolating = false;
+		evaluatedGraph = true;
+		skeleton->CalculateTransforms(running ? AdvanceAndEvaluate(timeStep * animationSpeed) : graph.Evaluate(),
+									  transforms, lod.maxSegmentDepth);
+	}
+	else
+	{
+		timeStep *= animationSpeed;
+
+		// A started interval is always finished, so the graph clocks never jump back or ahead
+		if (interpolating
+			&& intervalFrame == interval)
+		{
+			if (lod.updateInterval > 1)
+			{
+				std::swap(previousPose, nextPose);
+				interval = lod.updateInterval;
+				nextPose = AdvanceAndEvaluate(timeStep * interval);
+				intervalFrame = 0;
+			}
+			else
+			{
+				interpolating = false;
+			}
+		}
+		else if (!interpolating
+				 && lod.updateInterval > 1)
+		{
+			// Where the graph is now is where the first interval starts,
+			// its length is staggered so animators don't all sample on the same frame
+			previousPose = graph.Evaluate();
+			interval = 1 + lodPhase % lod.updateInterval;
+			nextPose = AdvanceAndEvaluate(timeStep * interval);
+			intervalFrame = 0;
+			interpolating = true;
+		}
+
+		if (interpolating)
+		{
+			intervalFrame++;
+			InterpolatePoses(previousPose, nextPose, (float)intervalFrame / interval, pose);
+			skeleton->CalculateTransforms(pose, transforms, lod.maxSegmentDepth);
+		}
+		else
+		{
+			skeleton->CalculateTransforms(AdvanceAndEvaluate(timeStep), transforms, lod.maxSegmentDepth);
+		}
 	}
+
+	samplingDuration.Stop();
+	resetRender = false;
+	transformsVersion++;
 }
 
 void Animator::CreateGuiControls()
@@ -45,11 +164,13 @@ void Animator::CreateGuiControls()
 
 	ImGui::SliderFloat("Speed", &animationSpeed, 0.1f, 10.0f);
 
-	if (ImGui::SliderFloat("Position", &animationTime, 0.0f, animation->GetDuration()))
+	if (graph.CreateGuiControls())
 	{
 		resetRender = true;
 	}
 
+	ImGui::Text("Pose sampling: %.2f us", samplingDuration.GetDuration().count() * 1000.0);
+
 	ImGui::PopID();
 }
 
@@ -0,0 +1,112 @@
+#include <Animation/BakedAnimation.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace Hedge
+{
+
+BakedAnimation::BakedAnimation(float frameRate)
+	: frameRate(frameRate)
+{
+}
+
+int BakedAnimation::AddClip(const Animation* animation)
+{
+	if (clips.empty())
+	{
+		numberOfSegments = animation->GetNumberOfSegments();
+	}
+	assert(animation->GetNumberOfSegments() == numberOfSegments);
+
+	Clip clip;
+	clip.firstFrame = numberOfFrames;
+	clip.duration = animation->GetDuration();
+	// One extra frame at the very end so there is always a next row to blend to
+	clip.numberOfFrames = (int)std::ceil(clip.duration * frameRate) + 1;
+
+	table.resize(table.size() + (size_t)clip.numberOfFrames * numberOfSegments * ROWS_PER_SEGMENT);
+
+	Pose pose(numberOfSegments);
+	std::vector<glm::mat4> transforms;
+
+	for (int frame = 0; frame < clip.numberOfFrames; frame++)
+	{
+		animation->SamplePose(std::min(frame / frameRate, clip.duration), pose);
+		animation->CalculateTransforms(pose, transforms);
+
+		glm::vec4* rows = &table[(size_t)(clip.firstFrame + frame) * numberOfSegments * ROWS_PER_SEGMENT];
+		for (int segment = 0; segment < numberOfSegments; segment++)
+		{
+			// glm is column major, store rows so the shader can rebuild the matrix with a transpose
+			glm::mat4 transposed = glm::transpose(transforms[segment]);
+			for (int row = 0; row < ROWS_PER_SEGMENT; row++)
+			{
+				*rows++ = transposed[row];
+			}
+		}
+	}
+
+	numberOfFrames += clip.numberOfFrames;
+	clips.push_back(clip);
+
+	texture.reset();
+
+	return static_cast<int>(clips.size()) - 1;
+}
+
+float BakedAnimation::GetFrame(int clip, float time) const
+{
+	const Clip& baked = clips[clip];
+
+	time = std::clamp(time, 0.0f, baked.duration);
+	float frame = time * frameRate;
+
+	// The last row is sampled at the end of the clip, which is usually closer to the row before it than a whole frame
+	int last = baked.numberOfFrames - 1;
+	float lastIntervalStart = (last - 1) / frameRate;
+	if (last > 0
+		&& time > lastIntervalStart)
+	{
+		frame = (last - 1) + (time - lastIntervalStart) / (baked.duration - lastIntervalStart);
+	}
+
+	return baked.firstFrame + std::min(frame, (float)last);
+}
+
+void BakedAnimation::GetTransforms(float frame, std::vector<glm::mat4>& transforms) const
+{
+	int first = (int)frame;
+	int second = std::min(first + 1, numberOfFrames - 1);
+	float interpolant = frame - first;
+
+	const glm::vec4* firstRows = GetFrameData(first);
+	const glm::vec4* secondRows = GetFrameData(second);
+
+	transforms.resize(numberOfSegments);
+	for (int segment = 0; segment < numberOfSegments; segment++)
+	{
+		glm::mat4 transposed(1.0f);
+		for (int row = 0; row < ROWS_PER_SEGMENT; row++)
+		{
+			int index = segment * ROWS_PER_SEGMENT + row;
+			transposed[row] = glm::mix(firstRows[index], secondRows[index], interpolant);
+		}
+		transforms[segment] = glm::transpose(transposed);
+	}
+}
+
+const std::shared_ptr<Texture>& BakedAnimation::GetTexture()
+{
+	if (!texture
+		&& !table.empty())
+	{
+		texture.reset(Texture2D::Create(numberOfSegments * ROWS_PER_SEGMENT, numberOfFrames, &table[0].x));
+	}
+
+	return texture;
+}
+
+} // namespace Hedge
@@ -0,0 +1,98 @@
+#include <Animation/BakedAnimator.h>
+
+#include <imgui.h>
+
+#include <cmath>
+
+
+namespace Hedge
+{
+
+static constexpr int INSTANCE_DATA_SIZE = 4;
+
+BakedAnimator::BakedAnimator(const std::shared_ptr<BakedAnimation>& bakedAnimation,
+							 const std::vector<BakedInstance>& instances,
+							 const std::shared_ptr<VertexArray>& vertexArray)
+	: bakedAnimation(bakedAnimation)
+	, instances(instances)
+	, instanceData(instances.size() * INSTANCE_DATA_SIZE, 0.0f)
+{
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		instanceData[i * INSTANCE_DATA_SIZE + 0] = instances[i].offset.x;
+		instanceData[i * INSTANCE_DATA_SIZE + 1] = instances[i].offset.y;
+		instanceData[i * INSTANCE_DATA_SIZE + 2] = instances[i].offset.z;
+		instanceData[i * INSTANCE_DATA_SIZE + 3] = bakedAnimation->GetFrame(instances[i].clip, instances[i].time);
+	}
+
+	instanceBuffer.reset(VertexBuffer::Create(GetInstanceLayout(),
+											  instanceData.data(),
+											  (unsigned int)(instanceData.size() * sizeof(float))));
+	vertexArray->AddVertexBuffer(instanceBuffer);
+	vertexArray->SetInstanceCount((unsigned int)instances.size());
+
+	auto& texture = this->bakedAnimation->GetTexture();
+	if (texture)
+	{
+		vertexArray->AddTexture(TextureType::Generic, texture);
+	}
+}
+
+const BufferLayout& BakedAnimator::GetInstanceLayout()
+{
+	static const BufferLayout instanceLayout =
+	{
+		{ ShaderDataType::Float3, "a_offset", 1 },
+		{ ShaderDataType::Float, "a_bakedFrame", 1 },
+	};
+
+	return instanceLayout;
+}
+
+void BakedAnimator::Update(float timeStep)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	float step = timeStep / 1000.0f * animationSpeed;
+
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		BakedInstance& instance = instances[i];
+
+		instance.time = fmod(instance.time + step * instance.speed, bakedAnimation->GetDuration(instance.clip));
+		instanceData[i * INSTANCE_DATA_SIZE + 3] = bakedAnimation->GetFrame(instance.clip, instance.time);
+	}
+
+	instanceBuffer->SetData(instanceData.data(), (unsigned int)(instanceData.size() * sizeof(float)));
+}
+
+void BakedAnimator::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	if (ImGui::Button("Pause"))
+	{
+		Pause();
+	}
+
+	ImGui::SameLine(); if (ImGui::Button("Resume"))
+	{
+		Resume();
+	}
+
+	ImGui::SliderFloat("Speed", &animationSpeed, 0.1f, 10.0f);
+
+	ImGui::Text("Instances: %zu", instances.size());
+	ImGui::Text("Baked: %d clips, %d frames at %.0f fps, %.1f KB",
+				bakedAnimation->GetNumberOfClips(),
+				bakedAnimation->GetNumberOfFrames(),
+				bakedAnimation->GetFrameRate(),
+				bakedAnimation->GetSizeInBytes() / 1024.0f);
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
@@ -0,0 +1,516 @@
+#include <Animation/CompressedClip.h>
+
+#include <Animation/PoseKernels.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+
+namespace Hedge
+{
+
+namespace
+{
+
+const char FILE_MAGIC[4] = { 'H', 'C', 'L', 'P' };
+const uint32_t FILE_VERSION = 1;
+
+const float SQRT2 = 1.41421356f;
+const float SMALLEST_THREE_RANGE = 32767.0f; // 15 bits per component
+
+// Indices of the keys that have to be kept,
+// exceedsTolerance(first, second, key) tells whether key can't be reconstructed from first and second
+template <typename Key, typename ExceedsTolerance>
+std::vector<size_t> ReduceKeys(const std::vector<Key>& keys, ExceedsTolerance exceedsTolerance)
+{
+	std::vector<size_t> kept;
+	if (keys.empty())
+	{
+		return kept;
+	}
+
+	kept.push_back(0);
+	size_t anchor = 0;
+
+	for (size_t i = 1; i + 1 < keys.size(); i++)
+	{
+		// Try to extend the span from the anchor over the next key
+		for (size_t j = anchor + 1; j <= i; j++)
+		{
+			if (exceedsTolerance(keys[anchor], keys[i + 1], keys[j]))
+			{
+				kept.push_back(i);
+				anchor = i;
+				break;
+			}
+		}
+	}
+
+	if (keys.size() > 1)
+	{
+		kept.push_back(keys.size() - 1);
+	}
+
+	// Constant channel
+	if (kept.size() == 2
+		&& !exceedsTolerance(keys.front(), keys.front(), keys.back()))
+	{
+		kept.pop_back();
+	}
+
+	return kept;
+}
+
+float GetInterpolant(float start, float end, float now)
+{
+	return end > start ? (now - start) / (end - start) : 0.0f;
+}
+
+uint16_t Quantize(float value, float minimum, float extent)
+{
+	if (extent <= 0.0f)
+	{
+		return 0;
+	}
+
+	float normalized = std::clamp((value - minimum) / extent, 0.0f, 1.0f);
+	return static_cast<uint16_t>(normalized * 65535.0f + 0.5f);
+}
+
+float Dequantize(uint16_t value, float minimum, float extent)
+{
+	return minimum + extent * (value / 65535.0f);
+}
+
+// 2 bits for the index of the dropped largest component, 15 bits for each of the remaining three
+void EncodeSmallestThree(const glm::quat& rotation, uint16_t* encoded)
+{
+	float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+	int largest = 0;
+	for (int i = 1; i < 4; i++)
+	{
+		if (std::fabs(components[i]) > std::fabs(components[largest]))
+		{
+			largest = i;
+		}
+	}
+
+	// q and -q are the same rotation, make the dropped component positive
+	float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+	uint64_t packed = static_cast<uint64_t>(largest) << 45;
+	int shift = 30;
+	for (int i = 0; i < 4; i++)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+
+		// The remaining components are within [-1/sqrt(2), 1/sqrt(2)]
+		float normalized = std::clamp((components[i] * sign * SQRT2 + 1.0f) * 0.5f, 0.0f, 1.0f);
+		packed |= static_cast<uint64_t>(normalized * SMALLEST_THREE_RANGE + 0.5f) << shift;
+		shift -= 15;
+	}
+
+	encoded[0] = static_cast<uint16_t>(packed >> 32);
+	encoded[1] = static_cast<uint16_t>(packed >> 16);
+	encoded[2] = static_cast<uint16_t>(packed);
+}
+
+glm::quat DecodeSmallestThree(const uint16_t* encoded)
+{
+	uint64_t packed = (static_cast<uint64_t>(encoded[0]) << 32)
+					| (static_cast<uint64_t>(encoded[1]) << 16)
+					| static_cast<uint64_t>(encoded[2]);
+
+	int largest = static_cast<int>(packed >> 45) & 0x3;
+
+	float components[4];
+	float sumOfSquares = 0.0f;
+	int shift = 30;
+	for (int i = 0; i < 4; i++)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+
+		float normalized = static_cast<float>((packed >> shift) & 0x7FFF) / SMALLEST_THREE_RANGE;
+		components[i] = (normalized * 2.0f - 1.0f) / SQRT2;
+		sumOfSquares += components[i] * components[i];
+		shift -= 15;
+	}
+	components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+
+	return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+glm::quat Interpolate(const glm::quat& first, glm::quat second, float interpolant)
+{
+	float dot = glm::dot(first, second);
+	if (dot < 0.0f)
+	{
+		second = -second;
+		dot = -dot;
+	}
+
+	if (dot < NLERP_MIN_DOT)
+	{
+		return glm::normalize(glm::slerp(first, second, interpolant));
+	}
+
+	return glm::normalize(first + (second - first) * interpolant);
+}
+
+template <typename T>
+void WriteValue(std::ofstream& file, const T& value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void WriteVector(std::ofstream& file, const std::vector<T>& values)
+{
+	uint64_t size = values.size();
+	WriteValue(file, size);
+	file.write(reinterpret_cast<const char*>(values.data()), size * sizeof(T));
+}
+
+template <typename T>
+void ReadValue(std::ifstream& file, T& value)
+{
+	file.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void ReadVector(std::ifstream& file, std::vector<T>& values)
+{
+	uint64_t size = 0;
+	ReadValue(file, size);
+	if (!file || size > (1ull << 32))
+	{
+		file.setstate(std::ios::failbit);
+		return;
+	}
+
+	values.resize(size);
+	file.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+}
+
+} // namespace
+
+CompressedClip::CompressedClip(const std::vector<std::pair<Segment, int>>& segments, const CompressionSettings& settings)
+{
+	// Clip time range and bounds
+	startTime = std::numeric_limits<float>::max();
+	endTime = std::numeric_limits<float>::lowest();
+	glm::vec3 translationMaximum(std::numeric_limits<float>::lowest());
+	glm::vec3 scaleMaximum(std::numeric_limits<float>::lowest());
+	translationMinimum = glm::vec3(std::numeric_limits<float>::max());
+	scaleMinimum = glm::vec3(std::numeric_limits<float>::max());
+
+	for (const auto& [segment, parent] : segments)
+	{
+		for (const auto& key : segment.keyPositions)
+		{
+			startTime = std::min(startTime, key.timeStamp);
+			endTime = std::max(endTime, key.timeStamp);
+			translationMinimum = glm::min(translationMinimum, key.position);
+			translationMaximum = glm::max(translationMaximum, key.position);
+		}
+		for (const auto& key : segment.keyRotations)
+		{
+			startTime = std::min(startTime, key.timeStamp);
+			endTime = std::max(endTime, key.timeStamp);
+		}
+		for (const auto& key : segment.keyScales)
+		{
+			startTime = std::min(startTime, key.timeStamp);
+			endTime = std::max(endTime, key.timeStamp);
+			scaleMinimum = glm::min(scaleMinimum, key.scale);
+			scaleMaximum = glm::max(scaleMaximum, key.scale);
+		}
+	}
+
+	if (startTime > endTime)
+	{
+		startTime = endTime = 0.0f;
+	}
+	if (translationMinimum.x > translationMaximum.x)
+	{
+		translationMinimum = translationMaximum = glm::vec3(0.0f);
+	}
+	if (scaleMinimum.x > scaleMaximum.x)
+	{
+		scaleMinimum = scaleMaximum = glm::vec3(1.0f);
+	}
+	translationExtent = translationMaximum - translationMinimum;
+	scaleExtent = scaleMaximum - scaleMinimum;
+
+	float cosHalfRotationTolerance = std::cos(glm::radians(settings.rotationTolerance) * 0.5f);
+
+	for (const auto& [segment, parent] : segments)
+	{
+		SegmentTracks segmentTracks;
+
+		auto translationKeys = ReduceKeys(segment.keyPositions,
+			[&settings](const KeyPosition& first, const KeyPosition& second, const KeyPosition& key)
+			{
+				float interpolant = GetInterpolant(first.timeStamp, second.timeStamp, key.timeStamp);
+				glm::vec3 reconstructed = glm::mix(first.position, second.position, interpolant);
+				return glm::distance(reconstructed, key.position) > settings.translationTolerance;
+			});
+
+		segmentTracks.translation = { static_cast<uint32_t>(translationTimes.size()), static_cast<uint32_t>(translationKeys.size()) };
+		for (size_t key : translationKeys)
+		{
+			const KeyPosition& keyPosition = segment.keyPositions[key];
+			translationTimes.push_back(QuantizeTime(keyPosition.timeStamp));
+			for (int i = 0; i < 3; i++)
+			{
+				translations.push_back(Quantize(keyPosition.position[i], translationMinimum[i], translationExtent[i]));
+			}
+		}
+
+		auto rotationKeys = ReduceKeys(segment.keyRotations,
+			[cosHalfRotationTolerance](const KeyRotation& first, const KeyRotation& second, const KeyRotation& key)
+			{
+				float interpolant = GetInterpolant(first.timeStamp, second.timeStamp, key.timeStamp);
+				glm::quat reconstructed = Interpolate(first.rotation, second.rotation, interpolant);
+				return std::fabs(glm::dot(reconstructed, glm::normalize(key.rotation))) < cosHalfRotationTolerance;
+			});
+
+		segmentTracks.rotation = { static_cast<uint32_t>(rotationTimes.size()), static_cast<uint32_t>(rotationKeys.size()) };
+		for (size_t key : rotationKeys)
+		{
+			const KeyRotation& keyRotation = segment.keyRotations[key];
+			rotationTimes.push_back(QuantizeTime(keyRotation.timeStamp));
+
+			uint16_t encoded[3];
+			EncodeSmallestThree(glm::normalize(keyRotation.rotation), encoded);
+			rotations.insert(rotations.end(), encoded, encoded + 3);
+		}
+
+		auto scaleKeys = ReduceKeys(segment.keyScales,
+			[&settings](const KeyScale& first, const KeyScale& second, const KeyScale& key)
+			{
+				float interpolant = GetInterpolant(first.timeStamp, second.timeStamp, key.timeStamp);
+				glm::vec3 reconstructed = glm::mix(first.scale, second.scale, interpolant);
+				return glm::distance(reconstructed, key.scale) > settings.scaleTolerance;
+			});
+
+		segmentTracks.scale = { static_cast<uint32_t>(scaleTimes.size()), static_cast<uint32_t>(scaleKeys.size()) };
+		for (size_t key : scaleKeys)
+		{
+			const KeyScale& keyScale = segment.keyScales[key];
+			scaleTimes.push_back(QuantizeTime(keyScale.timeStamp));
+			for (int i = 0; i < 3; i++)
+			{
+				scales.push_back(Quantize(keyScale.scale[i], scaleMinimum[i], scaleExtent[i]));
+			}
+		}
+
+		tracks.push_back(segmentTracks);
+	}
+}
+
+void CompressedClip::Sample(float timeStamp, Pose& pose) const
+{
+	assert(pose.GetNumberOfSegments() == GetNumberOfSegments());
+
+	for (int segment = 0; segment < GetNumberOfSegments(); segment++)
+	{
+		const SegmentTracks& segmentTracks = tracks[segment];
+
+		glm::vec3 translation(0.0f);
+		glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 scale(1.0f);
+		float interpolant;
+
+		if (segmentTracks.translation.numberOfKeys > 0)
+		{
+			int key = FindKey(translationTimes, segmentTracks.translation, timeStamp, interpolant);
+			translation = DecodeVector(translations, key, translationMinimum, translationExtent);
+			if (interpolant > 0.0f)
+			{
+				translation = glm::mix(translation, DecodeVector(translations, key + 1, translationMinimum, translationExtent), interpolant);
+			}
+		}
+
+		if (segmentTracks.rotation.numberOfKeys > 0)
+		{
+			int key = FindKey(rotationTimes, segmentTracks.rotation, timeStamp, interpolant);
+			rotation = DecodeRotation(key);
+			if (interpolant > 0.0f)
+			{
+				rotation = Interpolate(rotation, DecodeRotation(key + 1), interpolant);
+			}
+		}
+
+		if (segmentTracks.scale.numberOfKeys > 0)
+		{
+			int key = FindKey(scaleTimes, segmentTracks.scale, timeStamp, interpolant);
+			scale = DecodeVector(scales, key, scaleMinimum, scaleExtent);
+			if (interpolant > 0.0f)
+			{
+				scale = glm::mix(scale, DecodeVector(scales, key + 1, scaleMinimum, scaleExtent), interpolant);
+			}
+		}
+
+		pose.Set(segment, translation, rotation, scale);
+	}
+}
+
+bool CompressedClip::Save(const std::string& filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+	WriteValue(file, FILE_VERSION);
+	WriteValue(file, startTime);
+	WriteValue(file, endTime);
+	WriteValue(file, translationMinimum);
+	WriteValue(file, translationExtent);
+	WriteValue(file, scaleMinimum);
+	WriteValue(file, scaleExtent);
+	WriteVector(file, tracks);
+	WriteVector(file, translationTimes);
+	WriteVector(file, rotationTimes);
+	WriteVector(file, scaleTimes);
+	WriteVector(file, translations);
+	WriteVector(file, rotations);
+	WriteVector(file, scales);
+
+	return file.good();
+}
+
+bool CompressedClip::Load(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	char magic[4] = {};
+	uint32_t version = 0;
+	file.read(magic, sizeof(magic));
+	ReadValue(file, version);
+	if (!file
+		|| !std::equal(magic, magic + 4, FILE_MAGIC)
+		|| version != FILE_VERSION)
+	{
+		return false;
+	}
+
+	CompressedClip clip;
+	ReadValue(file, clip.startTime);
+	ReadValue(file, clip.endTime);
+	ReadValue(file, clip.translationMinimum);
+	ReadValue(file, clip.translationExtent);
+	ReadValue(file, clip.scaleMinimum);
+	ReadValue(file, clip.scaleExtent);
+	ReadVector(file, clip.tracks);
+	ReadVector(file, clip.translationTimes);
+	ReadVector(file, clip.rotationTimes);
+	ReadVector(file, clip.scaleTimes);
+	ReadVector(file, clip.translations);
+	ReadVector(file, clip.rotations);
+	ReadVector(file, clip.scales);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	// Every key has a time and three values, the keys of a track have to be among them or sampling reads past the end
+	if (clip.translations.size() != clip.translationTimes.size() * 3
+		|| clip.rotations.size() != clip.rotationTimes.size() * 3
+		|| clip.scales.size() != clip.scaleTimes.size() * 3)
+	{
+		return false;
+	}
+
+	auto fits = [](const Track& track, size_t numberOfTimes)
+	{
+		return (uint64_t)track.firstKey + track.numberOfKeys <= numberOfTimes;
+	};
+	for (const auto& segmentTracks : clip.tracks)
+	{
+		if (!fits(segmentTracks.translation, clip.translationTimes.size())
+			|| !fits(segmentTracks.rotation, clip.rotationTimes.size())
+			|| !fits(segmentTracks.scale, clip.scaleTimes.size()))
+		{
+			return false;
+		}
+	}
+
+	*this = std::move(clip);
+	return true;
+}
+
+size_t CompressedClip::GetSizeInBytes() const
+{
+	return tracks.size() * sizeof(SegmentTracks)
+		   + (translationTimes.size() + rotationTimes.size() + scaleTimes.size()) * sizeof(uint16_t)
+		   + (translations.size() + rotations.size() + scales.size()) * sizeof(uint16_t);
+}
+
+uint16_t CompressedClip::QuantizeTime(float timeStamp) const
+{
+	return Quantize(timeStamp, startTime, endTime - startTime);
+}
+
+float CompressedClip::DequantizeTime(uint16_t time) const
+{
+	return Dequantize(time, startTime, endTime - startTime);
+}
+
+int CompressedClip::FindKey(const std::vector<uint16_t>& times, const Track& track, float timeStamp, float& interpolant) const
+{
+	interpolant = 0.0f;
+
+	int firstKey = static_cast<int>(track.firstKey);
+	int lastKey = firstKey + static_cast<int>(track.numberOfKeys) - 1;
+	uint16_t time = QuantizeTime(timeStamp);
+
+	if (time <= times[firstKey])
+	{
+		return firstKey;
+	}
+
+	if (time >= times[lastKey])
+	{
+		return lastKey;
+	}
+
+	auto second = std::upper_bound(times.begin() + firstKey, times.begin() + lastKey + 1, time);
+	int key = static_cast<int>(std::distance(times.begin(), second)) - 1;
+
+	interpolant = std::clamp(GetInterpolant(DequantizeTime(times[key]), DequantizeTime(times[key + 1]), timeStamp), 0.0f, 1.0f);
+
+	return key;
+}
+
+glm::vec3 CompressedClip::DecodeVector(const std::vector<uint16_t>& values, uint32_t key, const glm::vec3& minimum, const glm::vec3& extent) const
+{
+	return glm::vec3(Dequantize(values[key * 3 + 0], minimum.x, extent.x),
+					 Dequantize(values[key * 3 + 1], minimum.y, extent.y),
+					 Dequantize(values[key * 3 + 2], minimum.z, extent.z));
+}
+
+glm::quat CompressedClip::DecodeRotation(uint32_t key) const
+{
+	return DecodeSmallestThree(&rotations[key * 3]);
+}
+
+} // namespace Hedge
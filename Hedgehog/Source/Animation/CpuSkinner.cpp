@@ -0,0 +1,68 @@
+#include <Animation/CpuSkinner.h>
+
+#include <Utilities/JobSystem.h>
+
+#include <imgui.h>
+
+#include <cassert>
+
+
+namespace Hedge
+{
+
+CpuSkinner::CpuSkinner(const float* vertices, unsigned int sizeOfVertices, const std::shared_ptr<VertexArray>& vertexArray)
+	: vertexBuffer(vertexArray->GetVertexBuffers().front())
+	, layout(SkinningLayout::Create(vertexBuffer->GetLayout()))
+	, bindPose(vertices, vertices + sizeOfVertices / sizeof(float))
+	, skinned(bindPose)
+{
+	assert(layout.IsSkinned());
+
+	numberOfVertices = bindPose.size() / layout.stride;
+}
+
+void CpuSkinner::Update(const Animator& animator)
+{
+	if (!enabled)
+	{
+		if (skinnedVersion != 0)
+		{
+			vertexBuffer->SetData(bindPose.data(), (unsigned int)(bindPose.size() * sizeof(float)));
+			skinnedVersion = 0;
+		}
+		return;
+	}
+
+	if (skinnedVersion == animator.GetTransformsVersion())
+	{
+		return;
+	}
+
+	skinningDuration.Start();
+
+	const glm::mat4* palette = animator.GetTransforms().data();
+	JobSystem::Get().ParallelFor(numberOfVertices, SKINNING_CHUNK_SIZE,
+		[this, palette](size_t begin, size_t end)
+		{
+			SkinVertices(bindPose.data(), skinned.data(), begin, end - begin, layout, palette, reference);
+		});
+
+	skinningDuration.Stop();
+
+	vertexBuffer->SetData(skinned.data(), (unsigned int)(skinned.size() * sizeof(float)));
+	skinnedVersion = animator.GetTransformsVersion();
+}
+
+void CpuSkinner::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	ImGui::Checkbox("CPU Skinning", &enabled);
+	ImGui::SameLine(); ImGui::Checkbox("Reference", &reference);
+
+	ImGui::Text("%zu vertices skinned in %.3f ms", numberOfVertices, skinningDuration.GetDuration().count());
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
@@ -0,0 +1,145 @@
+#include <Animation/KeyframeTable.h>
+
+#include <Animation/PoseKernels.h>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace Hedge
+{
+
+namespace
+{
+
+template <typename Key, typename Value, typename Interpolate>
+Value SampleKeys(const std::vector<Key>& keys, Value Key::* value, float timeStamp, const Value& defaultValue, Interpolate interpolate)
+{
+	if (keys.empty())
+	{
+		return defaultValue;
+	}
+
+	if (timeStamp <= keys.front().timeStamp)
+	{
+		return keys.front().*value;
+	}
+
+	if (timeStamp >= keys.back().timeStamp)
+	{
+		return keys.back().*value;
+	}
+
+	auto second = std::upper_bound(keys.begin(), keys.end(), timeStamp,
+								   [](float timeStamp, const Key& key) { return timeStamp < key.timeStamp; });
+	auto first = second - 1;
+	float interpolant = (timeStamp - first->timeStamp) / (second->timeStamp - first->timeStamp);
+
+	return interpolate((*first).*value, (*second).*value, interpolant);
+}
+
+glm::vec3 Mix(const glm::vec3& first, const glm::vec3& second, float interpolant)
+{
+	return glm::mix(first, second, interpolant);
+}
+
+glm::quat Slerp(const glm::quat& first, const glm::quat& second, float interpolant)
+{
+	return glm::normalize(glm::slerp(first, second, interpolant));
+}
+
+} // namespace
+
+KeyframeTable::KeyframeTable(const std::vector<std::pair<Segment, int>>& segments)
+{
+	numberOfSegments = static_cast<int>(segments.size());
+	stride = Pose::GetStride(numberOfSegments);
+	blockSize = Pose::GetBlockSize(numberOfSegments);
+
+	// Shared timeline, union of the key times of all segments
+	for (const auto& [segment, parent] : segments)
+	{
+		for (const auto& key : segment.keyPositions) timeStamps.push_back(key.timeStamp);
+		for (const auto& key : segment.keyRotations) timeStamps.push_back(key.timeStamp);
+		for (const auto& key : segment.keyScales) timeStamps.push_back(key.timeStamp);
+	}
+
+	std::sort(timeStamps.begin(), timeStamps.end());
+	timeStamps.erase(std::unique(timeStamps.begin(), timeStamps.end(),
+								 [](float first, float second) { return second - first < 1e-5f; }),
+					 timeStamps.end());
+
+	if (timeStamps.empty())
+	{
+		timeStamps.push_back(0.0f);
+	}
+
+	keys.resize(timeStamps.size() * blockSize);
+
+	for (int key = 0; key < GetNumberOfKeys(); key++)
+	{
+		float* block = keys.data() + static_cast<size_t>(key) * blockSize;
+		Pose::SetIdentity(block, stride);
+
+		for (int i = 0; i < numberOfSegments; i++)
+		{
+			const Segment& segment = segments[i].first;
+			float timeStamp = timeStamps[key];
+
+			glm::vec3 translation = SampleKeys(segment.keyPositions, &KeyPosition::position, timeStamp, glm::vec3(0.0f), Mix);
+			glm::quat rotation = SampleKeys(segment.keyRotations, &KeyRotation::rotation, timeStamp, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), Slerp);
+			glm::vec3 scale = SampleKeys(segment.keyScales, &KeyScale::scale, timeStamp, glm::vec3(1.0f), Mix);
+
+			// Keep consecutive keys in the same hemisphere so the sampler rarely has to flip
+			if (key > 0)
+			{
+				const float* previous = block - blockSize;
+				glm::quat previousRotation(previous[RotationW * stride + i], previous[RotationX * stride + i],
+										   previous[RotationY * stride + i], previous[RotationZ * stride + i]);
+				if (glm::dot(previousRotation, rotation) < 0.0f)
+				{
+					rotation = -rotation;
+				}
+			}
+
+			block[TranslationX * stride + i] = translation.x;
+			block[TranslationY * stride + i] = translation.y;
+			block[TranslationZ * stride + i] = translation.z;
+			block[RotationX * stride + i] = rotation.x;
+			block[RotationY * stride + i] = rotation.y;
+			block[RotationZ * stride + i] = rotation.z;
+			block[RotationW * stride + i] = rotation.w;
+			block[ScaleX * stride + i] = scale.x;
+			block[ScaleY * stride + i] = scale.y;
+			block[ScaleZ * stride + i] = scale.z;
+		}
+	}
+}
+
+void KeyframeTable::Sample(float timeStamp, Pose& pose) const
+{
+	assert(pose.GetNumberOfSegments() == numberOfSegments);
+
+	if (timeStamp <= timeStamps.front()
+		|| timeStamps.size() == 1)
+	{
+		std::copy(GetKey(0), GetKey(0) + blockSize, pose.GetData());
+		return;
+	}
+
+	if (timeStamp >= timeStamps.back())
+	{
+		int lastKey = GetNumberOfKeys() - 1;
+		std::copy(GetKey(lastKey), GetKey(lastKey) + blockSize, pose.GetData());
+		return;
+	}
+
+	int secondKey = static_cast<int>(std::distance(timeStamps.begin(),
+												   std::upper_bound(timeStamps.begin(), timeStamps.end(), timeStamp)));
+	int firstKey = secondKey - 1;
+	float interpolant = (timeStamp - timeStamps[firstKey]) / (timeStamps[secondKey] - timeStamps[firstKey]);
+
+	InterpolatePoses(GetKey(firstKey), GetKey(secondKey), interpolant, pose.GetData(), stride);
+}
+
+} // namespace Hedge
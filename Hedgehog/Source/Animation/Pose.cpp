@@ -0,0 +1,76 @@
+#include <Animation/Pose.h>
+
+#include <algorithm>
+
+
+namespace Hedge
+{
+
+void Pose::SetIdentity(float* block, int stride)
+{
+	std::fill(block, block + NumberOfPoseChannels * stride, 0.0f);
+	std::fill(block + RotationW * stride, block + (RotationW + 1) * stride, 1.0f);
+	std::fill(block + ScaleX * stride, block + (ScaleZ + 1) * stride, 1.0f);
+}
+
+void Pose::Resize(int numberOfSegments)
+{
+	this->numberOfSegments = numberOfSegments;
+	stride = GetStride(numberOfSegments);
+	data.resize(NumberOfPoseChannels * stride);
+
+	SetIdentity();
+}
+
+glm::vec3 Pose::GetTranslation(int segment) const
+{
+	return glm::vec3(data[TranslationX * stride + segment],
+					 data[TranslationY * stride + segment],
+					 data[TranslationZ * stride + segment]);
+}
+
+glm::quat Pose::GetRotation(int segment) const
+{
+	return glm::quat(data[RotationW * stride + segment],
+					 data[RotationX * stride + segment],
+					 data[RotationY * stride + segment],
+					 data[RotationZ * stride + segment]);
+}
+
+glm::vec3 Pose::GetScale(int segment) const
+{
+	return glm::vec3(data[ScaleX * stride + segment],
+					 data[ScaleY * stride + segment],
+					 data[ScaleZ * stride + segment]);
+}
+
+glm::mat4 Pose::GetMatrix(int segment) const
+{
+	glm::mat4 matrix = glm::mat4_cast(GetRotation(segment));
+	glm::vec3 scale = GetScale(segment);
+
+	matrix[0] *= scale.x;
+	matrix[1] *= scale.y;
+	matrix[2] *= scale.z;
+	matrix[3] = glm::vec4(GetTranslation(segment), 1.0f);
+
+	return matrix;
+}
+
+void Pose::Set(int segment, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+{
+	data[TranslationX * stride + segment] = translation.x;
+	data[TranslationY * stride + segment] = translation.y;
+	data[TranslationZ * stride + segment] = translation.z;
+
+	data[RotationX * stride + segment] = rotation.x;
+	data[RotationY * stride + segment] = rotation.y;
+	data[RotationZ * stride + segment] = rotation.z;
+	data[RotationW * stride + segment] = rotation.w;
+
+	data[ScaleX * stride + segment] = scale.x;
+	data[ScaleY * stride + segment] = scale.y;
+	data[ScaleZ * stride + segment] = scale.z;
+}
+
+} // namespace Hedge
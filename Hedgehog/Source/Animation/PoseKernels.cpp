@@ -0,0 +1,289 @@
+#include <Animation/PoseKernels.h>
+
+#include <Utilities/CpuFeatures.h>
+
+#include <immintrin.h>
+
+
+namespace Hedge
+{
+
+namespace
+{
+
+const PoseChannel linearChannels[] = { TranslationX, TranslationY, TranslationZ, ScaleX, ScaleY, ScaleZ };
+
+// Thin wrappers so every kernel is written once for both vector widths
+struct SSE
+{
+	using Float = __m128;
+	static constexpr int WIDTH = 4;
+
+	static Float Load(const float* data) { return _mm_loadu_ps(data); }
+	static void Store(float* data, Float value) { _mm_storeu_ps(data, value); }
+	static Float Set(float value) { return _mm_set1_ps(value); }
+	static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+	static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+	static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+	static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+	static Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+	static Float And(Float a, Float b) { return _mm_and_ps(a, b); }
+	static Float AndNot(Float a, Float b) { return _mm_andnot_ps(a, b); }
+	static Float Xor(Float a, Float b) { return _mm_xor_ps(a, b); }
+	static int LessThan(Float a, Float b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+	static void Finish() {}
+};
+
+struct AVX
+{
+	using Float = __m256;
+	static constexpr int WIDTH = 8;
+
+	static Float Load(const float* data) { return _mm256_loadu_ps(data); }
+	static void Store(float* data, Float value) { _mm256_storeu_ps(data, value); }
+	static Float Set(float value) { return _mm256_set1_ps(value); }
+	static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+	static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+	static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+	static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+	static Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+	static Float And(Float a, Float b) { return _mm256_and_ps(a, b); }
+	static Float AndNot(Float a, Float b) { return _mm256_andnot_ps(a, b); }
+	static Float Xor(Float a, Float b) { return _mm256_xor_ps(a, b); }
+	static int LessThan(Float a, Float b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+	// Avoid the AVX-SSE transition penalty in whatever non-VEX code runs next
+	static void Finish() { _mm256_zeroupper(); }
+};
+
+// a, b and q hold WIDTH lanes of the x, y, z and w components one after another
+// b is expected to be already flipped into the hemisphere of a
+template <int WIDTH>
+void SlerpLanes(int mask, const float* a, const float* b, float interpolant, float* q)
+{
+	for (int lane = 0; lane < WIDTH; lane++)
+	{
+		if (mask & (1 << lane))
+		{
+			glm::quat first(a[3 * WIDTH + lane], a[lane], a[WIDTH + lane], a[2 * WIDTH + lane]);
+			glm::quat second(b[3 * WIDTH + lane], b[lane], b[WIDTH + lane], b[2 * WIDTH + lane]);
+
+			glm::quat rotation = glm::normalize(glm::slerp(first, second, interpolant));
+
+			q[lane] = rotation.x;
+			q[WIDTH + lane] = rotation.y;
+			q[2 * WIDTH + lane] = rotation.z;
+			q[3 * WIDTH + lane] = rotation.w;
+		}
+	}
+}
+
+// Interpolates WIDTH quaternions from a to b along the shortest arc, nlerp with slerp for the lanes too far apart
+template <typename SIMD>
+void InterpolateRotations(const typename SIMD::Float (&a)[4], typename SIMD::Float (&b)[4], float interpolant, typename SIMD::Float (&q)[4])
+{
+	using Float = typename SIMD::Float;
+	const Float t = SIMD::Set(interpolant);
+	const Float signMask = SIMD::Set(-0.0f);
+
+	Float dot = SIMD::Add(SIMD::Add(SIMD::Mul(a[0], b[0]), SIMD::Mul(a[1], b[1])),
+						  SIMD::Add(SIMD::Mul(a[2], b[2]), SIMD::Mul(a[3], b[3])));
+
+	// Take the shortest arc
+	Float sign = SIMD::And(dot, signMask);
+	for (int c = 0; c < 4; c++)
+	{
+		b[c] = SIMD::Xor(b[c], sign);
+		q[c] = SIMD::Add(a[c], SIMD::Mul(SIMD::Sub(b[c], a[c]), t));
+	}
+
+	Float lengthSquared = SIMD::Add(SIMD::Add(SIMD::Mul(q[0], q[0]), SIMD::Mul(q[1], q[1])),
+									SIMD::Add(SIMD::Mul(q[2], q[2]), SIMD::Mul(q[3], q[3])));
+	Float inverseLength = SIMD::Div(SIMD::Set(1.0f), SIMD::Sqrt(lengthSquared));
+
+	for (int c = 0; c < 4; c++)
+	{
+		q[c] = SIMD::Mul(q[c], inverseLength);
+	}
+
+	int slerpMask = SIMD::LessThan(SIMD::AndNot(signMask, dot), SIMD::Set(NLERP_MIN_DOT));
+	if (slerpMask != 0)
+	{
+		constexpr int WIDTH = SIMD::WIDTH;
+		alignas(32) float sa[4 * WIDTH];
+		alignas(32) float sb[4 * WIDTH];
+		alignas(32) float sq[4 * WIDTH];
+		for (int c = 0; c < 4; c++)
+		{
+			SIMD::Store(sa + WIDTH * c, a[c]);
+			SIMD::Store(sb + WIDTH * c, b[c]);
+			SIMD::Store(sq + WIDTH * c, q[c]);
+		}
+
+		SlerpLanes<WIDTH>(slerpMask, sa, sb, interpolant, sq);
+
+		for (int c = 0; c < 4; c++)
+		{
+			q[c] = SIMD::Load(sq + WIDTH * c);
+		}
+	}
+}
+
+// Hamilton product of WIDTH quaternion pairs, components in x, y, z, w order
+template <typename SIMD>
+void MultiplyRotations(const typename SIMD::Float (&a)[4], const typename SIMD::Float (&b)[4], typename SIMD::Float (&q)[4])
+{
+	using Float = typename SIMD::Float;
+	const Float& ax = a[0]; const Float& ay = a[1]; const Float& az = a[2]; const Float& aw = a[3];
+	const Float& bx = b[0]; const Float& by = b[1]; const Float& bz = b[2]; const Float& bw = b[3];
+
+	q[0] = SIMD::Add(SIMD::Add(SIMD::Mul(aw, bx), SIMD::Mul(ax, bw)), SIMD::Sub(SIMD::Mul(ay, bz), SIMD::Mul(az, by)));
+	q[1] = SIMD::Add(SIMD::Add(SIMD::Mul(aw, by), SIMD::Mul(ay, bw)), SIMD::Sub(SIMD::Mul(az, bx), SIMD::Mul(ax, bz)));
+	q[2] = SIMD::Add(SIMD::Add(SIMD::Mul(aw, bz), SIMD::Mul(az, bw)), SIMD::Sub(SIMD::Mul(ax, by), SIMD::Mul(ay, bx)));
+	q[3] = SIMD::Sub(SIMD::Sub(SIMD::Mul(aw, bw), SIMD::Mul(ax, bx)), SIMD::Add(SIMD::Mul(ay, by), SIMD::Mul(az, bz)));
+}
+
+template <typename SIMD>
+void LoadRotations(const float* block, int stride, int i, typename SIMD::Float (&q)[4])
+{
+	for (int c = 0; c < 4; c++)
+	{
+		q[c] = SIMD::Load(block + (RotationX + c) * stride + i);
+	}
+}
+
+template <typename SIMD>
+void StoreRotations(float* block, int stride, int i, const typename SIMD::Float (&q)[4])
+{
+	for (int c = 0; c < 4; c++)
+	{
+		SIMD::Store(block + (RotationX + c) * stride + i, q[c]);
+	}
+}
+
+template <typename SIMD>
+void InterpolatePosesKernel(const float* first, const float* second, float interpolant, float* result, int stride)
+{
+	using Float = typename SIMD::Float;
+	const Float t = SIMD::Set(interpolant);
+
+	for (PoseChannel channel : linearChannels)
+	{
+		const float* a = first + channel * stride;
+		const float* b = second + channel * stride;
+		float* r = result + channel * stride;
+
+		for (int i = 0; i < stride; i += SIMD::WIDTH)
+		{
+			Float va = SIMD::Load(a + i);
+			Float vb = SIMD::Load(b + i);
+			SIMD::Store(r + i, SIMD::Add(va, SIMD::Mul(SIMD::Sub(vb, va), t)));
+		}
+	}
+
+	for (int i = 0; i < stride; i += SIMD::WIDTH)
+	{
+		Float a[4];
+		Float b[4];
+		Float q[4];
+		LoadRotations<SIMD>(first, stride, i, a);
+		LoadRotations<SIMD>(second, stride, i, b);
+
+		InterpolateRotations<SIMD>(a, b, interpolant, q);
+
+		StoreRotations<SIMD>(result, stride, i, q);
+	}
+
+	SIMD::Finish();
+}
+
+template <typename SIMD>
+void AddPosesKernel(const float* base, const float* additive, const float* reference, float weight, float* result, int stride)
+{
+	using Float = typename SIMD::Float;
+	const Float w = SIMD::Set(weight);
+	const Float one = SIMD::Set(1.0f);
+	const Float signMask = SIMD::Set(-0.0f);
+
+	// base + weight * (additive - reference)
+	for (PoseChannel channel : { TranslationX, TranslationY, TranslationZ })
+	{
+		for (int i = 0; i < stride; i += SIMD::WIDTH)
+		{
+			int offset = channel * stride + i;
+			Float delta = SIMD::Sub(SIMD::Load(additive + offset), SIMD::Load(reference + offset));
+			SIMD::Store(result + offset, SIMD::Add(SIMD::Load(base + offset), SIMD::Mul(delta, w)));
+		}
+	}
+
+	// base * (1 + weight * (additive / reference - 1))
+	for (PoseChannel channel : { ScaleX, ScaleY, ScaleZ })
+	{
+		for (int i = 0; i < stride; i += SIMD::WIDTH)
+		{
+			int offset = channel * stride + i;
+			Float ratio = SIMD::Div(SIMD::Load(additive + offset), SIMD::Load(reference + offset));
+			Float factor = SIMD::Add(one, SIMD::Mul(SIMD::Sub(ratio, one), w));
+			SIMD::Store(result + offset, SIMD::Mul(SIMD::Load(base + offset), factor));
+		}
+	}
+
+	// base * (identity -> inverse(reference) * additive by weight)
+	const Float zero = SIMD::Set(0.0f);
+	const Float identity[4] = { zero, zero, zero, one };
+
+	for (int i = 0; i < stride; i += SIMD::WIDTH)
+	{
+		Float b[4];
+		Float r[4];
+		Float a[4];
+		LoadRotations<SIMD>(base, stride, i, b);
+		LoadRotations<SIMD>(reference, stride, i, r);
+		LoadRotations<SIMD>(additive, stride, i, a);
+
+		// Conjugate is the inverse for unit quaternions
+		for (int c = 0; c < 3; c++)
+		{
+			r[c] = SIMD::Xor(r[c], signMask);
+		}
+
+		Float delta[4];
+		MultiplyRotations<SIMD>(r, a, delta);
+
+		Float weighted[4];
+		InterpolateRotations<SIMD>(identity, delta, weight, weighted);
+
+		Float q[4];
+		MultiplyRotations<SIMD>(b, weighted, q);
+
+		StoreRotations<SIMD>(result, stride, i, q);
+	}
+
+	SIMD::Finish();
+}
+
+using InterpolatePosesFunction = void (*)(const float*, const float*, float, float*, int);
+using AddPosesFunction = void (*)(const float*, const float*, const float*, float, float*, int);
+
+bool UseAVX()
+{
+	// SSE2 is always there on x64
+	return GetCpuFeatures().avx;
+}
+
+} // namespace
+
+void InterpolatePoses(const float* first, const float* second, float interpolant, float* result, int stride)
+{
+	static const InterpolatePosesFunction interpolatePoses = UseAVX() ? InterpolatePosesKernel<AVX> : InterpolatePosesKernel<SSE>;
+
+	interpolatePoses(first, second, interpolant, result, stride);
+}
+
+void AddPoses(const float* base, const float* additive, const float* reference, float weight, float* result, int stride)
+{
+	static const AddPosesFunction addPoses = UseAVX() ? AddPosesKernel<AVX> : AddPosesKernel<SSE>;
+
+	addPoses(base, additive, reference, weight, result, stride);
+}
+
+} // namespace Hedge
@@ -15,34 +15,6 @@ const Transform Segment::GetTransform(float timeStamp) const
 	return transform;
 }
 
-const glm::mat4 Segment::GetTransformMatrix(float timeStamp) const
-{
-	int firstKeyIndex = GetIndex<KeyPosition>(timeStamp, keyPositions);
-	int secondKeyIndex = firstKeyIndex + 1;
-
-	if (firstKeyIndex == -1)
-	{
-		return glm::mat4(1.0f);
-	}
-
-	KeyTransform firstKeyTransform = keyTransforms[firstKeyIndex];
-	KeyTransform secondKeyTransform = keyTransforms[secondKeyIndex];
-	float interpolant = GetInterpolant(firstKeyTransform.timeStamp, secondKeyTransform.timeStamp, timeStamp);
-
-	glm::vec4 firstKeyPosition = firstKeyTransform.transform[3];
-	glm::vec4 secondKeyPosition = secondKeyTransform.transform[3];
-	glm::vec4 translation = glm::mix(firstKeyPosition, secondKeyPosition, interpolant);
-
-	glm::quat firstKeyRotation = glm::quat_cast(firstKeyTransform.transform);
-	glm::quat secondKeyRotation = glm::quat_cast(secondKeyTransform.transform);
-	glm::quat rotation = glm::slerp(firstKeyRotation, secondKeyRotation, interpolant);
-
-	glm::mat4 transform = glm::mat4_cast(rotation);
-	transform[3] = translation;
-
-	return transform;
-}
-
 const glm::vec3 Segment::GetTranslation(float timeStamp) const
 {
 	int firstKeyIndex = GetIndex<KeyPosition>(timeStamp, keyPositions);
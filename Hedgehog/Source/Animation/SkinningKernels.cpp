@@ -0,0 +1,155 @@
+#include <Animation/SkinningKernels.h>
+
+#include <Utilities/CpuFeatures.h>
+
+#include <immintrin.h>
+
+
+namespace Hedge
+{
+
+namespace
+{
+
+void SkinVerticesReference(const float* source, float* destination, size_t first, size_t count,
+						   const SkinningLayout& layout, const glm::mat4* palette)
+{
+	for (size_t vertex = first; vertex < first + count; vertex++)
+	{
+		const float* input = source + vertex * layout.stride;
+		float* output = destination + vertex * layout.stride;
+
+		glm::vec3 position(0.0f);
+		glm::vec3 normal(0.0f);
+		glm::vec3 tangent(0.0f);
+		glm::vec3 bitangent(0.0f);
+
+		for (int i = 0; i < 4; i++)
+		{
+			if (input[layout.segmentIDs + i] == -1.0f)
+			{
+				continue;
+			}
+
+			const glm::mat4& transform = palette[(int)input[layout.segmentIDs + i]];
+			float weight = input[layout.segmentWeights + i];
+
+			position += glm::vec3(transform * glm::vec4(input[layout.position + 0], input[layout.position + 1], input[layout.position + 2], 1.0f)) * weight;
+
+			glm::mat3 rotation(transform);
+			if (layout.normal >= 0) normal += rotation * glm::vec3(input[layout.normal + 0], input[layout.normal + 1], input[layout.normal + 2]) * weight;
+			if (layout.tangent >= 0) tangent += rotation * glm::vec3(input[layout.tangent + 0], input[layout.tangent + 1], input[layout.tangent + 2]) * weight;
+			if (layout.bitangent >= 0) bitangent += rotation * glm::vec3(input[layout.bitangent + 0], input[layout.bitangent + 1], input[layout.bitangent + 2]) * weight;
+		}
+
+		auto store = [output](int offset, const glm::vec3& value)
+		{
+			if (offset >= 0)
+			{
+				output[offset + 0] = value.x;
+				output[offset + 1] = value.y;
+				output[offset + 2] = value.z;
+			}
+		};
+		store(layout.position, position);
+		store(layout.normal, normal);
+		store(layout.tangent, tangent);
+		store(layout.bitangent, bitangent);
+	}
+}
+
+// Blended matrix times (x, y, z, w) with the matrix as two registers of column pairs, c0|c1 and c2|c3
+__m128 Transform(__m256 columns01, __m256 columns23, const float* vector, float w)
+{
+	__m256 xy = _mm256_set_m128(_mm_set1_ps(vector[1]), _mm_set1_ps(vector[0]));
+	__m256 zw = _mm256_set_m128(_mm_set1_ps(w), _mm_set1_ps(vector[2]));
+
+	__m256 sum = _mm256_fmadd_ps(columns23, zw, _mm256_mul_ps(columns01, xy));
+
+	return _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+}
+
+// Only xyz, the next attribute follows right after
+void Store3(float* data, __m128 value)
+{
+	_mm_storel_pi(reinterpret_cast<__m64*>(data), value);
+	_mm_store_ss(data + 2, _mm_movehl_ps(value, value));
+}
+
+void SkinVerticesAVX2(const float* source, float* destination, size_t first, size_t count,
+					  const SkinningLayout& layout, const glm::mat4* palette)
+{
+	for (size_t vertex = first; vertex < first + count; vertex++)
+	{
+		const float* input = source + vertex * layout.stride;
+		float* output = destination + vertex * layout.stride;
+
+		// Transforming by the weighted sum of the matrices is the same as summing the weighted transformed vectors,
+		// but it's four fmadds per segment and one transform per attribute instead of one per segment
+		__m256 columns01 = _mm256_setzero_ps();
+		__m256 columns23 = _mm256_setzero_ps();
+
+		for (int i = 0; i < 4; i++)
+		{
+			if (input[layout.segmentIDs + i] == -1.0f)
+			{
+				continue;
+			}
+
+			const float* transform = &palette[(int)input[layout.segmentIDs + i]][0][0];
+			__m256 weight = _mm256_set1_ps(input[layout.segmentWeights + i]);
+
+			columns01 = _mm256_fmadd_ps(_mm256_loadu_ps(transform + 0), weight, columns01);
+			columns23 = _mm256_fmadd_ps(_mm256_loadu_ps(transform + 8), weight, columns23);
+		}
+
+		Store3(output + layout.position, Transform(columns01, columns23, input + layout.position, 1.0f));
+		if (layout.normal >= 0) Store3(output + layout.normal, Transform(columns01, columns23, input + layout.normal, 0.0f));
+		if (layout.tangent >= 0) Store3(output + layout.tangent, Transform(columns01, columns23, input + layout.tangent, 0.0f));
+		if (layout.bitangent >= 0) Store3(output + layout.bitangent, Transform(columns01, columns23, input + layout.bitangent, 0.0f));
+	}
+
+	_mm256_zeroupper();
+}
+
+using SkinVerticesFunction = void (*)(const float*, float*, size_t, size_t, const SkinningLayout&, const glm::mat4*);
+
+} // namespace
+
+SkinningLayout SkinningLayout::Create(const BufferLayout& bufferLayout)
+{
+	SkinningLayout layout;
+	layout.stride = bufferLayout.GetStride() / sizeof(float);
+
+	for (auto& element : bufferLayout)
+	{
+		int offset = (int)(element.offset / sizeof(float));
+
+		if (element.name == "a_position") layout.position = offset;
+		else if (element.name == "a_normal") layout.normal = offset;
+		else if (element.name == "a_tangent") layout.tangent = offset;
+		else if (element.name == "a_bitangent") layout.bitangent = offset;
+		else if (element.name == "a_segmentIDs") layout.segmentIDs = offset;
+		// Sic, that's how the layouts spell it
+		else if (element.name == "a_segmentWeigths" || element.name == "a_segmentWeights") layout.segmentWeights = offset;
+	}
+
+	return layout;
+}
+
+void SkinVertices(const float* source, float* destination, size_t first, size_t count,
+				  const SkinningLayout& layout, const glm::mat4* palette, bool reference)
+{
+	static const SkinVerticesFunction skinVertices = GetCpuFeatures().avx2 && GetCpuFeatures().fma ? SkinVerticesAVX2 : SkinVerticesReference;
+
+	if (reference)
+	{
+		SkinVerticesReference(source, destination, first, count, layout, palette);
+	}
+	else
+	{
+		skinVertices(source, destination, first, count, layout, palette);
+	}
+}
+
+} // namespace Hedge
@@ -1,9 +1,6 @@
 #include <Component/Mesh.h>
 
-#include <Model/Model.h>
-
-#include <fstream>
-#include <unordered_map>
+#include <Renderer/ResourceCache.h>
 
 
 namespace Hedge
@@ -15,23 +12,10 @@ Mesh::Mesh(const std::string& modelFilename,
 		   const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
 		   const std::vector<Hedge::TextureDescription>& textureDescriptions)
 {
-	Model model;
-	if (modelFilename.ends_with(".tri"))
-	{
-		model.LoadTri(modelFilename);
-	}
-	else if (modelFilename.ends_with(".obj"))
-	{
-		model.LoadObj(modelFilename);
-	}
-
-	CreateMesh(model.GetVertices(), model.GetSizeOfVertices(),
-			   model.GetIndices(), model.GetNumberOfIndices(),
-			   primitiveTopology, bufferLayout,
+	CreateMesh(ResourceCache::GetGeometry(modelFilename, primitiveTopology, bufferLayout),
 			   constBufferDesc,
 			   VSfilename, PSfilename, GSfilename,
-			   textureDescriptions,
-			   {});
+			   textureDescriptions);
 }
 
 Mesh::Mesh(const float* vertices, unsigned int sizeOfVertices,
@@ -42,53 +26,30 @@ Mesh::Mesh(const float* vertices, unsigned int sizeOfVertices,
 		   const std::vector<Hedge::TextureDescription>& textureDescriptions,
 		   const std::vector<VertexGroup>& groups)
 {
-	CreateMesh(vertices, sizeOfVertices,
-			   indices, numberOfIndices,
-			   primitiveTopology, bufferLayout,
+	auto geometry = std::shared_ptr<Geometry>(Geometry::Create(vertices, sizeOfVertices,
+															   indices, numberOfIndices,
+															   primitiveTopology, bufferLayout,
+															   groups));
+	CreateMesh(geometry,
 			   constBufferDesc,
 			   VSfilename, PSfilename, GSfilename,
-			   textureDescriptions,
-			   groups);
+			   textureDescriptions);
 }
 
-void Mesh::CreateMesh(const float* vertices, unsigned int sizeOfVertices,
-					 const unsigned int* indices, unsigned int numberOfIndices,
-					 PrimitiveTopology primitiveTopology, BufferLayout bufferLayout,
-					 ConstantBufferDescription constBufferDesc,
-					 const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
-					 const std::vector<Hedge::TextureDescription>& textureDescriptions,
-					 const std::vector<VertexGroup>& groups)
+void Mesh::CreateMesh(const std::shared_ptr<Geometry>& geometry,
+					  ConstantBufferDescription constBufferDesc,
+					  const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
+					  const std::vector<Hedge::TextureDescription>& textureDescriptions)
 {
-	auto shader = std::shared_ptr<Shader>(Hedge::Shader::Create(VSfilename, PSfilename, GSfilename));
-	shader->SetupConstantBuffers(constBufferDesc);
+	this->geometry = geometry;
+	material = ResourceCache::GetMaterial(VSfilename, PSfilename, GSfilename, constBufferDesc, textureDescriptions, geometry.get());
+	vertexArray = ResourceCache::GetVertexArray(geometry, material);
 
-	vertexArray.reset(Hedge::VertexArray::Create(shader, primitiveTopology, {}, textureDescriptions));
-
-	std::unordered_map<TextureType, int> texturePosition = 
-	{
-		{ TextureType::Diffuse, 0 },
-		{ TextureType::Specular, 0 },
-		{ TextureType::Normal, 0 },
-		{ TextureType::Generic, 0 },
-	};
-	for (auto& textureDesc : textureDescriptions)
+	// A geometry shader may put the triangles anywhere
+	if (GSfilename.empty())
 	{
-		if (!textureDesc.filename.empty())
-		{
-			std::shared_ptr<Texture> texture;
-			texture.reset(Hedge::Texture2D::Create(textureDesc.filename));
-
-			vertexArray->AddTexture(textureDesc.type, texturePosition[textureDesc.type]++, texture);
-		}
+		depthVertexArray = geometry->depthVertexArray;
 	}
-
-	auto vertexBuffer = std::shared_ptr<VertexBuffer>(VertexBuffer::Create(bufferLayout, vertices, sizeOfVertices));
-	vertexArray->AddVertexBuffer(vertexBuffer);
-
-	auto indexBuffer = std::shared_ptr<IndexBuffer>(Hedge::IndexBuffer::Create(indices, numberOfIndices));
-	vertexArray->AddIndexBuffer(indexBuffer);
-
-	vertexArray->SetupGroups(groups);
 }
 
 } // namespace Hedge
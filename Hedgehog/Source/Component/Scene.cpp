@@ -3,21 +3,35 @@
 #include <Component/Mesh.h>
 #include <Component/Transform.h>
 #include <Animation/Animator.h>
+#include <Animation/BakedAnimator.h>
+#include <Animation/CpuSkinner.h>
+#include <Utilities/JobSystem.h>
 
 #include <Renderer/Renderer.h>
 #include <Renderer/DirectX12VertexArray.h>
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <unordered_map>
+
 
 namespace Hedge
 {
 
+// How far the vertices of an animated mesh can get from the center of its bind pose, relative to its extent
+static constexpr float ANIMATED_BOUNDS_SCALE = 2.0f;
+
 Scene::Scene()
 {
 	// As per recommendation in https://github.com/skypjack/entt/wiki/Crash-Course:-entity-component-system#groups
 	// prepare groups that will be used while the registry is still empty
 	auto group = registry.group<Mesh, Transform>();
+
+	registry.on_construct<Parent>().connect<&Scene::OnHierarchyChanged>(*this);
+	registry.on_update<Parent>().connect<&Scene::OnHierarchyChanged>(*this);
+	registry.on_destroy<Parent>().connect<&Scene::OnHierarchyChanged>(*this);
+	registry.on_destroy<WorldTransform>().connect<&Scene::OnHierarchyChanged>(*this);
 }
 
 Entity Scene::CreateEntity(const std::string& name)
@@ -29,21 +43,40 @@ Entity Scene::CreateEntity(const std::string& name)
 
 void Scene::DestroyEntity(Entity entity)
 {
-	registry.destroy(entity.entity);
-}
+	if (registry.has<PaletteAllocation>(entity.entity))
+	{
+		paletteBuffer.Free(registry.get<PaletteAllocation>(entity.entity));
+	}
 
-void Scene::OnUpdate(const std::chrono::duration<double, std::milli>& duration)
-{
-	auto animations = registry.view<Animator>();
+	if (registry.has<SpatialProxy>(entity.entity)
+		&& registry.get<SpatialProxy>(entity.entity).proxy != BoundingVolumeHierarchy::NULL_NODE)
+	{
+		spatialIndex.DestroyProxy(registry.get<SpatialProxy>(entity.entity).proxy);
+	}
 
-	for (auto [entity, animator] : animations.each())
+	if (registry.has<MeshGroups>(entity.entity))
 	{
-		if (registry.get<Mesh>(entity).enabled)
+		for (const auto& group : registry.get<MeshGroups>(entity.entity).groups)
 		{
-			animator.Update((float)duration.count());
+			if (group.occlusion.query != -1)
+			{
+				RenderCommand::DestroyOcclusionQuery(group.occlusion.query);
+			}
 		}
 	}
 
+	registry.destroy(entity.entity);
+}
+
+void Scene::OnUpdate(const std::chrono::duration<double, std::milli>& duration)
+{
+	UpdateWorldTransforms();
+	UpdateSpatialIndex();
+	UpdateAnimations((float)duration.count());
+	UpdatePalettes();
+	UpdateSkinning();
+	UpdateOcclusion();
+
 
 	auto& cameraTransform = GetPrimaryCamera().Get<Transform>();
 
@@ -53,43 +86,225 @@ void Scene::OnUpdate(const std::chrono::duration<double, std::milli>& duration)
 	auto pointLights = registry.view<PointLight>();
 	auto spotLights = registry.view<SpotLight>();
 
+	// Same for every mesh, uploaded once unless the API can't share constants between shaders
+	FrameConstants frameConstants;
+	frameConstants.numberOfPointLights = std::min({ plUsed, (int)pointLights.size(), FrameConstants::MAX_POINT_LIGHTS });
+	if (!directionalLights.empty())
+	{
+		frameConstants.directionalLight = directionalLights.raw()[0];
+	}
+	else
+	{
+		frameConstants.directionalLight.color = glm::vec3(0.0f);
+	}
+	std::copy_n(pointLights.raw(), std::min((int)pointLights.size(), FrameConstants::MAX_POINT_LIGHTS), frameConstants.pointLights);
+	if (!spotLights.empty())
+	{
+		frameConstants.spotLight = spotLights.raw()[0];
+	}
+	else
+	{
+		frameConstants.spotLight.color = glm::vec3(0.0f);
+	}
+	UpdateLightClusters(frameConstants);
+	bool sharedFrameConstants = Renderer::SetFrameConstants(frameConstants);
+
+	// All of them before anything is submitted, the renderer keeps pointers to them until the end of the scene
+	for (auto entity : group)
+	{
+		if (!registry.has<MeshGroups>(entity))
+		{
+			registry.emplace<MeshGroups>(entity);
+		}
+	}
+
 	for (auto [entity, mesh, transform] : group.each())
 	{
 		std::string name = registry.get<std::string>(entity);
 
-		if (mesh.enabled)
+		auto& worldTransform = registry.get<WorldTransform>(entity).transform;
+
+		if (mesh.enabled
+			&& IsVisible(entity, mesh, worldTransform))
 		{
-			mesh.GetShader()->UploadConstant("u_viewPos", cameraTransform.GetTranslation());
-			mesh.GetShader()->UploadConstant("u_directionalLight", directionalLights.raw(), (int)directionalLights.size());
-			mesh.GetShader()->UploadConstant("u_numberOfPointLights", plUsed);
-			mesh.GetShader()->UploadConstant("u_pointLight", pointLights.raw(), (int)pointLights.size());
-			mesh.GetShader()->UploadConstant("u_spotLight", spotLights.raw(), (int)spotLights.size());
+			if (!sharedFrameConstants)
+			{
+				mesh.GetShader()->UploadConstant("u_viewPos", cameraTransform.GetTranslation());
+				mesh.GetShader()->UploadConstant("u_directionalLight", directionalLights.raw(), (int)directionalLights.size());
+				mesh.GetShader()->UploadConstant("u_numberOfPointLights", plUsed);
+				mesh.GetShader()->UploadConstant("u_pointLight", pointLights.raw(), (int)pointLights.size());
+				mesh.GetShader()->UploadConstant("u_spotLight", spotLights.raw(), (int)spotLights.size());
+			}
+
+			// Uploaded for this entity alone, it can't be drawn as an instance of another one
+			bool objectConstants = false;
 
 			if (registry.has<PointLight>(entity))
 			{
 				mesh.GetShader()->UploadConstant("u_lightColor", registry.get<PointLight>(entity).color);
+				objectConstants = true;
 			}
 			else if (registry.has<SpotLight>(entity))
 			{
 				mesh.GetShader()->UploadConstant("u_lightColor", registry.get<SpotLight>(entity).color);
+				objectConstants = true;
 			}
 
-			if (registry.has<Animator>(entity))
+			// Also for the meshes without a skinner, another entity of the shader may have set it
+			bool cpuSkinned = registry.has<CpuSkinner>(entity)
+				&& registry.get<CpuSkinner>(entity).enabled;
+			mesh.GetShader()->UploadConstant("u_cpuSkinned", (int)cpuSkinned);
+			if (registry.has<CpuSkinner>(entity))
 			{
-				auto& transforms = registry.get<Animator>(entity).GetTransforms();
+				objectConstants = true;
+			}
 
-				mesh.GetShader()->UploadConstant("u_segmentTransforms", transforms);
+			if (registry.has<PaletteAllocation>(entity))
+			{
+				mesh.GetShader()->UploadConstant("u_paletteOffset", (int)registry.get<PaletteAllocation>(entity).offset);
+				objectConstants = true;
+			}
+			else if (registry.has<Animator>(entity))
+			{
+				mesh.GetShader()->UploadConstant("u_segmentTransforms", registry.get<Animator>(entity).GetTransforms());
+				objectConstants = true;
 			}
 
-			if (registry.has<Parent>(entity))
+			// Animated vertices move in the vertex shader or the CPU rewrites them, the depth pre-pass only has the bind pose
+			bool rigid = !registry.has<Animator>(entity)
+				&& !registry.has<CpuSkinner>(entity);
+
+			Renderer::Submit(mesh.Get(), worldTransform, &occlusionBuffer, &occlusionQueries, rigid ? mesh.GetDepthVertexArray() : nullptr,
+							 objectConstants, rigid, &registry.get<MeshGroups>(entity));
+		}
+	}
+}
+
+bool Scene::IsVisible(entt::entity entity, const Mesh& mesh, const glm::mat4x4& transform)
+{
+	// Instances are spread around by their own offsets, the bounds of one don't say where they are
+	if (mesh.Get()->GetInstanceCount() > 1)
+	{
+		return true;
+	}
+
+	return Renderer::IsVisible(GetBounds(entity, mesh), transform, &occlusionBuffer);
+}
+
+BoundingBox Scene::GetBounds(entt::entity entity, const Mesh& mesh)
+{
+	BoundingBox bounds = mesh.GetBounds();
+
+	// Skinned vertices leave the bind pose bounds, give them some room around the center
+	if (bounds.IsValid()
+		&& registry.has<Animator>(entity))
+	{
+		glm::vec3 center = bounds.GetCenter();
+		glm::vec3 extent = bounds.GetExtent() * ANIMATED_BOUNDS_SCALE;
+		bounds.min = center - extent;
+		bounds.max = center + extent;
+	}
+
+	return bounds;
+}
+
+void Scene::UpdateAnimations(float timeStep)
+{
+	activeAnimators.clear();
+
+	auto camera = GetPrimaryCamera();
+	glm::vec3 cameraPosition(0.0f);
+	glm::mat4 projectionView(1.0f);
+	if (camera)
+	{
+		cameraPosition = camera.Get<Transform>().GetTranslation();
+		projectionView = camera.Get<Camera>().GetProjection() * glm::inverse(camera.Get<Transform>().Get());
+	}
+
+	auto animations = registry.view<Animator>();
+	for (auto [entity, animator] : animations.each())
+	{
+		if (registry.get<Mesh>(entity).enabled)
+		{
+			AnimationLod lod;
+			if (camera)
 			{
-				auto parentTransform = GetParentTransform(entity);
-				Renderer::Submit(mesh.Get(), parentTransform.Get() * transform.Get());
+				glm::vec3 position = glm::vec3(registry.get<WorldTransform>(entity).transform[3]);
+
+				lod = animationLodPolicy.Select(position, cameraPosition, projectionView);
 			}
-			else
+
+			animator.SetLod(lod, static_cast<unsigned int>(entity));
+			activeAnimators.push_back(&animator);
+		}
+	}
+
+	// Every animator only touches its own pose and palette, the shared animations are read only
+	// ParallelFor returns after all chunks are done, so the palettes are complete before anything gets drawn
+	JobSystem::Get().ParallelFor(activeAnimators.size(), Animator::UPDATE_CHUNK_SIZE,
+		[this, timeStep](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
 			{
-				Renderer::Submit(mesh.Get(), transform.Get());
+				activeAnimators[i]->Update(timeStep);
 			}
+		});
+
+	animationLodPolicy.ResetStatistics();
+	for (auto animator : activeAnimators)
+	{
+		animationLodPolicy.Count(animator->GetLod(), animator->HasEvaluatedGraph());
+	}
+
+	// Baked crowds only advance their instance clocks, nothing worth a job
+	auto bakedAnimations = registry.view<BakedAnimator>();
+	for (auto [entity, bakedAnimator] : bakedAnimations.each())
+	{
+		if (registry.get<Mesh>(entity).enabled)
+		{
+			bakedAnimator.Update(timeStep);
+		}
+	}
+}
+
+void Scene::UpdatePalettes()
+{
+	if (!paletteBuffer.IsSupported())
+	{
+		return;
+	}
+
+	auto animations = registry.view<Animator>();
+	for (auto [entity, animator] : animations.each())
+	{
+		auto& transforms = animator.GetTransforms();
+
+		if (!registry.has<PaletteAllocation>(entity))
+		{
+			registry.emplace<PaletteAllocation>(entity, paletteBuffer.Allocate((unsigned int)transforms.size()));
+		}
+
+		// Paused or not updated animators keep what was uploaded before
+		auto& allocation = registry.get<PaletteAllocation>(entity);
+		if (allocation.version != animator.GetTransformsVersion())
+		{
+			paletteBuffer.Write(allocation, transforms);
+			allocation.version = animator.GetTransformsVersion();
+		}
+	}
+
+	paletteBuffer.Upload();
+}
+
+void Scene::UpdateSkinning()
+{
+	// Each skinner runs its vertices on the job system, the meshes go one after another
+	auto skinners = registry.view<CpuSkinner, Animator, Mesh>();
+	for (auto [entity, skinner, animator, mesh] : skinners.each())
+	{
+		if (mesh.enabled)
+		{
+			skinner.Update(animator);
 		}
 	}
 }
@@ -118,20 +333,214 @@ const Entity Scene::GetPrimaryCamera()
 	return { entt::null, nullptr };
 }
 
-Transform Scene::GetParentTransform(entt::entity child)
+void Scene::OnHierarchyChanged(entt::registry& registry, entt::entity entity)
+{
+	hierarchyChanged = true;
+}
+
+void Scene::SortHierarchy()
 {
-	auto& parent = registry.get<Parent>(child).entity;
+	hierarchy.clear();
 
-	Transform parentTransform;
-	if (parent.Has<Parent>())
+	auto worldTransforms = registry.view<WorldTransform>();
+	for (auto entity : worldTransforms)
 	{
-		parentTransform = GetParentTransform(parent.entity);
+		int depth = 0;
+		for (entt::entity ancestor = entity; registry.has<Parent>(ancestor); ancestor = registry.get<Parent>(ancestor).entity.entity)
+		{
+			depth++;
+		}
+
+		hierarchy.push_back({ entity, -1, depth });
+
+		// The parent may be a different one now, recompute everything once
+		worldTransforms.get<WorldTransform>(entity).transformVersion = 0;
 	}
 
-	parentTransform.Translate(parent.Get<Transform>().GetTranslation());
-	parentTransform.Rotate(parent.Get<Transform>().GetRotation());
+	// Every parent is at a smaller depth, so it comes first
+	std::stable_sort(hierarchy.begin(), hierarchy.end(),
+		[](const HierarchyNode& first, const HierarchyNode& second) { return first.depth < second.depth; });
+
+	std::unordered_map<entt::entity, int> indices;
+	for (int i = 0; i < (int)hierarchy.size(); i++)
+	{
+		indices.emplace(hierarchy[i].entity, i);
+	}
+
+	for (auto& node : hierarchy)
+	{
+		if (registry.has<Parent>(node.entity))
+		{
+			auto parent = indices.find(registry.get<Parent>(node.entity).entity.entity);
+			if (parent != indices.end())
+			{
+				node.parent = parent->second;
+			}
+		}
+	}
+
+	hierarchyChanged = false;
+}
+
+void Scene::UpdateWorldTransforms()
+{
+	auto newEntities = registry.view<Transform>(entt::exclude<WorldTransform>);
+	if (newEntities.begin() != newEntities.end())
+	{
+		// Can't add the excluded component while iterating the view
+		std::vector<entt::entity> entities(newEntities.begin(), newEntities.end());
+		for (auto entity : entities)
+		{
+			registry.emplace<WorldTransform>(entity);
+		}
+
+		hierarchyChanged = true;
+	}
+
+	if (hierarchyChanged)
+	{
+		SortHierarchy();
+	}
+
+	// Local matrices of everything that moved are built together first
+	transformBatch.Clear();
+	for (auto& node : hierarchy)
+	{
+		auto& transform = registry.get<Transform>(node.entity);
+		if (registry.get<WorldTransform>(node.entity).transformVersion != transform.GetVersion())
+		{
+			node.local = (int)transformBatch.Add(transform);
+		}
+	}
+	transformBatch.Build();
+
+	// Parents are done by the time their children come, so a subtree is recomputed only if something above it changed
+	for (auto& node : hierarchy)
+	{
+		auto& transform = registry.get<Transform>(node.entity);
+		auto& world = registry.get<WorldTransform>(node.entity);
+
+		const WorldTransform* parent = node.parent >= 0 ? &registry.get<WorldTransform>(hierarchy[node.parent].entity) : nullptr;
+		unsigned int parentVersion = parent ? parent->version : 0;
+
+		if (world.transformVersion == transform.GetVersion()
+			&& world.parentVersion == parentVersion)
+		{
+			continue;
+		}
+
+		// Only the parent moved otherwise
+		glm::mat4 local = node.local >= 0 ? transformBatch.GetMatrix(node.local) : transform.Get();
+		glm::mat4 localTranslationRotation = node.local >= 0 ? transformBatch.GetTranslationRotation(node.local) : transform.GetTranslationRotation();
+		node.local = -1;
 
-	return parentTransform;
+		if (parent)
+		{
+			world.transform = parent->childSpace * local;
+			world.childSpace = parent->childSpace * localTranslationRotation;
+		}
+		else
+		{
+			world.transform = local;
+			world.childSpace = localTranslationRotation;
+		}
+
+		world.transformVersion = transform.GetVersion();
+		world.parentVersion = parentVersion;
+		world.version++;
+	}
+}
+
+void Scene::UpdateLightClusters(FrameConstants& frameConstants)
+{
+	auto camera = GetPrimaryCamera();
+	if (!camera
+		|| !lightClusters.IsActive(camera.Get<Camera>()))
+	{
+		return;
+	}
+
+	// Every point and spot light goes in, not just the ones the shaders have fixed slots for
+	lightClusters.Begin(camera.Get<Camera>(), glm::inverse(camera.Get<Transform>().Get()));
+	for (auto [entity, light] : registry.view<PointLight>().each())
+	{
+		lightClusters.AddPointLight(light);
+	}
+	for (auto [entity, light] : registry.view<SpotLight>().each())
+	{
+		lightClusters.AddSpotLight(light);
+	}
+	lightClusters.Build(frameConstants);
+}
+
+void Scene::UpdateOcclusion()
+{
+	auto camera = GetPrimaryCamera();
+	glm::mat4 projectionView(1.0f);
+	if (camera)
+	{
+		projectionView = camera.Get<Camera>().GetProjection() * glm::inverse(camera.Get<Transform>().Get());
+	}
+
+	occlusionBuffer.Begin(projectionView);
+	occlusionQueries.BeginFrame(camera ? camera.Get<Transform>().GetTranslation() : glm::vec3(0.0f));
+	if (!occlusionBuffer.enabled)
+	{
+		return;
+	}
+
+	auto occluders = registry.view<Occluder, WorldTransform>();
+	for (auto [entity, occluder, world] : occluders.each())
+	{
+		if (occluder.enabled)
+		{
+			occlusionBuffer.AddOccluder(occluder, world.transform);
+		}
+	}
+
+	occlusionBuffer.Rasterize();
+}
+
+void Scene::UpdateSpatialIndex()
+{
+	auto newMeshes = registry.view<Mesh, WorldTransform>(entt::exclude<SpatialProxy>);
+	if (newMeshes.begin() != newMeshes.end())
+	{
+		// Can't add the excluded component while iterating the view
+		std::vector<entt::entity> entities(newMeshes.begin(), newMeshes.end());
+		for (auto entity : entities)
+		{
+			registry.emplace<SpatialProxy>(entity);
+		}
+	}
+
+	// Only the entities whose WorldTransform changed, most of those don't leave their fat boxes
+	auto proxies = registry.view<SpatialProxy, Mesh, WorldTransform>();
+	for (auto [entity, proxy, mesh, world] : proxies.each())
+	{
+		if (proxy.version == world.version)
+		{
+			continue;
+		}
+		proxy.version = world.version;
+
+		// Instances are spread around by their own offsets, one box doesn't say where they are
+		if (mesh.Get()->GetInstanceCount() > 1
+			|| !mesh.GetBounds().IsValid())
+		{
+			continue;
+		}
+
+		BoundingBox bounds = GetBounds(entity, mesh).Transform(world.transform);
+		if (proxy.proxy == BoundingVolumeHierarchy::NULL_NODE)
+		{
+			proxy.proxy = spatialIndex.CreateProxy(bounds, static_cast<unsigned int>(entity));
+		}
+		else
+		{
+			spatialIndex.MoveProxy(proxy.proxy, bounds);
+		}
+	}
 }
 
 } // namespace Hedge
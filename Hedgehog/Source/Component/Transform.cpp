@@ -1,6 +1,5 @@
 #include <Component/Transform.h>
 
-#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -10,40 +9,38 @@
 namespace Hedge
 {
 
-glm::mat4 CreateTranslationMatrix(const glm::vec3& translation)
+glm::quat CreateRotation(const glm::vec3& rotation)
 {
-	return glm::translate(glm::mat4(1.0f), translation);
+	return glm::angleAxis(glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f))
+		* glm::angleAxis(glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f))
+		* glm::angleAxis(glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
 }
 
-glm::mat4 CreateRotationMatrix(const glm::vec3& rotation)
+glm::mat4 Transform::Get() const
 {
-	return (glm::rotate(glm::mat4(1.0f), glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f))
-			* glm::rotate(glm::mat4(1.0f), glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f))
-			* glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f)));
-}
+	glm::mat4 transform = glm::mat4_cast(rotation);
+	transform[0] *= scale.x;
+	transform[1] *= scale.y;
+	transform[2] *= scale.z;
+	transform[3] = glm::vec4(translation, 1.0f);
 
-glm::mat4 CreateScaleMatrix(const glm::vec3& scale)
-{
-	return glm::scale(glm::mat4(1.0f), scale);
+	return transform;
 }
 
-Transform::Transform()
+glm::mat4 Transform::GetTranslationRotation() const
 {
-	translationMatrix = CreateTranslationMatrix(translation);
-	rotationMatrix = CreateRotationMatrix(rotation);
-	scaleMatrix = CreateScaleMatrix(scale);
+	glm::mat4 transform = glm::mat4_cast(rotation);
+	transform[3] = glm::vec4(translation, 1.0f);
+
+	return transform;
 }
 
-const glm::mat4& Transform::Get()
+glm::vec3 Transform::GetEulerAngles() const
 {
-	if (updateTransform)
-	{
-		transform = translationMatrix * rotationMatrix * scaleMatrix;
+	glm::vec3 angles;
+	glm::extractEulerAngleXYZ(glm::mat4_cast(rotation), angles.x, angles.y, angles.z);
 
-		updateTransform = false;
-	}
-
-	return transform;
+	return glm::degrees(angles);
 }
 
 Transform Transform::operator*(const Transform& t1) const
@@ -51,7 +48,7 @@ Transform Transform::operator*(const Transform& t1) const
 	Transform result = *this;
 
 	result.Translate(t1.GetTranslation());
-	result.Rotate(t1.GetRotation());
+	result.SetRotation(result.rotation * t1.GetRotation());
 	result.Scale(t1.GetScale());
 
 	return result;
@@ -60,14 +57,12 @@ Transform Transform::operator*(const Transform& t1) const
 void Transform::SetTranslation(const glm::vec3& translation)
 {
 	this->translation = translation;
-	translationMatrix = CreateTranslationMatrix(this->translation);
-	updateTransform = true;
+	version++;
 }
 
 void Transform::Translate(const glm::vec3& translation)
 {
-	glm::vec4 orientedTranslation = rotationMatrix * glm::vec4(translation, 1.0f);
-	SetTranslation(this->translation + glm::vec3(orientedTranslation));
+	SetTranslation(this->translation + rotation * translation);
 }
 
 void Transform::TranslateAbsolute(const glm::vec3& translation)
@@ -77,46 +72,35 @@ void Transform::TranslateAbsolute(const glm::vec3& translation)
 
 void Transform::SetRotation(const glm::vec3& rotation)
 {
-	this->rotation = rotation;
-	rotationMatrix = CreateRotationMatrix(this->rotation);
-	updateTransform = true;
+	SetRotation(CreateRotation(rotation));
 }
 
 void Transform::SetRotation(const glm::mat4& rotation)
 {
-	rotationMatrix = rotation;
-
-	glm::extractEulerAngleXYZ(rotationMatrix, this->rotation.x, this->rotation.y, this->rotation.z);
-	this->rotation = glm::degrees(this->rotation);
-	updateTransform = true;
+	SetRotation(glm::quat_cast(rotation));
 }
 
 void Transform::SetRotation(const glm::quat& rotation)
 {
-	SetRotation(glm::mat4_cast(rotation));
+	// Keep it unit length, small errors add up over many relative rotations
+	this->rotation = glm::normalize(rotation);
+	version++;
 }
 
 void Transform::Rotate(const glm::vec3& rotation)
 {
-	rotationMatrix = glm::rotate(rotationMatrix, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationMatrix = glm::rotate(rotationMatrix, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationMatrix = glm::rotate(rotationMatrix, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-
-	glm::extractEulerAngleXYZ(rotationMatrix, this->rotation.x, this->rotation.y, this->rotation.z);
-	this->rotation = glm::degrees(this->rotation);
-	updateTransform = true;
+	SetRotation(this->rotation * CreateRotation(rotation));
 }
 
 void Transform::RotateAbsolute(const glm::vec3& rotation)
 {
-	SetRotation(this->rotation + rotation);
+	SetRotation(GetEulerAngles() + rotation);
 }
 
 void Transform::SetScale(const glm::vec3& scale)
 {
 	this->scale = scale;
-	scaleMatrix = CreateScaleMatrix(this->scale);
-	updateTransform = true;
+	version++;
 }
 
 void Transform::SetUniformScale(float scale)
@@ -160,7 +144,7 @@ void Transform::CreateGuiControls(bool controlTranslation,
 
 	if (controlRotation)
 	{
-		auto tempRotation = rotation;
+		auto tempRotation = GetEulerAngles();
 		if (ImGui::SliderFloat3("rotate", glm::value_ptr(tempRotation), -360.0, 360.0))
 		{
 			SetRotation(tempRotation);
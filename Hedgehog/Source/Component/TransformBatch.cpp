@@ -0,0 +1,192 @@
+#include <Component/TransformBatch.h>
+
+#include <Utilities/CpuFeatures.h>
+
+#include <immintrin.h>
+
+
+namespace Hedge
+{
+
+namespace
+{
+
+constexpr size_t WIDTH = 8;
+
+// Rows become columns, eight floats of eight transforms in, eight transforms of eight floats out
+void Transpose(__m256 rows[8])
+{
+	__m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+	__m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+	__m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+	__m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+	__m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+	__m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+	__m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+	__m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+	__m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+	rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+	rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+	rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+	rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+	rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+	rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+	rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+	rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// Eight elements of eight matrices, each register one element of all of them
+void StoreMatrices(__m256 elements[8], glm::mat4* matrices, int half)
+{
+	Transpose(elements);
+
+	for (size_t lane = 0; lane < WIDTH; lane++)
+	{
+		_mm256_storeu_ps(&matrices[lane][half * 2][0], elements[lane]);
+	}
+}
+
+void BuildMatricesAVX(const float* const* components, size_t count, glm::mat4* matrices, glm::mat4* translationRotations)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+
+	for (size_t i = 0; i < count; i += WIDTH)
+	{
+		__m256 tx = _mm256_loadu_ps(components[0] + i);
+		__m256 ty = _mm256_loadu_ps(components[1] + i);
+		__m256 tz = _mm256_loadu_ps(components[2] + i);
+		__m256 x = _mm256_loadu_ps(components[3] + i);
+		__m256 y = _mm256_loadu_ps(components[4] + i);
+		__m256 z = _mm256_loadu_ps(components[5] + i);
+		__m256 w = _mm256_loadu_ps(components[6] + i);
+		__m256 sx = _mm256_loadu_ps(components[7] + i);
+		__m256 sy = _mm256_loadu_ps(components[8] + i);
+		__m256 sz = _mm256_loadu_ps(components[9] + i);
+
+		// Same as glm::mat3_cast
+		__m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+		__m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+		__m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+		__m256 rotation[9] =
+		{
+			_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))),
+			_mm256_mul_ps(two, _mm256_add_ps(xy, wz)),
+			_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)),
+
+			_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)),
+			_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))),
+			_mm256_mul_ps(two, _mm256_add_ps(yz, wx)),
+
+			_mm256_mul_ps(two, _mm256_add_ps(xz, wy)),
+			_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)),
+			_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))),
+		};
+
+		__m256 translationRotation[2][8] =
+		{
+			{ rotation[0], rotation[1], rotation[2], zero, rotation[3], rotation[4], rotation[5], zero },
+			{ rotation[6], rotation[7], rotation[8], zero, tx, ty, tz, one },
+		};
+
+		__m256 scaled[2][8] =
+		{
+			{ _mm256_mul_ps(rotation[0], sx), _mm256_mul_ps(rotation[1], sx), _mm256_mul_ps(rotation[2], sx), zero,
+			  _mm256_mul_ps(rotation[3], sy), _mm256_mul_ps(rotation[4], sy), _mm256_mul_ps(rotation[5], sy), zero },
+			{ _mm256_mul_ps(rotation[6], sz), _mm256_mul_ps(rotation[7], sz), _mm256_mul_ps(rotation[8], sz), zero,
+			  tx, ty, tz, one },
+		};
+
+		for (int half = 0; half < 2; half++)
+		{
+			StoreMatrices(scaled[half], matrices + i, half);
+			StoreMatrices(translationRotation[half], translationRotations + i, half);
+		}
+	}
+
+	_mm256_zeroupper();
+}
+
+void BuildMatrices(const float* const* components, size_t count, glm::mat4* matrices, glm::mat4* translationRotations)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Transform transform;
+		transform.SetTranslation(glm::vec3(components[0][i], components[1][i], components[2][i]));
+		transform.SetRotation(glm::quat(components[6][i], components[3][i], components[4][i], components[5][i]));
+		transform.SetScale(glm::vec3(components[7][i], components[8][i], components[9][i]));
+
+		matrices[i] = transform.Get();
+		translationRotations[i] = transform.GetTranslationRotation();
+	}
+}
+
+} // namespace
+
+size_t TransformBatch::Add(const Transform& transform)
+{
+	if (size == components[0].size())
+	{
+		// Identity in the new lanes
+		for (int component = 0; component < NumberOfComponents; component++)
+		{
+			float identity = component == RotationW || component >= ScaleX ? 1.0f : 0.0f;
+			components[component].resize(size + WIDTH, identity);
+		}
+	}
+
+	const glm::vec3& translation = transform.GetTranslation();
+	const glm::quat& rotation = transform.GetRotation();
+	const glm::vec3& scale = transform.GetScale();
+
+	components[TranslationX][size] = translation.x;
+	components[TranslationY][size] = translation.y;
+	components[TranslationZ][size] = translation.z;
+	components[RotationX][size] = rotation.x;
+	components[RotationY][size] = rotation.y;
+	components[RotationZ][size] = rotation.z;
+	components[RotationW][size] = rotation.w;
+	components[ScaleX][size] = scale.x;
+	components[ScaleY][size] = scale.y;
+	components[ScaleZ][size] = scale.z;
+
+	return size++;
+}
+
+void TransformBatch::Build()
+{
+	size_t count = components[0].size();
+	matrices.resize(count);
+	translationRotations.resize(count);
+
+	const float* data[NumberOfComponents];
+	for (int component = 0; component < NumberOfComponents; component++)
+	{
+		data[component] = components[component].data();
+	}
+
+	// Whole blocks only, the padding lanes are there for that
+	size_t blocks = (size + WIDTH - 1) / WIDTH * WIDTH;
+
+	if (GetCpuFeatures().avx)
+	{
+		BuildMatricesAVX(data, blocks, matrices.data(), translationRotations.data());
+	}
+	else
+	{
+		BuildMatrices(data, size, matrices.data(), translationRotations.data());
+	}
+}
+
+} // namespace Hedge
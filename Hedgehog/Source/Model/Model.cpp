@@ -349,7 +349,6 @@ void Model::LoadDae(const std::string& filename)
 									segmentTransforms[keyFrame * 16 +  1], segmentTransforms[keyFrame * 16 +  5], segmentTransforms[keyFrame * 16 +  9], segmentTransforms[keyFrame * 16 + 13],
 									segmentTransforms[keyFrame * 16 +  2], segmentTransforms[keyFrame * 16 +  6], segmentTransforms[keyFrame * 16 + 10], segmentTransforms[keyFrame * 16 + 14],
 									segmentTransforms[keyFrame * 16 +  3], segmentTransforms[keyFrame * 16 +  7], segmentTransforms[keyFrame * 16 + 11], segmentTransforms[keyFrame * 16 + 15]);
-				segments[segmentID].first.keyTransforms.emplace_back(timeStamp, transform);
 
 				glm::vec3 scale;
 				glm::quat rotation;
@@ -829,20 +828,12 @@ void Model::CalculateCenters()
 
 		glm::vec3 center = min + ((max - min) / 2.0f);
 
-		// TODO This is just a temporary wokaround specifically for the sponza model
-		// Only the following three materials have alpha channels in their textures,
-		// so we want only those three  to be sorted by distance from the camera,
-		// the rest should be rendered before them
-		if (faces[group.startIndex].v[0].material == 3
-			|| faces[group.startIndex].v[0].material == 7
-			|| faces[group.startIndex].v[0].material == 20)
-		{
-			group.center = center;
-		}
-		else
-		{
-			group.center = center + 100000.0f;
-		}
+		group.bounds.min = min;
+		group.bounds.max = max;
+		group.center = center;
+
+		// Groups are split by material, the faces have the texture slot of theirs
+		group.textureSlot = faces[group.startIndex].v[0].material;
 	}
 }
 
@@ -53,6 +53,76 @@ IndexBuffer* IndexBuffer::Create(const unsigned int* indices, unsigned int count
 	}
 }
 
+StorageBuffer* StorageBuffer::Create(unsigned int size)
+{
+	switch (Renderer::GetAPI())
+	{
+	case RendererAPI::API::OpenGL:
+		return new OpenGLStorageBuffer(size);
+
+	// TODO DirectX12 needs its descriptor setup extended for storage buffers first
+	// Vulkan has the shared set for them, but the shaders read palettes and instances from their own constants so far
+	case RendererAPI::API::None:
+		return nullptr;
+
+	default:
+		return nullptr;
+	}
+}
+
+ConstantBuffer* ConstantBuffer::Create(unsigned int size)
+{
+	switch (Renderer::GetAPI())
+	{
+	case RendererAPI::API::OpenGL:
+		return new OpenGLConstantBuffer(size);
+
+	case RendererAPI::API::DirectX12:
+		return new DirectX12ConstantBuffer(size);
+
+	case RendererAPI::API::Vulkan:
+		return new VulkanConstantBuffer(size);
+
+	case RendererAPI::API::None:
+		return nullptr;
+
+	default:
+		return nullptr;
+	}
+}
+
+StreamBuffer::Allocation StreamBuffer::Allocate(unsigned int size)
+{
+	unsigned int offset = (used + alignment - 1) / alignment * alignment;
+	if (!mappedData
+		|| offset + size > regionSize)
+	{
+		failures++;
+		return Allocation();
+	}
+
+	used = offset + size;
+	allocations++;
+
+	Allocation allocation;
+	allocation.data = mappedData + regionOffset + offset;
+	allocation.offset = regionOffset + offset;
+	return allocation;
+}
+
+void StreamBuffer::BeginRegion(unsigned int region)
+{
+	usedBytes = used;
+	numberOfAllocations = allocations;
+	failedAllocations = failures;
+
+	regionOffset = region * regionSize;
+	used = 0;
+	allocations = 0;
+	failures = 0;
+	frame++;
+}
+
 BufferLayout BufferLayout::operator+(const BufferLayout& other) const
 {
 	BufferLayout result(*this);
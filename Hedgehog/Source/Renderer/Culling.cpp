@@ -0,0 +1,92 @@
+#include <Renderer/Culling.h>
+
+#include <immintrin.h>
+
+
+namespace Hedge
+{
+
+FrustumPlanes::FrustumPlanes()
+{
+	for (int plane = 0; plane < 8; plane++)
+	{
+		SetPlane(plane, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+}
+
+void FrustumPlanes::SetPlane(int plane, const glm::vec4& value)
+{
+	x[plane] = value.x;
+	y[plane] = value.y;
+	z[plane] = value.z;
+	w[plane] = value.w;
+}
+
+glm::vec4 FrustumPlanes::GetPlane(int plane) const
+{
+	return glm::vec4(x[plane], y[plane], z[plane], w[plane]);
+}
+
+FrustumPlanes FrustumPlanes::Create(const glm::mat4& projectionView)
+{
+	// Gribb & Hartmann, the planes are sums and differences of the matrix rows
+	glm::mat4 rows = glm::transpose(projectionView);
+
+	FrustumPlanes planes;
+	planes.SetPlane(0, rows[3] + rows[0]); // left
+	planes.SetPlane(1, rows[3] - rows[0]); // right
+	planes.SetPlane(2, rows[3] + rows[1]); // bottom
+	planes.SetPlane(3, rows[3] - rows[1]); // top
+	planes.SetPlane(4, rows[3] + rows[2]); // near
+	planes.SetPlane(5, rows[3] - rows[2]); // far
+
+	return planes;
+}
+
+FrustumPlanes FrustumPlanes::Transform(const glm::mat4& transform) const
+{
+	// dot(plane, transform * p) == dot(plane * transform, p)
+	FrustumPlanes planes;
+	for (int plane = 0; plane < NUMBER_OF_PLANES; plane++)
+	{
+		planes.SetPlane(plane, GetPlane(plane) * transform);
+	}
+
+	return planes;
+}
+
+bool FrustumPlanes::Intersects(const BoundingBox& box) const
+{
+	if (!box.IsValid())
+	{
+		return true;
+	}
+
+	glm::vec3 center = box.GetCenter();
+	glm::vec3 extent = box.GetExtent();
+
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+	const __m128 ex = _mm_set1_ps(extent.x), ey = _mm_set1_ps(extent.y), ez = _mm_set1_ps(extent.z);
+
+	int outside = 0;
+	for (int i = 0; i < 8; i += 4)
+	{
+		__m128 nx = _mm_load_ps(x + i);
+		__m128 ny = _mm_load_ps(y + i);
+		__m128 nz = _mm_load_ps(z + i);
+
+		// Distance of the center and how far the box reaches towards the plane
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+									 _mm_add_ps(_mm_mul_ps(nz, cz), _mm_load_ps(w + i)));
+		__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+											  _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+								   _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+
+		outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+	}
+
+	return outside == 0;
+}
+
+} // namespace Hedge
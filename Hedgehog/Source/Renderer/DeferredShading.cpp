@@ -0,0 +1,124 @@
+#include <Renderer/DeferredShading.h>
+
+#include <Application/Application.h>
+#include <Renderer/Renderer.h>
+
+#include <imgui.h>
+
+
+namespace Hedge
+{
+
+bool DeferredShading::IsSupported() const
+{
+	return RenderCommand::SupportsRenderTargets();
+}
+
+bool DeferredShading::IsActive() const
+{
+	return enabled
+		&& IsSupported();
+}
+
+void DeferredShading::BeginGeometryPass()
+{
+	// Window sized, the viewport is the same as for drawing into the window directly
+	auto& window = Application::GetInstance().GetWindow();
+	if (!gBuffer
+		|| gBuffer->GetDescription().width != window.GetWidth()
+		|| gBuffer->GetDescription().height != window.GetHeight())
+	{
+		RenderTargetDescription description;
+		description.width = window.GetWidth();
+		description.height = window.GetHeight();
+		description.colorFormats = { RenderTargetFormat::RGBA8, RenderTargetFormat::RGBA16F, RenderTargetFormat::RGBA32F };
+		description.depth = true;
+		gBuffer.reset(RenderTarget::Create(description));
+	}
+
+	if (!lightingVertexArray)
+	{
+		CreateLightingVertexArray();
+	}
+
+	gBuffer->Bind();
+	gBuffer->Clear(glm::vec4(0.0f));
+
+	geometryDraws = 0;
+	forwardDraws = 0;
+}
+
+void DeferredShading::EndGeometryPass()
+{
+	gBuffer->Unbind();
+
+	// One triangle over the viewport, nothing to test it against until the depth is copied over
+	bool depthTest = RenderCommand::GetDepthTest();
+	bool faceCulling = RenderCommand::GetFaceCulling();
+	RenderCommand::SetDepthTest(false);
+	RenderCommand::SetFaceCulling(false);
+
+	gBuffer->BindColorTexture(Albedo, Albedo);
+	gBuffer->BindColorTexture(Normal, Normal);
+	gBuffer->BindColorTexture(Position, Position);
+
+	lightingVertexArray->Bind();
+	RenderCommand::DrawIndexed(lightingVertexArray);
+	lightingVertexArray->Unbind();
+
+	RenderCommand::SetDepthTest(depthTest);
+	RenderCommand::SetFaceCulling(faceCulling);
+
+	gBuffer->CopyDepthToWindow();
+}
+
+void DeferredShading::CreateLightingVertexArray()
+{
+	// Only OpenGL has render targets so far
+	std::string vertexSrc = "..\\Hedgehog\\Asset\\Shader\\OpenGLDeferredLightingVertexShader.glsl";
+	std::string pixelSrc = "..\\Hedgehog\\Asset\\Shader\\OpenGLDeferredLightingPixelShader.glsl";
+
+	auto shader = std::shared_ptr<Shader>(Shader::Create(vertexSrc, pixelSrc, ""));
+	lightingVertexArray.reset(VertexArray::Create(shader, PrimitiveTopology::Triangle, {}, {}));
+
+	BufferLayout bufferLayout =
+	{
+		{ ShaderDataType::Float2, "a_position" },
+	};
+
+	// Big enough to cover the viewport after clipping
+	float vertices[] =
+	{
+		-1.0f, -1.0f,
+		 3.0f, -1.0f,
+		-1.0f,  3.0f,
+	};
+	auto vertexBuffer = std::shared_ptr<VertexBuffer>(VertexBuffer::Create(bufferLayout, vertices, sizeof(vertices)));
+	lightingVertexArray->AddVertexBuffer(vertexBuffer);
+
+	unsigned int indices[] = { 0, 1, 2 };
+	auto indexBuffer = std::shared_ptr<IndexBuffer>(IndexBuffer::Create(indices, 3));
+	lightingVertexArray->AddIndexBuffer(indexBuffer);
+}
+
+void DeferredShading::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	if (!IsSupported())
+	{
+		ImGui::Text("Deferred shading needs render targets, everything is drawn forward");
+		ImGui::PopID();
+		return;
+	}
+
+	ImGui::Checkbox("Deferred Shading", &enabled);
+	if (enabled)
+	{
+		ImGui::Text("Draws: %u into the G-buffer, %u forward", geometryDraws, forwardDraws);
+	}
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
@@ -125,4 +125,65 @@ void DirectX12IndexBuffer::Bind() const
 	dx12context->g_pd3dCommandList->IASetIndexBuffer(&indexBufferView);
 }
 
+
+DirectX12ConstantBuffer::DirectX12ConstantBuffer(unsigned int size)
+	: size(size)
+{
+	DirectX12Context* dx12context = dynamic_cast<DirectX12Context*>(Application::GetInstance().GetRenderContext());
+	assert(dx12context);
+
+	// CB size is required to be 256-byte aligned
+	sliceSize = (size + 255) & ~255;
+
+	CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
+	auto desc = CD3DX12_RESOURCE_DESC::Buffer(sliceSize * DirectX12Context::NUM_FRAMES_IN_FLIGHT);
+	dx12context->g_pd3dDevice->CreateCommittedResource(
+		&heapProps,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&buffer)); // TODO handle fail
+
+	// Kept mapped for the life of the buffer, the CPU never reads it
+	CD3DX12_RANGE readRange(0, 0);
+	buffer->Map(0, &readRange, reinterpret_cast<void**>(&mappedData));
+}
+
+DirectX12ConstantBuffer::~DirectX12ConstantBuffer()
+{
+	DirectX12Context* dx12context = dynamic_cast<DirectX12Context*>(Application::GetInstance().GetRenderContext());
+
+	D3D12_GPU_VIRTUAL_ADDRESS start = buffer->GetGPUVirtualAddress();
+	if (dx12context->sharedConstantsAddress >= start
+		&& dx12context->sharedConstantsAddress < start + sliceSize * DirectX12Context::NUM_FRAMES_IN_FLIGHT)
+	{
+		dx12context->sharedConstantsAddress = 0;
+	}
+
+	buffer->Unmap(0, nullptr);
+}
+
+void DirectX12ConstantBuffer::Bind(unsigned int binding) const
+{
+	// TODO more shared constant buffers need more root parameters
+	assert(binding == 0);
+
+	DirectX12Context* dx12context = dynamic_cast<DirectX12Context*>(Application::GetInstance().GetRenderContext());
+	int frameIndex = (dx12context->g_frameIndex % dx12context->NUM_FRAMES_IN_FLIGHT);
+
+	// Takes effect when the next vertex array is bound
+	dx12context->sharedConstantsAddress = buffer->GetGPUVirtualAddress() + sliceSize * frameIndex;
+}
+
+void DirectX12ConstantBuffer::SetData(const void* data, unsigned int size)
+{
+	assert(size == this->size);
+
+	DirectX12Context* dx12context = dynamic_cast<DirectX12Context*>(Application::GetInstance().GetRenderContext());
+	int frameIndex = (dx12context->g_frameIndex % dx12context->NUM_FRAMES_IN_FLIGHT);
+
+	memcpy(mappedData + sliceSize * frameIndex, data, size);
+}
+
 } // namespace Hedge
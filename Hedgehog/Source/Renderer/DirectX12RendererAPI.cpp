@@ -131,11 +131,12 @@ void DirectX12RendererAPI::EndFrame()
 
 void DirectX12RendererAPI::DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray,
 									   unsigned int count,
-									   unsigned int offset)
+									   unsigned int offset,
+									   unsigned int instanceCount)
 {
 	// TODO experiment with SV_InstanceID
 	renderContext->g_pd3dCommandList->DrawIndexedInstanced(count > 0 ? count * 3 : vertexArray->GetIndexBuffer()->GetCount(),
-														   vertexArray->GetInstanceCount(),
+														   instanceCount > 0 ? instanceCount : vertexArray->GetInstanceCount(),
 														   offset * 3,
 														   0,
 														   0);
@@ -187,6 +187,9 @@ void DirectX12Shader::Bind()
 	//// The pipeline will use the number of descriptors from the (offseted) heap acording to the root signature
 	//dx12context->g_pd3dCommandList->SetGraphicsRootDescriptorTable(0, gpuHandle);
 
+	// Constants of a recorded draw
+	long long int slot = selectedSlot != -1 ? selectedSlot : objectNum;
+
 	// TODO assert we're not going outside of allocated buffer
 	for (auto const& [key, constBuffer] : constantBuffers)
 	{
@@ -200,10 +203,16 @@ void DirectX12Shader::Bind()
 		else
 		{
 			dx12context->g_pd3dCommandList->SetGraphicsRootConstantBufferView(constBuffer.rootParamIndex,
-																			  constBuffer.buffer[frameIndex]->GetGPUVirtualAddress() + objectNum * constBuffer.totalSize);
+																			  constBuffer.buffer[frameIndex]->GetGPUVirtualAddress() + slot * constBuffer.totalSize);
 		}
 	}
 
+	if (selectedSlot != -1)
+	{
+		selectedSlot = -1;
+		return;
+	}
+
 	objectNum++;
 }
 
@@ -212,6 +221,11 @@ void DirectX12Shader::Unbind()
 	objectNum = 0;
 }
 
+unsigned int DirectX12Shader::CommitConstants()
+{
+	return static_cast<unsigned int>(objectNum++);
+}
+
 void DirectX12Shader::SetupConstantBuffers(ConstantBufferDescription constBufferDesc)
 {
 	// Setup should be called only once
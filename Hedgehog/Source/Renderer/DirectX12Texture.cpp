@@ -21,6 +21,9 @@ DirectX12Texture2D::DirectX12Texture2D(const std::string& filename)
 
 	this->width = width;
 	this->height = height;
+	// Always expanded to four channels, the added alpha is opaque
+	translucent = (channels == STBI_grey_alpha || channels == STBI_rgb_alpha)
+		&& HasTranslucentTexels(data, width, height, STBI_rgb_alpha);
 
 	DirectX12Context* dx12context = dynamic_cast<DirectX12Context*>(Application::GetInstance().GetRenderContext());
 
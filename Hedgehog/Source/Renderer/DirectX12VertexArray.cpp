@@ -3,6 +3,7 @@
 #include <Application/Application.h>
 #include <Renderer/DirectX12Context.h>
 #include <Renderer/DirectX12Texture.h>
+#include <Renderer/FrameConstants.h>
 
 #include <vector>
 
@@ -62,6 +63,12 @@ DirectX12VertexArray::DirectX12VertexArray(const std::shared_ptr<Shader>& inputS
 		CreateSRVHeap();
 	}
 
+	// Shared constants go last, shaders that don't read them just leave the register unused
+	sharedConstantsRootParamIndex = (unsigned int)rootParameters.size();
+	CD3DX12_ROOT_PARAMETER sharedConstantsParam;
+	sharedConstantsParam.InitAsConstantBufferView(FrameConstants::BINDING, DirectX12Context::SHARED_CONSTANTS_SPACE, D3D12_SHADER_VISIBILITY_ALL);
+	rootParameters.push_back(sharedConstantsParam);
+
 	D3D12_ROOT_SIGNATURE_FLAGS rootSignatureFlags =
 		D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT | // Only the input assembler stage needs access to the constant buffer.
 		D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
@@ -97,6 +104,11 @@ void DirectX12VertexArray::Bind()
 	dx12context->g_pd3dCommandList->SetPipelineState(m_pipelineState[currentPSO].Get());
 	dx12context->g_pd3dCommandList->SetGraphicsRootSignature(m_rootSignature.Get());
 
+	if (dx12context->sharedConstantsAddress != 0)
+	{
+		dx12context->g_pd3dCommandList->SetGraphicsRootConstantBufferView(sharedConstantsRootParamIndex, dx12context->sharedConstantsAddress);
+	}
+
 	if (!textures.empty())
 	{
 		ID3D12DescriptorHeap* ppHeaps[] = { srvHeap.Get() };
@@ -194,10 +206,12 @@ void DirectX12VertexArray::CreatePSO()
 	auto depthStencilDesc = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
 	depthStencilDesc.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
 	depthStencilDesc.DepthEnable = RenderCommand::GetDepthTest();
+	depthStencilDesc.DepthWriteMask = RenderCommand::GetDepthWrite() ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
 	// TODO what IS a stencil ?
 
 	auto blendDesc = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
 	blendDesc.RenderTarget[0].BlendEnable = RenderCommand::GetBlending();
+	blendDesc.RenderTarget[0].RenderTargetWriteMask = RenderCommand::GetColorWrite() ? D3D12_COLOR_WRITE_ENABLE_ALL : 0;
 	blendDesc.RenderTarget[0].LogicOpEnable = false;
 	blendDesc.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
 	blendDesc.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
@@ -0,0 +1,70 @@
+#include <Renderer/Geometry.h>
+
+#include <Renderer/RendererAPI.h>
+
+
+namespace Hedge
+{
+
+// Positions packed one after another so the depth pre-pass fetches only those, all of the geometries share the one shader
+static std::shared_ptr<VertexArray> CreateDepthVertexArray(const std::vector<float>& positions,
+														   const std::shared_ptr<IndexBuffer>& indexBuffer,
+														   PrimitiveTopology primitiveTopology)
+{
+	static std::shared_ptr<Shader> depthShader;
+	if (!depthShader)
+	{
+		depthShader.reset(Shader::Create("..\\Hedgehog\\Asset\\Shader\\OpenGLDepthPrePassVertexShader.glsl",
+										 "..\\Hedgehog\\Asset\\Shader\\OpenGLDepthPrePassPixelShader.glsl"));
+	}
+
+	auto depthVertexArray = std::shared_ptr<VertexArray>(VertexArray::Create(depthShader, primitiveTopology, {}, {}));
+
+	BufferLayout bufferLayout =
+	{
+		{ ShaderDataType::Float3, "a_position" },
+	};
+	auto vertexBuffer = std::shared_ptr<VertexBuffer>(VertexBuffer::Create(bufferLayout, positions.data(), (unsigned int)(positions.size() * sizeof(float))));
+	depthVertexArray->AddVertexBuffer(vertexBuffer);
+	depthVertexArray->AddIndexBuffer(indexBuffer);
+
+	return depthVertexArray;
+}
+
+Geometry* Geometry::Create(const float* vertices, unsigned int sizeOfVertices,
+						   const unsigned int* indices, unsigned int numberOfIndices,
+						   PrimitiveTopology primitiveTopology, BufferLayout bufferLayout,
+						   const std::vector<VertexGroup>& groups)
+{
+	Geometry* geometry = new Geometry();
+	geometry->primitiveTopology = primitiveTopology;
+	geometry->groups = groups;
+
+	geometry->vertexBuffer.reset(VertexBuffer::Create(bufferLayout, vertices, sizeOfVertices));
+	geometry->indexBuffer.reset(IndexBuffer::Create(indices, numberOfIndices));
+
+	for (auto& element : bufferLayout)
+	{
+		if (element.name == "a_position"
+			&& element.type == ShaderDataType::Float3)
+		{
+			std::vector<float> positions;
+			unsigned int stride = bufferLayout.GetStride() / sizeof(float);
+			for (size_t vertex = element.offset / sizeof(float); vertex < sizeOfVertices / sizeof(float); vertex += stride)
+			{
+				geometry->bounds.Add(glm::vec3(vertices[vertex + 0], vertices[vertex + 1], vertices[vertex + 2]));
+				positions.insert(positions.end(), vertices + vertex, vertices + vertex + 3);
+			}
+
+			// Only OpenGL has the depth shader so far
+			if (RendererAPI::GetAPI() == RendererAPI::API::OpenGL)
+			{
+				geometry->depthVertexArray = CreateDepthVertexArray(positions, geometry->indexBuffer, primitiveTopology);
+			}
+		}
+	}
+
+	return geometry;
+}
+
+} // namespace Hedge
@@ -0,0 +1,319 @@
+#include <Renderer/LightClusters.h>
+
+#include <Renderer/RenderCommand.h>
+#include <Utilities/JobSystem.h>
+#include <Utilities/Stopwatch.h>
+
+#include <imgui.h>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+namespace Hedge
+{
+
+static constexpr unsigned int MIN_BUFFER_SIZE = 4096; // bytes
+
+// Streamed if there is room, the storage buffers are only used if there isn't
+// Storage buffers can't be resized, they are replaced by one twice as big when the data doesn't fit
+static void Write(std::unique_ptr<StorageBuffer>& buffer, const void* data, unsigned int size, unsigned int binding)
+{
+	auto streamBuffer = RenderCommand::GetStreamBuffer();
+	StreamBuffer::Allocation allocation = streamBuffer && size > 0 ? streamBuffer->Allocate(size) : StreamBuffer::Allocation();
+	if (allocation.data)
+	{
+		memcpy(allocation.data, data, size);
+		streamBuffer->BindStorage(binding, allocation.offset, size);
+		return;
+	}
+
+	if (!buffer
+		|| buffer->GetSize() < size)
+	{
+		unsigned int capacity = buffer ? buffer->GetSize() : MIN_BUFFER_SIZE;
+		while (capacity < size)
+		{
+			capacity *= 2;
+		}
+		buffer.reset(StorageBuffer::Create(capacity));
+	}
+
+	if (size > 0)
+	{
+		buffer->SetData(data, size);
+	}
+	buffer->Bind(binding, 0, buffer->GetSize());
+}
+
+void LightClusters::LightBounds::Clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	radius.clear();
+}
+
+void LightClusters::LightBounds::Add(const glm::vec3& center, float radius)
+{
+	x.push_back(center.x);
+	y.push_back(center.y);
+	z.push_back(center.z);
+	this->radius.push_back(radius);
+}
+
+bool LightClusters::IsSupported()
+{
+	if (!lightBuffer
+		&& supported)
+	{
+		lightBuffer.reset(StorageBuffer::Create(MIN_BUFFER_SIZE));
+		supported = lightBuffer != nullptr;
+	}
+
+	return supported;
+}
+
+bool LightClusters::IsActive(const Camera& camera)
+{
+	// The slices need the depth to grow along the view direction, orthographic and custom projections go without
+	return enabled
+		&& camera.GetType() == CameraType::Perspective
+		&& IsSupported();
+}
+
+void LightClusters::Begin(const Camera& camera, const glm::mat4& view)
+{
+	frustum = camera.GetFrustum();
+	this->view = view;
+
+	float logDepthRange = std::log(frustum.farClip / frustum.nearClip);
+	depthScale = SIZE_Z / logDepthRange;
+	depthBias = -std::log(frustum.nearClip) * SIZE_Z / logDepthRange;
+
+	lights.clear();
+	bounds.Clear();
+}
+
+float LightClusters::GetRange(const glm::vec3& color, const glm::vec3& attenuation) const
+{
+	// Distance where color / (constant + linear * d + quadratic * d^2) drops to the threshold
+	float brightness = std::max({ color.x, color.y, color.z }) / threshold;
+	float constant = attenuation.x - brightness;
+	if (constant >= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (attenuation.z > 0.0f)
+	{
+		return (-attenuation.y + std::sqrt(attenuation.y * attenuation.y - 4.0f * attenuation.z * constant)) / (2.0f * attenuation.z);
+	}
+
+	if (attenuation.y > 0.0f)
+	{
+		return -constant / attenuation.y;
+	}
+
+	// Never gets dim enough, every cluster has it
+	return std::numeric_limits<float>::infinity();
+}
+
+void LightClusters::Add(const ClusterLight& light)
+{
+	if (light.range <= 0.0f)
+	{
+		return;
+	}
+
+	lights.push_back(light);
+	bounds.Add(glm::vec3(view * glm::vec4(light.position, 1.0f)), light.range);
+}
+
+void LightClusters::AddPointLight(const PointLight& light)
+{
+	ClusterLight clusterLight;
+	clusterLight.position = light.position;
+	clusterLight.range = GetRange(light.color, light.attenuation);
+	clusterLight.color = light.color;
+	clusterLight.spot = 0.0f;
+	clusterLight.attenuation = light.attenuation;
+	clusterLight.cosInner = 0.0f;
+	clusterLight.direction = glm::vec3(0.0f);
+	clusterLight.cosOuter = 0.0f;
+	Add(clusterLight);
+}
+
+void LightClusters::AddSpotLight(const SpotLight& light)
+{
+	// Bound by the sphere of its range like a point light, the cone only matters for the shading
+	ClusterLight clusterLight;
+	clusterLight.position = light.position;
+	clusterLight.range = GetRange(light.color, light.attenuation);
+	clusterLight.color = light.color;
+	clusterLight.spot = 1.0f;
+	clusterLight.attenuation = light.attenuation;
+	clusterLight.cosInner = light.cutoffAngle.x;
+	clusterLight.direction = light.direction;
+	clusterLight.cosOuter = light.cutoffAngle.y;
+	Add(clusterLight);
+}
+
+void LightClusters::BuildSlice(unsigned int slice)
+{
+	Slice& sliceData = slices[slice];
+	sliceData.candidates.clear();
+	sliceData.candidateBounds.Clear();
+	sliceData.indices.clear();
+
+	// View space looks down -z, depth is the distance along it
+	float sliceNear = frustum.nearClip * std::pow(frustum.farClip / frustum.nearClip, (float)slice / SIZE_Z);
+	float sliceFar = frustum.nearClip * std::pow(frustum.farClip / frustum.nearClip, (float)(slice + 1) / SIZE_Z);
+
+	for (uint32_t light = 0; light < (uint32_t)lights.size(); light++)
+	{
+		float depth = -bounds.z[light];
+		if (depth - bounds.radius[light] <= sliceFar
+			&& depth + bounds.radius[light] >= sliceNear)
+		{
+			sliceData.candidates.push_back(light);
+			sliceData.candidateBounds.Add(glm::vec3(bounds.x[light], bounds.y[light], bounds.z[light]), bounds.radius[light]);
+		}
+	}
+
+	unsigned int numberOfCandidates = (unsigned int)sliceData.candidates.size();
+	LightBounds& candidates = sliceData.candidateBounds;
+	while (candidates.x.size() % 4 != 0)
+	{
+		candidates.Add(glm::vec3(0.0f), 0.0f);
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 minZ = _mm_set1_ps(-sliceFar);
+	const __m128 maxZ = _mm_set1_ps(-sliceNear);
+
+	for (unsigned int y = 0; y < SIZE_Y; y++)
+	{
+		// Edges of the tile on the near plane, scaled out to the depths of the slice
+		float bottom = frustum.nearBottom + (frustum.nearTop - frustum.nearBottom) * y / SIZE_Y;
+		float top = frustum.nearBottom + (frustum.nearTop - frustum.nearBottom) * (y + 1) / SIZE_Y;
+		__m128 minY = _mm_set1_ps(std::min(bottom * sliceNear, bottom * sliceFar) / frustum.nearClip);
+		__m128 maxY = _mm_set1_ps(std::max(top * sliceNear, top * sliceFar) / frustum.nearClip);
+
+		for (unsigned int x = 0; x < SIZE_X; x++)
+		{
+			float left = frustum.nearLeft + (frustum.nearRight - frustum.nearLeft) * x / SIZE_X;
+			float right = frustum.nearLeft + (frustum.nearRight - frustum.nearLeft) * (x + 1) / SIZE_X;
+			__m128 minX = _mm_set1_ps(std::min(left * sliceNear, left * sliceFar) / frustum.nearClip);
+			__m128 maxX = _mm_set1_ps(std::max(right * sliceNear, right * sliceFar) / frustum.nearClip);
+
+			Cluster& cluster = clusters[(slice * SIZE_Y + y) * SIZE_X + x];
+			cluster.offset = (uint32_t)sliceData.indices.size();
+
+			// Sphere against the box of the cluster, squared distance from the center to the closest point of the box
+			for (unsigned int light = 0; light < numberOfCandidates; light += 4)
+			{
+				__m128 centerX = _mm_loadu_ps(&candidates.x[light]);
+				__m128 centerY = _mm_loadu_ps(&candidates.y[light]);
+				__m128 centerZ = _mm_loadu_ps(&candidates.z[light]);
+				__m128 radius = _mm_loadu_ps(&candidates.radius[light]);
+
+				__m128 distanceX = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, centerX), _mm_sub_ps(centerX, maxX)), zero);
+				__m128 distanceY = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, centerY), _mm_sub_ps(centerY, maxY)), zero);
+				__m128 distanceZ = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, centerZ), _mm_sub_ps(centerZ, maxZ)), zero);
+				__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(distanceX, distanceX),
+															   _mm_mul_ps(distanceY, distanceY)),
+													_mm_mul_ps(distanceZ, distanceZ));
+
+				// Lanes past the candidates are padding
+				int intersects = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_mul_ps(radius, radius)));
+				intersects &= (1 << std::min(numberOfCandidates - light, 4u)) - 1;
+
+				for (unsigned int lane = 0; lane < 4; lane++)
+				{
+					if (intersects & (1 << lane))
+					{
+						sliceData.indices.push_back(sliceData.candidates[light + lane]);
+					}
+				}
+			}
+
+			cluster.count = (uint32_t)sliceData.indices.size() - cluster.offset;
+		}
+	}
+}
+
+void LightClusters::Build(FrameConstants& frameConstants)
+{
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	clusters.resize(NUMBER_OF_CLUSTERS);
+
+	// Slices only write their own clusters and lists
+	JobSystem::Get().ParallelFor(SIZE_Z, 1, [this](size_t begin, size_t end)
+	{
+		for (size_t slice = begin; slice < end; slice++)
+		{
+			BuildSlice((unsigned int)slice);
+		}
+	});
+
+	indices.clear();
+	maxLightsPerCluster = 0;
+	for (unsigned int slice = 0; slice < SIZE_Z; slice++)
+	{
+		uint32_t sliceOffset = (uint32_t)indices.size();
+		for (unsigned int cluster = slice * SIZE_X * SIZE_Y; cluster < (slice + 1) * SIZE_X * SIZE_Y; cluster++)
+		{
+			clusters[cluster].offset += sliceOffset;
+			maxLightsPerCluster = std::max(maxLightsPerCluster, clusters[cluster].count);
+		}
+		indices.insert(indices.end(), slices[slice].indices.begin(), slices[slice].indices.end());
+	}
+
+	numberOfLights = (unsigned int)lights.size();
+	numberOfIndices = (unsigned int)indices.size();
+
+	Upload();
+
+	frameConstants.clusterSize = glm::uvec4(SIZE_X, SIZE_Y, SIZE_Z, 1);
+	frameConstants.clusterDepth = glm::vec4(depthScale, depthBias, 0.0f, 0.0f);
+
+	stopwatch.Stop();
+	buildDuration = stopwatch.GetDuration().count();
+}
+
+void LightClusters::Upload()
+{
+	Write(lightBuffer, lights.data(), (unsigned int)(lights.size() * sizeof(ClusterLight)), LIGHT_BINDING);
+	Write(clusterBuffer, clusters.data(), (unsigned int)(clusters.size() * sizeof(Cluster)), CLUSTER_BINDING);
+	Write(indexBuffer, indices.data(), (unsigned int)(indices.size() * sizeof(uint32_t)), INDEX_BINDING);
+}
+
+void LightClusters::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	if (!IsSupported())
+	{
+		ImGui::Text("Light clusters need storage buffers, the lights are uploaded as shader constants");
+		ImGui::PopID();
+		return;
+	}
+
+	ImGui::Checkbox("Clustered Lights", &enabled);
+	ImGui::SliderFloat("Light Threshold", &threshold, 1.0f / 1024.0f, 1.0f / 16.0f, "%.4f");
+
+	ImGui::Text("Clusters: %ux%ux%u, %u lights", SIZE_X, SIZE_Y, SIZE_Z, numberOfLights);
+	ImGui::Text("Light indices: %u, %.2f per cluster, %u max", numberOfIndices, (float)numberOfIndices / NUMBER_OF_CLUSTERS, maxLightsPerCluster);
+	ImGui::Text("Build: %.3f ms", buildDuration);
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
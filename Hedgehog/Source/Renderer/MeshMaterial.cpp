@@ -0,0 +1,30 @@
+#include <Renderer/MeshMaterial.h>
+
+#include <Renderer/ResourceCache.h>
+
+
+namespace Hedge
+{
+
+MeshMaterial* MeshMaterial::Create(const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
+								   ConstantBufferDescription constBufferDesc,
+								   const std::vector<TextureDescription>& textureDescriptions)
+{
+	MeshMaterial* material = new MeshMaterial();
+	material->textureDescriptions = textureDescriptions;
+
+	material->shader.reset(Shader::Create(VSfilename, PSfilename, GSfilename));
+	material->shader->SetupConstantBuffers(constBufferDesc);
+
+	for (auto& textureDesc : textureDescriptions)
+	{
+		if (!textureDesc.filename.empty())
+		{
+			material->textures.emplace_back(textureDesc.type, ResourceCache::GetTexture(textureDesc.filename));
+		}
+	}
+
+	return material;
+}
+
+} // namespace Hedge
@@ -0,0 +1,111 @@
+#include <Renderer/OcclusionBenchmark.h>
+
+#include <Renderer/OcclusionBuffer.h>
+#include <Utilities/Stopwatch.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+
+namespace Hedge
+{
+
+std::vector<OcclusionBenchmarkResult> RunOcclusionBenchmark(const std::vector<int>& occluderCounts,
+															int numberOfBoxes,
+															int numberOfFrames)
+{
+	// Camera at the origin looking down -z, occluders on a wall in between it and the boxes
+	const float wallDistance = 20.0f;
+	const float wallWidth = 24.0f;
+	const float wallHeight = 12.0f;
+
+	glm::mat4 projectionView = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+	std::vector<OcclusionBenchmarkResult> results;
+
+	printf("Occlusion buffer benchmark, %d boxes, %d frames\n", numberOfBoxes, numberOfFrames);
+	printf("%10s %10s %14s %10s %10s\n", "occluders", "triangles", "rasterize ms", "test ms", "occluded");
+
+	for (int numberOfOccluders : occluderCounts)
+	{
+		std::mt19937 random(42);
+
+		// Occluders get smaller as there are more of them, so the wall is about as covered each time
+		float occluderSize = std::sqrt(wallWidth * wallHeight / numberOfOccluders);
+		std::uniform_real_distribution<float> wallX(-wallWidth, wallWidth);
+		std::uniform_real_distribution<float> wallY(-wallHeight, wallHeight);
+
+		BoundingBox occluderBox;
+		occluderBox.min = glm::vec3(-occluderSize, -occluderSize, -0.1f);
+		occluderBox.max = glm::vec3(occluderSize, occluderSize, 0.1f);
+		Occluder occluder(occluderBox);
+
+		std::vector<glm::mat4> occluderTransforms(numberOfOccluders, glm::mat4(1.0f));
+		for (auto& transform : occluderTransforms)
+		{
+			transform[3] = glm::vec4(wallX(random), wallY(random), -wallDistance, 1.0f);
+		}
+
+		// Boxes behind the wall, spread over the part of the view it covers
+		std::uniform_real_distribution<float> depth(wallDistance * 1.5f, wallDistance * 4.0f);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		BoundingBox box;
+		box.min = glm::vec3(-0.25f);
+		box.max = glm::vec3(0.25f);
+
+		std::vector<glm::mat4> boxTransforms(numberOfBoxes, glm::mat4(1.0f));
+		for (auto& transform : boxTransforms)
+		{
+			float distance = depth(random);
+			float scale = distance / wallDistance;
+			transform[3] = glm::vec4(unit(random) * wallWidth * scale, unit(random) * wallHeight * scale, -distance, 1.0f);
+		}
+
+		OcclusionBuffer occlusionBuffer;
+
+		OcclusionBenchmarkResult result;
+		result.numberOfOccluders = numberOfOccluders;
+		result.numberOfBoxes = numberOfBoxes;
+
+		Stopwatch stopwatch;
+		for (int frame = 0; frame < numberOfFrames; frame++)
+		{
+			occlusionBuffer.Begin(projectionView);
+			for (const auto& transform : occluderTransforms)
+			{
+				occlusionBuffer.AddOccluder(occluder, transform);
+			}
+			occlusionBuffer.Rasterize();
+			result.rasterizeDuration += occlusionBuffer.rasterizeDuration;
+
+			result.numberOfOccluded = 0;
+			stopwatch.Start();
+			for (const auto& transform : boxTransforms)
+			{
+				result.numberOfOccluded += occlusionBuffer.IsVisible(box, transform) ? 0 : 1;
+			}
+			stopwatch.Stop();
+			result.testDuration += stopwatch.GetDuration().count();
+		}
+
+		result.numberOfTriangles = occlusionBuffer.numberOfTriangles;
+		result.rasterizeDuration /= numberOfFrames;
+		result.testDuration /= numberOfFrames;
+
+		printf("%10d %10d %14.3f %10.3f %9.1f%%\n",
+			   result.numberOfOccluders,
+			   result.numberOfTriangles,
+			   result.rasterizeDuration,
+			   result.testDuration,
+			   100.0f * result.numberOfOccluded / numberOfBoxes);
+
+		results.push_back(result);
+	}
+
+	return results;
+}
+
+} // namespace Hedge
@@ -0,0 +1,403 @@
+#include <Renderer/OcclusionBuffer.h>
+
+#include <Utilities/JobSystem.h>
+#include <Utilities/Stopwatch.h>
+
+#include <imgui.h>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace Hedge
+{
+
+// Triangles and boxes reaching closer than this to the camera plane aren't clipped,
+// the triangles are dropped and the boxes are visible
+static constexpr float MIN_W = 1e-3f;
+
+static constexpr size_t ROWS_PER_JOB = 8;
+
+Occluder::Occluder(const float* vertices, unsigned int sizeOfVertices,
+				   const unsigned int* indices, unsigned int numberOfIndices,
+				   const BufferLayout& bufferLayout)
+	: indices(indices, indices + numberOfIndices)
+{
+	for (auto& element : bufferLayout)
+	{
+		if (element.name == "a_position"
+			&& element.type == ShaderDataType::Float3)
+		{
+			unsigned int stride = bufferLayout.GetStride() / sizeof(float);
+			for (size_t vertex = element.offset / sizeof(float); vertex < sizeOfVertices / sizeof(float); vertex += stride)
+			{
+				positions.emplace_back(vertices[vertex + 0], vertices[vertex + 1], vertices[vertex + 2]);
+			}
+		}
+	}
+
+	assert(!positions.empty());
+}
+
+Occluder::Occluder(const BoundingBox& box)
+{
+	for (int corner = 0; corner < 8; corner++)
+	{
+		positions.emplace_back(corner & 1 ? box.max.x : box.min.x,
+							   corner & 2 ? box.max.y : box.min.y,
+							   corner & 4 ? box.max.z : box.min.z);
+	}
+
+	// Two triangles per side, the winding doesn't matter
+	indices =
+	{
+		0, 2, 1,  1, 2, 3, // -z
+		4, 5, 6,  5, 7, 6, // +z
+		0, 1, 4,  1, 5, 4, // -y
+		2, 6, 3,  3, 6, 7, // +y
+		0, 4, 2,  2, 4, 6, // -x
+		1, 3, 5,  3, 7, 5, // +x
+	};
+}
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+	: width(width)
+	, height(height)
+{
+	assert(width % 4 == 0);
+
+	int levelWidth = width;
+	int levelHeight = height;
+	for (int level = 0; level < NUMBER_OF_LEVELS; level++)
+	{
+		levels[level].resize((size_t)levelWidth * levelHeight, 0.0f);
+		levelWidth = (levelWidth + 1) / 2;
+		levelHeight = (levelHeight + 1) / 2;
+	}
+}
+
+void OcclusionBuffer::Begin(const glm::mat4& projectionView)
+{
+	this->projectionView = projectionView;
+
+	instances.clear();
+	std::fill(levels[0].begin(), levels[0].end(), 0.0f);
+	rasterized = false;
+}
+
+void OcclusionBuffer::AddOccluder(const Occluder& occluder, const glm::mat4& transform)
+{
+	OccluderInstance instance;
+	instance.occluder = &occluder;
+	instance.transform = transform;
+	instance.firstVertex = instances.empty() ? 0 : instances.back().firstVertex + instances.back().occluder->GetPositions().size();
+	instance.firstTriangle = instances.empty() ? 0 : instances.back().firstTriangle + instances.back().occluder->GetIndices().size() / 3;
+
+	instances.push_back(instance);
+}
+
+void OcclusionBuffer::Rasterize()
+{
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	numberOfOccluders = static_cast<int>(instances.size());
+	numberOfTriangles = 0;
+
+	if (!instances.empty())
+	{
+		const OccluderInstance& last = instances.back();
+		clipVertices.resize(last.firstVertex + last.occluder->GetPositions().size());
+		triangles.resize(last.firstTriangle + last.occluder->GetIndices().size() / 3);
+
+		// Each occluder writes its own range of the vertices and triangles
+		JobSystem::Get().ParallelFor(instances.size(), 1,
+			[this](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					SetupTriangles(instances[i]);
+				}
+			});
+
+		// Each band of rows goes through all the triangles, bands don't share any pixels
+		JobSystem::Get().ParallelFor(height, ROWS_PER_JOB,
+			[this](size_t begin, size_t end)
+			{
+				RasterizeRows((int)begin, (int)end);
+			});
+
+		numberOfTriangles = (int)std::count_if(triangles.begin(), triangles.end(), [](const Triangle& triangle) { return !triangle.IsEmpty(); });
+	}
+
+	BuildHierarchy();
+	rasterized = true;
+
+	stopwatch.Stop();
+	rasterizeDuration = stopwatch.GetDuration().count();
+}
+
+void OcclusionBuffer::SetupTriangles(const OccluderInstance& instance)
+{
+	const auto& positions = instance.occluder->GetPositions();
+	const auto& indices = instance.occluder->GetIndices();
+
+	glm::mat4 transform = projectionView * instance.transform;
+	glm::vec4* clip = &clipVertices[instance.firstVertex];
+	for (size_t vertex = 0; vertex < positions.size(); vertex++)
+	{
+		clip[vertex] = transform * glm::vec4(positions[vertex], 1.0f);
+	}
+
+	for (size_t i = 0; i < indices.size() / 3; i++)
+	{
+		Triangle& triangle = triangles[instance.firstTriangle + i];
+		triangle.minX = 0;
+		triangle.maxX = -1;
+
+		glm::vec3 screen[3];
+		float inverseW[3];
+		bool behind = false;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const glm::vec4& vertex = clip[indices[i * 3 + corner]];
+			behind = behind || vertex.w < MIN_W;
+
+			inverseW[corner] = 1.0f / vertex.w;
+			screen[corner] = glm::vec3((vertex.x * inverseW[corner] * 0.5f + 0.5f) * width,
+									   (vertex.y * inverseW[corner] * 0.5f + 0.5f) * height,
+									   0.0f);
+		}
+
+		if (behind)
+		{
+			continue;
+		}
+
+		float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y)
+			- (screen[1].y - screen[0].y) * (screen[2].x - screen[0].x);
+		if (std::abs(area) < 1e-6f)
+		{
+			continue;
+		}
+
+		// Both sides are rasterized, flip the back facing ones so the inside is always positive
+		if (area < 0.0f)
+		{
+			std::swap(screen[1], screen[2]);
+			std::swap(inverseW[1], inverseW[2]);
+			area = -area;
+		}
+
+		// Edge i is the one opposite of vertex i, 1 / w is affine in screen space so it interpolates barycentrically
+		triangle.depth = glm::vec3(0.0f);
+		for (int edge = 0; edge < 3; edge++)
+		{
+			const glm::vec3& a = screen[(edge + 1) % 3];
+			const glm::vec3& b = screen[(edge + 2) % 3];
+			triangle.edges[edge] = glm::vec3(a.y - b.y, b.x - a.x, (b.y - a.y) * a.x - (b.x - a.x) * a.y);
+			triangle.depth += triangle.edges[edge] * (inverseW[edge] / area);
+		}
+
+		float minX = std::min({ screen[0].x, screen[1].x, screen[2].x });
+		float maxX = std::max({ screen[0].x, screen[1].x, screen[2].x });
+		float minY = std::min({ screen[0].y, screen[1].y, screen[2].y });
+		float maxY = std::max({ screen[0].y, screen[1].y, screen[2].y });
+
+		triangle.minX = (int)std::max(std::floor(minX), 0.0f);
+		triangle.maxX = (int)std::min(std::floor(maxX), (float)(width - 1));
+		triangle.minY = (int)std::max(std::floor(minY), 0.0f);
+		triangle.maxY = (int)std::min(std::floor(maxY), (float)(height - 1));
+	}
+}
+
+void OcclusionBuffer::RasterizeRows(int firstRow, int endRow)
+{
+	const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	float* depth = levels[0].data();
+
+	for (const Triangle& triangle : triangles)
+	{
+		if (triangle.IsEmpty()
+			|| triangle.maxY < firstRow
+			|| triangle.minY >= endRow)
+		{
+			continue;
+		}
+
+		int startX = triangle.minX & ~3;
+		__m128 startPixelX = _mm_add_ps(_mm_set1_ps((float)startX), pixelOffsets);
+
+		__m128 edgeX[3];
+		__m128 edgeStep[3];
+		for (int edge = 0; edge < 3; edge++)
+		{
+			edgeX[edge] = _mm_mul_ps(_mm_set1_ps(triangle.edges[edge].x), startPixelX);
+			edgeStep[edge] = _mm_set1_ps(triangle.edges[edge].x * 4.0f);
+		}
+		__m128 depthX = _mm_mul_ps(_mm_set1_ps(triangle.depth.x), startPixelX);
+		__m128 depthStep = _mm_set1_ps(triangle.depth.x * 4.0f);
+
+		int rowBegin = std::max(triangle.minY, firstRow);
+		int rowEnd = std::min(triangle.maxY + 1, endRow);
+		for (int y = rowBegin; y < rowEnd; y++)
+		{
+			float pixelY = y + 0.5f;
+
+			__m128 edgeValue[3];
+			for (int edge = 0; edge < 3; edge++)
+			{
+				edgeValue[edge] = _mm_add_ps(edgeX[edge], _mm_set1_ps(triangle.edges[edge].y * pixelY + triangle.edges[edge].z));
+			}
+			__m128 depthValue = _mm_add_ps(depthX, _mm_set1_ps(triangle.depth.y * pixelY + triangle.depth.z));
+
+			float* row = depth + (size_t)y * width;
+			for (int x = startX; x <= triangle.maxX; x += 4)
+			{
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edgeValue[0], zero),
+													  _mm_cmpge_ps(edgeValue[1], zero)),
+										   _mm_cmpge_ps(edgeValue[2], zero));
+
+				if (_mm_movemask_ps(inside))
+				{
+					__m128 previous = _mm_loadu_ps(row + x);
+					__m128 closer = _mm_max_ps(previous, depthValue);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, previous)));
+				}
+
+				for (int edge = 0; edge < 3; edge++)
+				{
+					edgeValue[edge] = _mm_add_ps(edgeValue[edge], edgeStep[edge]);
+				}
+				depthValue = _mm_add_ps(depthValue, depthStep);
+			}
+		}
+	}
+}
+
+void OcclusionBuffer::BuildHierarchy()
+{
+	int previousWidth = width;
+	int previousHeight = height;
+	for (int level = 1; level < NUMBER_OF_LEVELS; level++)
+	{
+		const std::vector<float>& previous = levels[level - 1];
+		std::vector<float>& current = levels[level];
+		int levelWidth = (previousWidth + 1) / 2;
+		int levelHeight = (previousHeight + 1) / 2;
+
+		for (int y = 0; y < levelHeight; y++)
+		{
+			int y0 = y * 2;
+			int y1 = std::min(y0 + 1, previousHeight - 1);
+			for (int x = 0; x < levelWidth; x++)
+			{
+				int x0 = x * 2;
+				int x1 = std::min(x0 + 1, previousWidth - 1);
+				current[(size_t)y * levelWidth + x] = std::min({ previous[(size_t)y0 * previousWidth + x0],
+																 previous[(size_t)y0 * previousWidth + x1],
+																 previous[(size_t)y1 * previousWidth + x0],
+																 previous[(size_t)y1 * previousWidth + x1] });
+			}
+		}
+
+		previousWidth = levelWidth;
+		previousHeight = levelHeight;
+	}
+}
+
+bool OcclusionBuffer::IsVisible(const BoundingBox& bounds, const glm::mat4& transform) const
+{
+	if (!enabled
+		|| !rasterized
+		|| numberOfTriangles == 0
+		|| !bounds.IsValid())
+	{
+		return true;
+	}
+
+	glm::mat4 boxToClip = projectionView * transform;
+
+	float minX = std::numeric_limits<float>::max();
+	float maxX = -std::numeric_limits<float>::max();
+	float minY = std::numeric_limits<float>::max();
+	float maxY = -std::numeric_limits<float>::max();
+	float closest = 0.0f;
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec4 clip = boxToClip * glm::vec4(corner & 1 ? bounds.max.x : bounds.min.x,
+											   corner & 2 ? bounds.max.y : bounds.min.y,
+											   corner & 4 ? bounds.max.z : bounds.min.z,
+											   1.0f);
+		if (clip.w < MIN_W)
+		{
+			return true;
+		}
+
+		float inverseW = 1.0f / clip.w;
+		float x = (clip.x * inverseW * 0.5f + 0.5f) * width;
+		float y = (clip.y * inverseW * 0.5f + 0.5f) * height;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		closest = std::max(closest, inverseW);
+	}
+
+	int x0 = (int)std::max(std::floor(minX), 0.0f);
+	int x1 = (int)std::min(std::floor(maxX), (float)(width - 1));
+	int y0 = (int)std::max(std::floor(minY), 0.0f);
+	int y1 = (int)std::min(std::floor(maxY), (float)(height - 1));
+	if (x0 > x1
+		|| y0 > y1)
+	{
+		// Off screen, that's for the frustum to decide
+		return true;
+	}
+
+	// Coarsest level the box still covers only a couple of texels of
+	int level = 0;
+	while (level < NUMBER_OF_LEVELS - 1
+		   && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+	{
+		level++;
+	}
+
+	int levelWidth = width;
+	for (int i = 0; i < level; i++)
+	{
+		levelWidth = (levelWidth + 1) / 2;
+	}
+
+	const std::vector<float>& depth = levels[level];
+	for (int y = y0 >> level; y <= y1 >> level; y++)
+	{
+		for (int x = x0 >> level; x <= x1 >> level; x++)
+		{
+			// The farthest occluder under the texel isn't in front of the closest point of the box
+			if (depth[(size_t)y * levelWidth + x] <= closest)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void OcclusionBuffer::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	ImGui::Checkbox("Occlusion Culling", &enabled);
+	ImGui::Text("Occluders: %d, %d triangles at %dx%d", numberOfOccluders, numberOfTriangles, width, height);
+	ImGui::Text("Rasterized in %.3f ms", rasterizeDuration);
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
@@ -0,0 +1,290 @@
+#include <Renderer/OcclusionQueries.h>
+
+#include <Renderer/Renderer.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+
+
+namespace Hedge
+{
+
+// Corner i of a box has bit 0 of i set for max x, bit 1 for max y and bit 2 for max z
+static const unsigned int boxIndices[36] =
+{
+	0, 2, 6, 0, 6, 4, // -x
+	1, 5, 7, 1, 7, 3, // +x
+	0, 4, 5, 0, 5, 1, // -y
+	2, 3, 7, 2, 7, 6, // +y
+	0, 1, 3, 0, 3, 2, // -z
+	4, 6, 7, 4, 7, 5, // +z
+};
+
+void OcclusionQueries::BeginFrame(const glm::vec3& cameraPosition)
+{
+	this->cameraPosition = cameraPosition;
+	frame++;
+
+	issuedQueries = 0;
+	boxQueries = 0;
+	conditionalDraws = 0;
+	skippedGroups = 0;
+	droppedQueries = 0;
+	latencySum = 0;
+	numberOfResults = 0;
+	maxLatency = 0;
+}
+
+bool OcclusionQueries::IsActive() const
+{
+	return enabled
+		&& RenderCommand::SupportsOcclusionQueries();
+}
+
+void OcclusionQueries::ReadResult(OcclusionQueryState& state)
+{
+	// Whatever comes back after this long is about a different view, the group is drawn and tested again
+	if (frame - state.queryFrame > (unsigned int)maxQueryAge)
+	{
+		RenderCommand::DestroyOcclusionQuery(state.query);
+		state.query = -1;
+		state.occluded = false;
+		droppedQueries++;
+		return;
+	}
+
+	unsigned long long samples = 0;
+	if (RenderCommand::GetOcclusionQueryResult(state.query, samples))
+	{
+		unsigned int latency = frame - state.queryFrame;
+		latencySum += latency;
+		numberOfResults++;
+		maxLatency = std::max(maxLatency, latency);
+
+		RenderCommand::DestroyOcclusionQuery(state.query);
+		state.query = -1;
+		state.occluded = samples == 0;
+	}
+}
+
+bool OcclusionQueries::BeginGroup(const VertexGroup& group, OcclusionQueryState& state, const glm::mat4& transform)
+{
+	if (state.query != -1)
+	{
+		ReadResult(state);
+	}
+
+	// Just came into the frustum, whatever the last result was it is too old to go by
+	if (state.lastFrame + 1 != frame)
+	{
+		state.occluded = false;
+	}
+	state.lastFrame = frame;
+
+	// With the camera inside of the box its faces are clipped away and it would always look occluded
+	BoundingBox box = group.bounds.Transform(transform);
+	BoundingBox camera;
+	camera.Add(cameraPosition);
+	if (!box.IsValid()
+		|| box.Contains(camera))
+	{
+		state.occluded = false;
+		return true;
+	}
+
+	if (state.occluded)
+	{
+		if (state.query != -1)
+		{
+			// Drawn unless the GPU already knows the box is still hidden
+			if (conditionalRendering
+				&& RenderCommand::SupportsConditionalRendering())
+			{
+				RenderCommand::BeginConditionalRendering(state.query);
+				activeConditional = true;
+				conditionalDraws++;
+				return true;
+			}
+
+			skippedGroups++;
+			return false;
+		}
+
+		int query = boxQueryHandles.size() < MAX_BOXES ? RenderCommand::CreateOcclusionQuery() : -1;
+		if (query != -1)
+		{
+			state.query = query;
+			state.queryFrame = frame;
+
+			for (int corner = 0; corner < 8; corner++)
+			{
+				boxCorners.emplace_back(corner & 1 ? box.max.x : box.min.x,
+										corner & 2 ? box.max.y : box.min.y,
+										corner & 4 ? box.max.z : box.min.z);
+			}
+			boxQueryHandles.push_back(query);
+
+			skippedGroups++;
+			return false;
+		}
+
+		// Out of queries, nothing would tell when it shows up again
+		state.occluded = false;
+		return true;
+	}
+
+	// Spread the tests of the visible groups over the frames
+	if (state.query == -1
+		&& (frame + group.startIndex) % (unsigned int)std::max(retestInterval, 1) == 0)
+	{
+		int query = RenderCommand::CreateOcclusionQuery();
+		if (query != -1)
+		{
+			state.query = query;
+			state.queryFrame = frame;
+
+			RenderCommand::BeginOcclusionQuery(query);
+			activeQuery = query;
+			issuedQueries++;
+		}
+	}
+
+	return true;
+}
+
+void OcclusionQueries::EndGroup()
+{
+	if (activeQuery != -1)
+	{
+		RenderCommand::EndOcclusionQuery(activeQuery);
+		activeQuery = -1;
+	}
+
+	if (activeConditional)
+	{
+		RenderCommand::EndConditionalRendering();
+		activeConditional = false;
+	}
+}
+
+void OcclusionQueries::Flush(const glm::mat4& projectionView)
+{
+	averageLatency = numberOfResults > 0 ? (float)latencySum / numberOfResults : 0.0f;
+
+	if (boxQueryHandles.empty())
+	{
+		return;
+	}
+
+	// The boxes only go against the depth buffer, they must not show up in it or on the screen
+	bool depthWrite = RenderCommand::GetDepthWrite();
+	bool colorWrite = RenderCommand::GetColorWrite();
+	bool faceCulling = RenderCommand::GetFaceCulling();
+	RenderCommand::SetDepthWrite(false);
+	RenderCommand::SetColorWrite(false);
+	RenderCommand::SetFaceCulling(false);
+
+	// Vulkan bakes the state into the pipeline when the vertex array is created
+	if (!boxVertexArray)
+	{
+		CreateBoxVertexArray();
+	}
+
+	boxVertexBuffer->SetData(&boxCorners[0].x, (unsigned int)(boxCorners.size() * sizeof(glm::vec3)));
+	boxVertexArray->GetShader()->UploadConstant("u_projectionView", projectionView);
+
+	boxVertexArray->Bind();
+	for (unsigned int box = 0; box < boxQueryHandles.size(); box++)
+	{
+		RenderCommand::BeginOcclusionQuery(boxQueryHandles[box]);
+		RenderCommand::DrawIndexed(boxVertexArray, 12, box * 12);
+		RenderCommand::EndOcclusionQuery(boxQueryHandles[box]);
+	}
+	boxVertexArray->Unbind();
+
+	RenderCommand::SetDepthWrite(depthWrite);
+	RenderCommand::SetColorWrite(colorWrite);
+	RenderCommand::SetFaceCulling(faceCulling);
+
+	boxQueries = (unsigned int)boxQueryHandles.size();
+	issuedQueries += boxQueries;
+
+	boxCorners.clear();
+	boxQueryHandles.clear();
+}
+
+void OcclusionQueries::CreateBoxVertexArray()
+{
+	std::string vertexSrc;
+	std::string pixelSrc;
+	if (Renderer::GetAPI() == RendererAPI::API::OpenGL)
+	{
+		vertexSrc = "..\\Hedgehog\\Asset\\Shader\\OpenGLOcclusionBoxVertexShader.glsl";
+		pixelSrc = "..\\Hedgehog\\Asset\\Shader\\OpenGLOcclusionBoxPixelShader.glsl";
+	}
+	else if (Renderer::GetAPI() == RendererAPI::API::Vulkan)
+	{
+		vertexSrc = "..\\Hedgehog\\Asset\\Shader\\VulkanOcclusionBoxVertexShader.spv";
+		pixelSrc = "..\\Hedgehog\\Asset\\Shader\\VulkanOcclusionBoxPixelShader.spv";
+	}
+
+	ConstantBufferDescription constBufferDesc =
+	{
+		{ "u_projectionView", sizeof(glm::mat4), ConstantBufferUsage::Scene },
+	};
+
+	auto shader = std::shared_ptr<Shader>(Shader::Create(vertexSrc, pixelSrc, ""));
+	shader->SetupConstantBuffers(constBufferDesc);
+
+	boxVertexArray.reset(VertexArray::Create(shader, PrimitiveTopology::Triangle, {}, {}));
+
+	BufferLayout bufferLayout =
+	{
+		{ ShaderDataType::Float3, "a_position" },
+	};
+
+	// Sized for all of the boxes up front, the Vulkan buffers can't grow
+	std::vector<glm::vec3> corners(MAX_BOXES * 8, glm::vec3(0.0f));
+	boxVertexBuffer.reset(VertexBuffer::Create(bufferLayout, &corners[0].x, (unsigned int)(corners.size() * sizeof(glm::vec3))));
+	boxVertexArray->AddVertexBuffer(boxVertexBuffer);
+
+	std::vector<unsigned int> indices(MAX_BOXES * 36);
+	for (unsigned int box = 0; box < MAX_BOXES; box++)
+	{
+		for (int index = 0; index < 36; index++)
+		{
+			indices[box * 36 + index] = box * 8 + boxIndices[index];
+		}
+	}
+	auto indexBuffer = std::shared_ptr<IndexBuffer>(IndexBuffer::Create(indices.data(), (unsigned int)indices.size()));
+	boxVertexArray->AddIndexBuffer(indexBuffer);
+}
+
+void OcclusionQueries::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	if (!RenderCommand::SupportsOcclusionQueries())
+	{
+		ImGui::Text("Occlusion queries aren't supported by the renderer");
+		ImGui::PopID();
+		return;
+	}
+
+	ImGui::Checkbox("Occlusion Queries", &enabled);
+	if (RenderCommand::SupportsConditionalRendering())
+	{
+		ImGui::Checkbox("Conditional Rendering", &conditionalRendering);
+	}
+	ImGui::SliderInt("Retest Interval", &retestInterval, 1, 30);
+	ImGui::SliderInt("Max Query Age", &maxQueryAge, 1, 30);
+
+	ImGui::Text("Queries: %u, %u of them boxes", issuedQueries, boxQueries);
+	ImGui::Text("Skipped groups: %u, conditional draws: %u", skippedGroups, conditionalDraws);
+	ImGui::Text("Latency: %.2f frames average, %u max, %u dropped", averageLatency, maxLatency, droppedQueries);
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
@@ -1,7 +1,13 @@
 #include <Renderer/OpenGLBuffer.h>
 
+#include <Renderer/RenderCommand.h>
+
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
 
 namespace Hedge
 {
@@ -11,6 +17,7 @@ OpenGLVertexBuffer::OpenGLVertexBuffer(const BufferLayout& layout,
 									   unsigned int size)
 {
 	this->layout = layout;
+	capacity = size;
 
 	glCreateBuffers(1, &rendererID);
 	glBindBuffer(GL_ARRAY_BUFFER, rendererID);
@@ -35,8 +42,24 @@ void OpenGLVertexBuffer::Unbind() const
 
 void OpenGLVertexBuffer::SetData(const float* vertices, unsigned int size)
 {
+	// Written into the stream buffer and copied over by the GPU, in order with the draws and without a new store
+	auto streamBuffer = dynamic_cast<OpenGLStreamBuffer*>(RenderCommand::GetStreamBuffer());
+	if (streamBuffer
+		&& size <= capacity)
+	{
+		StreamBuffer::Allocation allocation = streamBuffer->Allocate(size);
+		if (allocation.data)
+		{
+			memcpy(allocation.data, vertices, size);
+			glCopyNamedBufferSubData(streamBuffer->GetRendererID(), rendererID, allocation.offset, 0, size);
+			return;
+		}
+	}
+
+	// Respecifying the whole store lets the driver orphan the old one
+	capacity = size;
 	glBindBuffer(GL_ARRAY_BUFFER, rendererID);
-	glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_DYNAMIC_DRAW);
 }
 
 
@@ -65,4 +88,142 @@ void OpenGLIndexBuffer::Unbind() const
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+
+OpenGLStorageBuffer::OpenGLStorageBuffer(unsigned int size)
+	: size(size)
+{
+	glCreateBuffers(1, &rendererID);
+	glNamedBufferData(rendererID, size, nullptr, GL_DYNAMIC_DRAW);
+
+	GLint alignment = 0;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (alignment > 0)
+	{
+		offsetAlignment = (unsigned int)alignment;
+	}
+}
+
+OpenGLStorageBuffer::~OpenGLStorageBuffer()
+{
+	glDeleteBuffers(1, &rendererID);
+}
+
+void OpenGLStorageBuffer::Bind(unsigned int binding, unsigned int offset, unsigned int size) const
+{
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, rendererID, offset, size);
+}
+
+void OpenGLStorageBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+	assert(offset + size <= this->size);
+	glNamedBufferSubData(rendererID, offset, size, data);
+}
+
+OpenGLConstantBuffer::OpenGLConstantBuffer(unsigned int size)
+	: size(size)
+{
+	glCreateBuffers(1, &rendererID);
+	glNamedBufferData(rendererID, size, nullptr, GL_DYNAMIC_DRAW);
+}
+
+OpenGLConstantBuffer::~OpenGLConstantBuffer()
+{
+	glDeleteBuffers(1, &rendererID);
+}
+
+void OpenGLConstantBuffer::Bind(unsigned int binding) const
+{
+	auto streamBuffer = RenderCommand::GetStreamBuffer();
+	if (streamed
+		&& streamBuffer
+		&& streamBuffer->GetFrame() == streamFrame)
+	{
+		streamBuffer->BindConstants(binding, streamOffset, size);
+		return;
+	}
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, rendererID);
+}
+
+void OpenGLConstantBuffer::SetData(const void* data, unsigned int size)
+{
+	assert(size == this->size);
+
+	auto streamBuffer = RenderCommand::GetStreamBuffer();
+	StreamBuffer::Allocation allocation = streamBuffer ? streamBuffer->Allocate(size) : StreamBuffer::Allocation();
+	streamed = allocation.data != nullptr;
+	if (streamed)
+	{
+		memcpy(allocation.data, data, size);
+		streamOffset = allocation.offset;
+		streamFrame = streamBuffer->GetFrame();
+		return;
+	}
+
+	// Orphans the storage of the last frame, the driver doesn't have to wait until it's no longer read
+	glNamedBufferData(rendererID, size, data, GL_DYNAMIC_DRAW);
+}
+
+
+OpenGLStreamBuffer::OpenGLStreamBuffer(unsigned int regionSize)
+{
+	// Allocations may be bound as either kind of buffer
+	GLint storageAlignment = 0;
+	GLint constantAlignment = 0;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &constantAlignment);
+	alignment = std::max({ 16u, (unsigned int)storageAlignment, (unsigned int)constantAlignment });
+	this->regionSize = (regionSize + alignment - 1) / alignment * alignment;
+
+	// Mapped once for the life of the buffer, coherent so the writes don't have to be flushed
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &rendererID);
+	glNamedBufferStorage(rendererID, (GLsizeiptr)this->regionSize * NUMBER_OF_REGIONS, nullptr, flags);
+	mappedData = (uint8_t*)glMapNamedBufferRange(rendererID, 0, (GLsizeiptr)this->regionSize * NUMBER_OF_REGIONS, flags);
+}
+
+OpenGLStreamBuffer::~OpenGLStreamBuffer()
+{
+	for (auto& fence : fences)
+	{
+		if (fence)
+		{
+			glDeleteSync(fence);
+		}
+	}
+
+	glUnmapNamedBuffer(rendererID);
+	glDeleteBuffers(1, &rendererID);
+}
+
+void OpenGLStreamBuffer::BeginFrame()
+{
+	region = (region + 1) % NUMBER_OF_REGIONS;
+
+	// Signaled long ago, unless the GPU is more frames behind than there are other regions
+	if (fences[region])
+	{
+		glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+		glDeleteSync(fences[region]);
+		fences[region] = nullptr;
+	}
+
+	BeginRegion(region);
+}
+
+void OpenGLStreamBuffer::EndFrame()
+{
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void OpenGLStreamBuffer::BindStorage(unsigned int binding, unsigned int offset, unsigned int size) const
+{
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, rendererID, offset, size);
+}
+
+void OpenGLStreamBuffer::BindConstants(unsigned int binding, unsigned int offset, unsigned int size) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, rendererID, offset, size);
+}
+
 } // namespace Hedge
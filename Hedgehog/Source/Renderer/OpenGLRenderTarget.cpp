@@ -0,0 +1,128 @@
+#include <Renderer/OpenGLRenderTarget.h>
+
+#include <glad/glad.h>
+
+#include <cassert>
+#include <cstdio>
+
+
+namespace Hedge
+{
+
+static GLenum GetInternalFormat(RenderTargetFormat format)
+{
+	switch (format)
+	{
+	case RenderTargetFormat::RGBA8: return GL_RGBA8;
+	case RenderTargetFormat::RGBA16F: return GL_RGBA16F;
+	case RenderTargetFormat::RGBA32F: return GL_RGBA32F;
+	default: assert(false); return GL_RGBA8;
+	}
+}
+
+OpenGLRenderTarget::OpenGLRenderTarget(const RenderTargetDescription& description)
+	: description(description)
+{
+	glCreateFramebuffers(1, &framebufferID);
+
+	std::vector<GLenum> drawBuffers;
+	colorTextureIDs.resize(description.colorFormats.size());
+	for (unsigned int attachment = 0; attachment < colorTextureIDs.size(); attachment++)
+	{
+		GLuint& textureID = colorTextureIDs[attachment];
+		glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+		glTextureStorage2D(textureID, 1, GetInternalFormat(description.colorFormats[attachment]), description.width, description.height);
+
+		// Read back pixel for pixel with texelFetch
+		glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glNamedFramebufferTexture(framebufferID, GL_COLOR_ATTACHMENT0 + attachment, textureID, 0);
+		drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + attachment);
+	}
+	glNamedFramebufferDrawBuffers(framebufferID, (GLsizei)drawBuffers.size(), drawBuffers.data());
+
+	if (description.depth)
+	{
+		glCreateTextures(GL_TEXTURE_2D, 1, &depthTextureID);
+		glTextureStorage2D(depthTextureID, 1, GL_DEPTH24_STENCIL8, description.width, description.height);
+		glNamedFramebufferTexture(framebufferID, GL_DEPTH_STENCIL_ATTACHMENT, depthTextureID, 0);
+	}
+
+	if (glCheckNamedFramebufferStatus(framebufferID, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Render target framebuffer is incomplete.\n");
+	}
+}
+
+OpenGLRenderTarget::~OpenGLRenderTarget()
+{
+	glDeleteFramebuffers(1, &framebufferID);
+	glDeleteTextures((GLsizei)colorTextureIDs.size(), colorTextureIDs.data());
+	if (depthTextureID)
+	{
+		glDeleteTextures(1, &depthTextureID);
+	}
+}
+
+void OpenGLRenderTarget::Bind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+}
+
+void OpenGLRenderTarget::Unbind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OpenGLRenderTarget::Clear(const glm::vec4& color)
+{
+	for (unsigned int attachment = 0; attachment < colorTextureIDs.size(); attachment++)
+	{
+		glClearNamedFramebufferfv(framebufferID, GL_COLOR, attachment, &color.x);
+	}
+
+	if (description.depth)
+	{
+		// Clears obey the depth mask like draws do
+		GLboolean depthWrite = GL_TRUE;
+		glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWrite);
+		glDepthMask(GL_TRUE);
+		glClearNamedFramebufferfi(framebufferID, GL_DEPTH_STENCIL, 0, 1.0f, 0);
+		glDepthMask(depthWrite);
+	}
+}
+
+void OpenGLRenderTarget::ClearColor(unsigned int attachment, const glm::vec4& color)
+{
+	assert(attachment < colorTextureIDs.size());
+	glClearNamedFramebufferfv(framebufferID, GL_COLOR, attachment, &color.x);
+}
+
+void OpenGLRenderTarget::BindColorTexture(unsigned int attachment, unsigned int slot) const
+{
+	assert(attachment < colorTextureIDs.size());
+	glBindTextureUnit(slot, colorTextureIDs[attachment]);
+}
+
+void OpenGLRenderTarget::CopyDepthToWindow() const
+{
+	assert(description.depth);
+	glBlitNamedFramebuffer(framebufferID, 0,
+						   0, 0, description.width, description.height,
+						   0, 0, description.width, description.height,
+						   GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
+
+void OpenGLRenderTarget::CopyDepthFromWindow()
+{
+	assert(description.depth);
+	glBlitNamedFramebuffer(0, framebufferID,
+						   0, 0, description.width, description.height,
+						   0, 0, description.width, description.height,
+						   GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
+
+} // namespace Hedge
@@ -86,6 +86,45 @@ void OpenGLRendererAPI::SetBlending(bool enable)
 	}
 }
 
+void OpenGLRendererAPI::SetDepthWrite(bool enable)
+{
+	if (enable != depthWrite)
+	{
+		depthWrite = enable;
+
+		glDepthMask(depthWrite ? GL_TRUE : GL_FALSE);
+	}
+}
+
+void OpenGLRendererAPI::SetColorWrite(bool enable)
+{
+	if (enable != colorWrite)
+	{
+		colorWrite = enable;
+
+		GLboolean mask = colorWrite ? GL_TRUE : GL_FALSE;
+		glColorMask(mask, mask, mask, mask);
+	}
+}
+
+void OpenGLRendererAPI::SetBlendMode(BlendMode mode)
+{
+	if (mode != blendMode)
+	{
+		blendMode = mode;
+
+		if (blendMode == BlendMode::WeightedBlended)
+		{
+			glBlendFunci(0, GL_ONE, GL_ONE);
+			glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+		}
+		else
+		{
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+	}
+}
+
 void OpenGLRendererAPI::Resize(int width, int height, bool fillViewport)
 {
 	if (fillViewport)
@@ -110,6 +149,16 @@ void OpenGLRendererAPI::SetClearColor(const glm::vec4& color)
 	glClearColor(color.r, color.g, color.b, color.a);
 }
 
+void OpenGLRendererAPI::Begin()
+{
+	streamBuffer = std::make_unique<OpenGLStreamBuffer>(StreamBuffer::REGION_SIZE);
+}
+
+void OpenGLRendererAPI::End()
+{
+	streamBuffer.reset();
+}
+
 void OpenGLRendererAPI::BeginFrame()
 {
 	// The scissor box bounds the cleared region
@@ -126,23 +175,87 @@ void OpenGLRendererAPI::BeginFrame()
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	glScissor(scissorBox[0], scissorBox[1], scissorBox[2], scissorBox[3]);
+
+	streamBuffer->BeginFrame();
 }
 
 void OpenGLRendererAPI::EndFrame()
 {
+	// Everything that read from the region of this frame has been issued
+	streamBuffer->EndFrame();
+
 	renderContext->SwapBuffers();
 }
 
 void OpenGLRendererAPI::DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray,
 									unsigned int count,
-									unsigned int offset)
+									unsigned int offset,
+									unsigned int instanceCount)
 {
 	GLenum primitiveTopology = GetPipelinePrimitiveTopology(vertexArray->GetPrimitiveTopology());
 	glDrawElementsInstanced(primitiveTopology,
 							count > 0 ? count * 3 : vertexArray->GetIndexBuffer()->GetCount(),
 							GL_UNSIGNED_INT,
 							(const void*)(sizeof(unsigned int) * offset * 3),
-							vertexArray->GetInstanceCount());
+							instanceCount > 0 ? instanceCount : vertexArray->GetInstanceCount());
+}
+
+int OpenGLRendererAPI::CreateOcclusionQuery()
+{
+	GLuint query = 0;
+	if (freeQueries.empty())
+	{
+		glGenQueries(1, &query);
+	}
+	else
+	{
+		query = freeQueries.back();
+		freeQueries.pop_back();
+	}
+
+	return (int)query;
+}
+
+void OpenGLRendererAPI::DestroyOcclusionQuery(int query)
+{
+	freeQueries.push_back((GLuint)query);
+}
+
+void OpenGLRendererAPI::BeginOcclusionQuery(int query)
+{
+	// Any samples is all that is needed and lets the driver stop counting early
+	glBeginQuery(GL_ANY_SAMPLES_PASSED, (GLuint)query);
+}
+
+void OpenGLRendererAPI::EndOcclusionQuery(int query)
+{
+	glEndQuery(GL_ANY_SAMPLES_PASSED);
+}
+
+bool OpenGLRendererAPI::GetOcclusionQueryResult(int query, unsigned long long& samples)
+{
+	GLuint available = GL_FALSE;
+	glGetQueryObjectuiv((GLuint)query, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available == GL_FALSE)
+	{
+		return false;
+	}
+
+	GLuint64 result = 0;
+	glGetQueryObjectui64v((GLuint)query, GL_QUERY_RESULT, &result);
+	samples = result;
+
+	return true;
+}
+
+void OpenGLRendererAPI::BeginConditionalRendering(int query)
+{
+	glBeginConditionalRender((GLuint)query, GL_QUERY_NO_WAIT);
+}
+
+void OpenGLRendererAPI::EndConditionalRendering()
+{
+	glEndConditionalRender();
 }
 
 } // namespace Hedge
@@ -1,5 +1,7 @@
 #include <Renderer/OpenGLShader.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -7,6 +9,30 @@
 namespace Hedge
 {
 
+static size_t GetUniformSize(GLenum type)
+{
+	switch (type)
+	{
+	case GL_FLOAT:
+		return sizeof(float);
+	case GL_FLOAT_VEC2:
+		return sizeof(glm::vec2);
+	case GL_FLOAT_VEC3:
+		return sizeof(glm::vec3);
+	case GL_FLOAT_VEC4:
+		return sizeof(glm::vec4);
+	case GL_FLOAT_MAT3:
+		return sizeof(glm::mat3);
+	case GL_FLOAT_MAT4:
+		return sizeof(glm::mat4);
+	case GL_INT:
+		return sizeof(int);
+	}
+
+	assert(false);
+	return 0;
+}
+
 OpenGLShader::OpenGLShader(const std::string& vertexFilePath,
 						   const std::string& pixelFilePath,
 						   const std::string& geometryFilePath)
@@ -96,6 +122,9 @@ OpenGLShader::OpenGLShader(const std::string& vertexFilePath,
 		glDetachShader(shaderID, geometryShader);
 		glDeleteShader(geometryShader);
 	}
+
+	gBufferOutput = glGetFragDataLocation(shaderID, "g_normal") != -1;
+	instanceTransforms = glGetUniformLocation(shaderID, "u_instanced") != -1;
 }
 
 OpenGLShader::~OpenGLShader()
@@ -112,54 +141,76 @@ void OpenGLShader::Bind()
 void OpenGLShader::Unbind()
 {
 	glUseProgram(0);
+
+	// End of the scene, the slots start over with the values the program has
+	for (auto& uniform : uniforms)
+	{
+		UniformValue value = uniform.values[uniform.uploaded];
+		value.slot = 0;
+		uniform.values.assign(1, value);
+		uniform.uploaded = 0;
+	}
+	varyingUniforms.clear();
+	numberOfSlots = 0;
 }
 
-void OpenGLShader::UploadConstant(const std::string& name, float constant)
+void OpenGLShader::SelectConstants(unsigned int slot)
 {
+	if (varyingUniforms.empty())
+	{
+		return;
+	}
+
 	Bind();
-	GLint uniformLocation = glGetUniformLocation(shaderID, name.c_str());
-	glUniform1f(uniformLocation, constant);
+	for (unsigned int index : varyingUniforms)
+	{
+		Uniform& uniform = uniforms[index];
+
+		// Last of the values uploaded before the slot was committed
+		auto value = std::upper_bound(uniform.values.begin(), uniform.values.end(), slot,
+									  [](unsigned int slot, const UniformValue& value) { return slot < value.slot; });
+		if (value == uniform.values.begin())
+		{
+			continue;
+		}
+
+		size_t selected = value - uniform.values.begin() - 1;
+		if (selected != uniform.uploaded)
+		{
+			Upload(uniform.location, uniform.values[selected]);
+			uniform.uploaded = selected;
+		}
+	}
+}
+
+void OpenGLShader::UploadConstant(const std::string& name, float constant)
+{
+	SetUniform(name, GL_FLOAT, &constant);
 }
 
 void OpenGLShader::UploadConstant(const std::string& name, glm::vec2 constant)
 {
-	Bind();
-	GLint uniformLocation = glGetUniformLocation(shaderID, name.c_str());
-	glUniform2f(uniformLocation, constant[0], constant[1]);
+	SetUniform(name, GL_FLOAT_VEC2, glm::value_ptr(constant));
 }
 
 void OpenGLShader::UploadConstant(const std::string& name, glm::vec3 constant)
 {
-	Bind();
-	GLint uniformLocation = glGetUniformLocation(shaderID, name.c_str());
-	glUniform3f(uniformLocation, constant[0], constant[1], constant[2]);
+	SetUniform(name, GL_FLOAT_VEC3, glm::value_ptr(constant));
 }
 
 void OpenGLShader::UploadConstant(const std::string& name, glm::vec4 constant)
 {
-	Bind();
-	GLint uniformLocation = glGetUniformLocation(shaderID, name.c_str());
-	glUniform4f(uniformLocation, constant[0], constant[1], constant[2], constant[3]);
+	SetUniform(name, GL_FLOAT_VEC4, glm::value_ptr(constant));
 }
 
 void OpenGLShader::UploadConstant(const std::string& name, glm::mat3x3 constant)
 {
-	Bind();
-	GLint uniformLocation = glGetUniformLocation(shaderID, name.c_str());
-	glUniformMatrix3fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(constant));
+	SetUniform(name, GL_FLOAT_MAT3, glm::value_ptr(constant));
 }
 
 void OpenGLShader::UploadConstant(const std::string& name, glm::mat4x4 constant)
 {
-	Bind();
-	GLint uniformLocation = glGetUniformLocation(shaderID, name.c_str());
-	// the program must be bound first to the context with glUseProgram
-	// value_ptr() returns a direct pointer to the matrix data in column-major order, making it useful for uploading data to OpenGL
-	glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(constant));
-
-	// If using OpenGL 4.1 or ARB_separate_shader_objects, you may use the glProgramUniform* functions to set uniforms directly on a program,
-	// without having to bind the program first
-	//glProgramUniformMatrix4fv(shaderID, uniformLocation, 1, GL_FALSE, glm::value_ptr(constant));
+	SetUniform(name, GL_FLOAT_MAT4, glm::value_ptr(constant));
 }
 
 void OpenGLShader::UploadConstant(const std::string& name, const std::vector<glm::mat4>& constant)
@@ -179,9 +230,7 @@ void OpenGLShader::UploadConstant(const std::string& name, const std::vector<glm
 
 void OpenGLShader::UploadConstant(const std::string& name, int constant)
 {
-	Bind();
-	GLint uniformLocation = glGetUniformLocation(shaderID, name.c_str());
-	glUniform1i(uniformLocation, constant);
+	SetUniform(name, GL_INT, &constant);
 }
 
 void OpenGLShader::UploadConstant(const std::string& name, const DirectionalLight& constant)
@@ -263,6 +312,94 @@ void OpenGLShader::UploadConstant(const std::string& name, const void* constant,
 	assert(false);
 }
 
+void OpenGLShader::SetUniform(const std::string& name, GLenum type, const void* data)
+{
+	Bind();
+	GLint location = glGetUniformLocation(shaderID, name.c_str());
+	if (location == -1)
+	{
+		return;
+	}
+
+	auto [index, inserted] = uniformIndices.try_emplace(location, (unsigned int)uniforms.size());
+	if (inserted)
+	{
+		uniforms.push_back({ location });
+	}
+	Uniform& uniform = uniforms[index->second];
+
+	UniformValue value{ numberOfSlots, type };
+	memcpy(value.data, data, GetUniformSize(type));
+
+	if (!uniform.values.empty())
+	{
+		UniformValue& last = uniform.values.back();
+		if (last.type == value.type
+			&& memcmp(last.data, value.data, GetUniformSize(type)) == 0)
+		{
+			// Same as before, only the program may have another one of the slots
+			if (uniform.uploaded != uniform.values.size() - 1)
+			{
+				Upload(location, last);
+				uniform.uploaded = uniform.values.size() - 1;
+			}
+			return;
+		}
+
+		if (last.slot == numberOfSlots)
+		{
+			// Nothing committed with the last one yet
+			last = value;
+		}
+		else
+		{
+			if (uniform.values.size() == 1)
+			{
+				varyingUniforms.push_back(index->second);
+			}
+			uniform.values.push_back(value);
+		}
+	}
+	else
+	{
+		uniform.values.push_back(value);
+	}
+
+	uniform.uploaded = uniform.values.size() - 1;
+	Upload(location, uniform.values.back());
+}
+
+void OpenGLShader::Upload(GLint location, const UniformValue& value)
+{
+	// The program must be bound first, the matrices are in the column-major order of glm
+	switch (value.type)
+	{
+	case GL_FLOAT:
+		glUniform1fv(location, 1, value.data);
+		break;
+	case GL_FLOAT_VEC2:
+		glUniform2fv(location, 1, value.data);
+		break;
+	case GL_FLOAT_VEC3:
+		glUniform3fv(location, 1, value.data);
+		break;
+	case GL_FLOAT_VEC4:
+		glUniform4fv(location, 1, value.data);
+		break;
+	case GL_FLOAT_MAT3:
+		glUniformMatrix3fv(location, 1, GL_FALSE, value.data);
+		break;
+	case GL_FLOAT_MAT4:
+		glUniformMatrix4fv(location, 1, GL_FALSE, value.data);
+		break;
+	case GL_INT:
+		glUniform1iv(location, 1, reinterpret_cast<const GLint*>(value.data));
+		break;
+	default:
+		assert(false);
+	}
+}
+
 GLuint OpenGLShader::CompileShader(GLenum shaderType, const std::string& srcFilePath)
 {
 	// Create an empty shader handle
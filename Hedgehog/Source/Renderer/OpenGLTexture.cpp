@@ -19,6 +19,7 @@ OpenGLTexture2D::OpenGLTexture2D(const std::string& filename)
 
 	this->width = width;
 	this->height = height;
+	translucent = HasTranslucentTexels(data, width, height, channels);
 
 	GLenum internalFormat = GL_RGB8;
 	GLenum dataFormat = GL_RGB;
@@ -44,6 +45,22 @@ OpenGLTexture2D::OpenGLTexture2D(const std::string& filename)
 	stbi_image_free(data);
 }
 
+OpenGLTexture2D::OpenGLTexture2D(unsigned int width, unsigned int height, const float* data)
+	: width(width)
+	, height(height)
+{
+	glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+	glTextureStorage2D(textureID, 1, GL_RGBA32F, width, height);
+
+	// Data is read with texelFetch, never filtered
+	glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glTextureSubImage2D(textureID, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, data);
+}
+
 OpenGLTexture2D::~OpenGLTexture2D()
 {
 	glDeleteTextures(1, &textureID);
@@ -42,7 +42,8 @@ void OpenGLVertexArray::Bind()
 void OpenGLVertexArray::Unbind() const
 {
 	glBindVertexArray(0);
-	shader->Unbind();
+	// Not the shader's Unbind, that one also starts its constant slots over at the end of the scene
+	glUseProgram(0);
 }
 
 void OpenGLVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer)
@@ -0,0 +1,170 @@
+#include <Renderer/PaletteBuffer.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+
+namespace Hedge
+{
+
+static constexpr unsigned int MIN_CAPACITY = 256; // matrices, a few characters
+
+void PaletteBuffer::DirtyRange::Add(unsigned int first, unsigned int last)
+{
+	if (IsEmpty())
+	{
+		this->first = first;
+		this->last = last;
+	}
+	else
+	{
+		this->first = std::min(this->first, first);
+		this->last = std::max(this->last, last);
+	}
+}
+
+bool PaletteBuffer::IsSupported()
+{
+	if (!buffer
+		&& supported)
+	{
+		Reserve(MIN_CAPACITY);
+	}
+
+	return supported;
+}
+
+void PaletteBuffer::Reserve(unsigned int count)
+{
+	if (buffer
+		&& count <= palettes.size())
+	{
+		return;
+	}
+
+	unsigned int capacity = std::max({ count, (unsigned int)palettes.size() * 2, MIN_CAPACITY });
+
+	// The alignment is only known once there is a buffer of the API to ask
+	std::unique_ptr<StorageBuffer> probe(StorageBuffer::Create(1));
+	if (!probe)
+	{
+		supported = false;
+		return;
+	}
+
+	unsigned int alignment = probe->GetOffsetAlignment();
+	regionSize = (capacity * (unsigned int)sizeof(glm::mat4) + alignment - 1) / alignment * alignment;
+
+	buffer.reset(StorageBuffer::Create(regionSize * NUMBER_OF_REGIONS));
+	palettes.resize(regionSize / sizeof(glm::mat4), glm::mat4(1.0f));
+
+	// The new buffer has nothing in it yet
+	for (auto& dirtyRange : dirtyRanges)
+	{
+		dirtyRange = DirtyRange();
+		dirtyRange.Add(0, used);
+	}
+}
+
+PaletteAllocation PaletteBuffer::Allocate(unsigned int count)
+{
+	// Freed slots of the same skeleton fit exactly, take those first
+	auto freeAllocation = std::find_if(freeAllocations.begin(), freeAllocations.end(),
+		[count](const PaletteAllocation& allocation) { return allocation.count == count; });
+	if (freeAllocation == freeAllocations.end())
+	{
+		freeAllocation = std::find_if(freeAllocations.begin(), freeAllocations.end(),
+			[count](const PaletteAllocation& allocation) { return allocation.count >= count; });
+	}
+
+	PaletteAllocation allocation;
+	allocation.count = count;
+
+	if (freeAllocation != freeAllocations.end())
+	{
+		allocation.offset = freeAllocation->offset;
+		if (freeAllocation->count > count)
+		{
+			freeAllocation->offset += count;
+			freeAllocation->count -= count;
+		}
+		else
+		{
+			freeAllocations.erase(freeAllocation);
+		}
+	}
+	else
+	{
+		Reserve(used + count);
+		allocation.offset = used;
+		used += count;
+	}
+
+	return allocation;
+}
+
+void PaletteBuffer::Free(const PaletteAllocation& allocation)
+{
+	if (allocation.count > 0)
+	{
+		freeAllocations.push_back({ allocation.offset, allocation.count });
+	}
+}
+
+void PaletteBuffer::Write(const PaletteAllocation& allocation, const std::vector<glm::mat4>& palette)
+{
+	assert(palette.size() <= allocation.count);
+	assert(allocation.offset + allocation.count <= palettes.size());
+
+	memcpy(&palettes[allocation.offset], palette.data(), palette.size() * sizeof(glm::mat4));
+
+	for (auto& dirtyRange : dirtyRanges)
+	{
+		dirtyRange.Add(allocation.offset, allocation.offset + (unsigned int)palette.size());
+	}
+
+	writesSinceUpload++;
+}
+
+void PaletteBuffer::Upload()
+{
+	numberOfWrites = writesSinceUpload;
+	writesSinceUpload = 0;
+	uploadedBytes = 0;
+
+	if (!buffer
+		|| used == 0)
+	{
+		return;
+	}
+
+	region = (region + 1) % NUMBER_OF_REGIONS;
+
+	DirtyRange& dirtyRange = dirtyRanges[region];
+	if (!dirtyRange.IsEmpty())
+	{
+		uploadedBytes = (dirtyRange.last - dirtyRange.first) * (unsigned int)sizeof(glm::mat4);
+		buffer->SetData(&palettes[dirtyRange.first], uploadedBytes,
+						region * regionSize + dirtyRange.first * (unsigned int)sizeof(glm::mat4));
+		dirtyRange = DirtyRange();
+	}
+
+	buffer->Bind(BINDING, region * regionSize, regionSize);
+}
+
+void PaletteBuffer::CreateGuiControls()
+{
+	if (!supported)
+	{
+		ImGui::Text("Palettes are uploaded as shader constants");
+		return;
+	}
+
+	ImGui::Text("Palettes: %u of %zu matrices used, %u written, %.1f KB uploaded",
+				used, palettes.size(), numberOfWrites, uploadedBytes / 1024.0f);
+}
+
+} // namespace Hedge
@@ -0,0 +1,137 @@
+#include <Renderer/RenderQueue.h>
+
+#include <Utilities/Stopwatch.h>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace Hedge
+{
+
+static constexpr int PASS_BITS = 4;
+static constexpr int SHADER_BITS = 16;
+static constexpr int MATERIAL_BITS = 12;
+static constexpr int DEPTH_BITS = 24;
+
+static constexpr uint64_t Mask(int bits) { return (uint64_t(1) << bits) - 1; }
+
+uint64_t RenderQueue::CreateKey(RenderPass pass, bool translucent, unsigned int shader, unsigned int material, float depth)
+{
+	// Bits of a positive float sort the same as the float, the top ones are enough to tell the draws apart
+	uint32_t depthBits = 0;
+	depth = std::max(depth, 0.0f);
+	std::memcpy(&depthBits, &depth, sizeof(depthBits));
+	uint64_t quantizedDepth = depthBits >> (32 - DEPTH_BITS);
+
+	uint64_t key = uint64_t(pass) & Mask(PASS_BITS);
+	key = (key << 1) | (translucent ? 1 : 0);
+
+	if (translucent)
+	{
+		key = (key << DEPTH_BITS) | (~quantizedDepth & Mask(DEPTH_BITS));
+		key = (key << SHADER_BITS) | (shader & Mask(SHADER_BITS));
+		key = (key << MATERIAL_BITS) | (material & Mask(MATERIAL_BITS));
+	}
+	else
+	{
+		key = (key << SHADER_BITS) | (shader & Mask(SHADER_BITS));
+		key = (key << MATERIAL_BITS) | (material & Mask(MATERIAL_BITS));
+		key = (key << DEPTH_BITS) | quantizedDepth;
+	}
+
+	// Whatever is left over at the bottom
+	return key << (64 - PASS_BITS - 1 - SHADER_BITS - MATERIAL_BITS - DEPTH_BITS);
+}
+
+RenderPass RenderQueue::GetPass(uint64_t key)
+{
+	return (RenderPass)(key >> (64 - PASS_BITS));
+}
+
+unsigned int RenderQueue::GetShaderId(const Shader* shader)
+{
+	auto [id, inserted] = shaderIds.try_emplace(shader, (unsigned int)shaderIds.size());
+	return id->second;
+}
+
+unsigned int RenderQueue::GetMaterialId(const VertexArray* vertexArray)
+{
+	auto [id, inserted] = materialIds.try_emplace(vertexArray, (unsigned int)materialIds.size());
+	return id->second;
+}
+
+unsigned int RenderQueue::AddObject(const ObjectConstants& object)
+{
+	objects.push_back(object);
+	return (unsigned int)objects.size() - 1;
+}
+
+void RenderQueue::Add(uint64_t key, unsigned int object, int group)
+{
+	packets.push_back({ key, object, group });
+}
+
+void RenderQueue::Sort()
+{
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	numberOfPackets = (unsigned int)packets.size();
+
+	// Objects come in the order their shaders were first seen and their groups nearest first,
+	// so without anything translucent the packets usually are in order already
+	if (std::is_sorted(packets.begin(), packets.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; }))
+	{
+		stopwatch.Stop();
+		sortDuration = stopwatch.GetDuration().count();
+		return;
+	}
+
+	sortedPackets.resize(packets.size());
+
+	// Least significant byte first, passes where every key has the same byte are skipped
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		unsigned int offsets[256] = {};
+		for (const auto& packet : packets)
+		{
+			offsets[(packet.key >> shift) & 0xFF]++;
+		}
+
+		if (offsets[(packets.empty() ? 0 : packets[0].key >> shift) & 0xFF] == packets.size())
+		{
+			continue;
+		}
+
+		unsigned int offset = 0;
+		for (auto& count : offsets)
+		{
+			unsigned int bucketSize = count;
+			count = offset;
+			offset += bucketSize;
+		}
+
+		for (const auto& packet : packets)
+		{
+			sortedPackets[offsets[(packet.key >> shift) & 0xFF]++] = packet;
+		}
+
+		packets.swap(sortedPackets);
+	}
+
+	stopwatch.Stop();
+	sortDuration = stopwatch.GetDuration().count();
+}
+
+void RenderQueue::Clear()
+{
+	objects.clear();
+	packets.clear();
+
+	// A freed shader or vertex array may come back at the same address, and the ids have to fit into their bits
+	shaderIds.clear();
+	materialIds.clear();
+}
+
+} // namespace Hedge
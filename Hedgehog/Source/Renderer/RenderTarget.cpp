@@ -0,0 +1,27 @@
+#include <Renderer/RenderTarget.h>
+
+#include <Renderer/Renderer.h>
+#include <Renderer/OpenGLRenderTarget.h>
+
+
+namespace Hedge
+{
+
+RenderTarget* RenderTarget::Create(const RenderTargetDescription& description)
+{
+	switch (Renderer::GetAPI())
+	{
+	case RendererAPI::API::OpenGL:
+		return new OpenGLRenderTarget(description);
+
+	// TODO Vulkan needs render passes and framebuffers of its own, and pipelines created against them,
+	// DirectX12 render target and shader resource views in descriptor heaps
+	case RendererAPI::API::None:
+		return nullptr;
+
+	default:
+		return nullptr;
+	}
+}
+
+} // namespace Hedge
@@ -1,11 +1,14 @@
 #include <Renderer/Renderer.h>
 
 #include <algorithm>
+#include <cstring>
 
 
 namespace Hedge
 {
 
+static constexpr unsigned int MIN_INSTANCE_BUFFER_SIZE = 4096; // bytes
+
 // static private member needs definition if not using C++17's inline static
 //Camera Renderer::sceneCamera;
 
@@ -32,10 +35,389 @@ void Renderer::SetBlending(bool enable)
 void Renderer::BeginScene(Entity camera)
 {
 	sceneCamera = camera;
+	deferredActive = deferredShading.IsActive();
+	transparencyActive = transparency.IsActive();
+
+	cullingStatistics = CullingStatistics();
+	if (sceneCamera)
+	{
+		frustumPlanes = FrustumPlanes::Create(sceneCamera.Get<Camera>().GetProjection() * glm::inverse(sceneCamera.Get<Transform>().Get()));
+	}
+}
+
+bool Renderer::SetFrameConstants(const FrameConstants& constants)
+{
+	if (!frameConstantBufferCreated)
+	{
+		frameConstantBuffer.reset(ConstantBuffer::Create(sizeof(FrameConstants)));
+		frameConstantBufferCreated = true;
+	}
+
+	if (!frameConstantBuffer
+		|| !sceneCamera)
+	{
+		return false;
+	}
+
+	FrameConstants frameConstants = constants;
+	frameConstants.projectionView = sceneCamera.Get<Camera>().GetProjection() * glm::inverse(sceneCamera.Get<Transform>().Get());
+	frameConstants.viewPosition = sceneCamera.Get<Transform>().GetTranslation();
+
+	frameConstantBuffer->SetData(&frameConstants, sizeof(FrameConstants));
+	frameConstantBuffer->Bind(FrameConstants::BINDING);
+
+	return true;
+}
+
+bool Renderer::IsVisible(const BoundingBox& bounds, const glm::mat4x4& transform,
+						 const OcclusionBuffer* occlusionBuffer)
+{
+	bool visible = !frustumCulling
+		|| !sceneCamera
+		|| frustumPlanes.Transform(transform).Intersects(bounds);
+
+	if (!visible)
+	{
+		cullingStatistics.culledMeshes++;
+		return false;
+	}
+
+	if (occlusionBuffer
+		&& !occlusionBuffer->IsVisible(bounds, transform))
+	{
+		cullingStatistics.occludedMeshes++;
+		return false;
+	}
+
+	cullingStatistics.visibleMeshes++;
+	return true;
+}
+
+void Renderer::UpdateGroupOrder(VertexArray& vertexArray, GroupOrder& order, const glm::vec3& cameraPosition, const glm::mat4x4& transform)
+{
+	auto& groups = vertexArray.GetGroups();
+
+	if (order.groups.size() != groups.size())
+	{
+		order.groups.resize(groups.size());
+		for (int index = 0; index < (int)groups.size(); index++)
+		{
+			order.groups[index].group = index;
+		}
+		order.cameraPosition = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+	}
+
+	if (order.cameraPosition == cameraPosition
+		&& order.transform == transform)
+	{
+		return;
+	}
+
+	for (auto& [distance, index] : order.groups)
+	{
+		distance = glm::distance(cameraPosition, glm::vec3(transform * glm::vec4(groups[index].first.center, 1.0f)));
+	}
+
+	// Insertion sort, the order hardly changes from one frame to the next so it is close to linear
+	for (size_t i = 1; i < order.groups.size(); i++)
+	{
+		GroupOrder::GroupDistance current = order.groups[i];
+		size_t j = i;
+		while (j > 0
+			   && order.groups[j - 1].distance > current.distance)
+		{
+			order.groups[j] = order.groups[j - 1];
+			j--;
+		}
+		order.groups[j] = current;
+	}
+
+	order.cameraPosition = cameraPosition;
+	order.transform = transform;
+}
+
+bool Renderer::HasInstanceData(const VertexArray& vertexArray)
+{
+	for (const auto& vertexBuffer : vertexArray.GetVertexBuffers())
+	{
+		for (const auto& element : vertexBuffer->GetLayout())
+		{
+			if (element.instanceDataStep != -1)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool Renderer::IsInstanceable(const VertexArray& vertexArray)
+{
+	// Per instance data of its own would run out after the first of the entities
+	if (!instancing
+		|| vertexArray.GetInstanceCount() != 1
+		|| !vertexArray.GetShader()->HasInstanceTransforms()
+		|| HasInstanceData(vertexArray))
+	{
+		return false;
+	}
+
+	if (!instanceBuffer
+		&& instanceBufferSupported)
+	{
+		instanceBuffer.reset(StorageBuffer::Create(MIN_INSTANCE_BUFFER_SIZE));
+		instanceBufferSupported = instanceBuffer != nullptr;
+	}
+
+	return instanceBufferSupported;
+}
+
+void Renderer::RecordInstanceBatches()
+{
+	instanceTransforms.clear();
+	renderQueue.numberOfBatches = 0;
+	renderQueue.numberOfBatchedInstances = 0;
+
+	for (auto& batch : instanceBatches)
+	{
+		// Alone it is culled and queried group by group like any other object
+		if (batch.transforms.size() == 1)
+		{
+			Record(batch.vertexArray, batch.transforms[0], batch.constantSlot,
+				   batch.occlusionBuffer, batch.occlusionQueries, batch.depthVertexArray, batch.groups);
+			continue;
+		}
+
+		unsigned int instanceOffset = (unsigned int)instanceTransforms.size();
+		unsigned int instanceCount = (unsigned int)batch.transforms.size();
+		instanceTransforms.insert(instanceTransforms.end(), batch.transforms.begin(), batch.transforms.end());
+
+		// The vertex arrays are shared with other objects, the instance count goes with the object into the draws
+		bool depthInstanced = batch.depthVertexArray
+			&& batch.depthVertexArray->GetShader()->HasInstanceTransforms();
+
+		Record(batch.vertexArray, batch.transforms[0], batch.constantSlot,
+			   nullptr, nullptr, depthInstanced ? batch.depthVertexArray : nullptr, batch.groups,
+			   instanceOffset, instanceCount);
+
+		renderQueue.numberOfBatches++;
+		renderQueue.numberOfBatchedInstances += instanceCount;
+	}
+
+	if (instanceTransforms.empty())
+	{
+		return;
+	}
+
+	unsigned int size = (unsigned int)(instanceTransforms.size() * sizeof(glm::mat4));
+	auto streamBuffer = RenderCommand::GetStreamBuffer();
+	StreamBuffer::Allocation allocation = streamBuffer ? streamBuffer->Allocate(size) : StreamBuffer::Allocation();
+	if (allocation.data)
+	{
+		memcpy(allocation.data, instanceTransforms.data(), size);
+		streamBuffer->BindStorage(INSTANCE_BINDING, allocation.offset, size);
+		return;
+	}
+
+	// Storage buffers can't be resized, it is replaced by one twice as big when the transforms don't fit
+	if (instanceBuffer->GetSize() < size)
+	{
+		unsigned int capacity = instanceBuffer->GetSize();
+		while (capacity < size)
+		{
+			capacity *= 2;
+		}
+		instanceBuffer.reset(StorageBuffer::Create(capacity));
+	}
+
+	instanceBuffer->SetData(instanceTransforms.data(), size);
+	instanceBuffer->Bind(INSTANCE_BINDING, 0, instanceBuffer->GetSize());
 }
 
 void Renderer::EndScene()
 {
+	RecordInstanceBatches();
+
+	renderQueue.Sort();
+
+	// The depth pre-pass goes into the G-buffer too, it is lit as soon as the first packet of a later pass shows up
+	bool geometryPass = deferredActive;
+	bool transparencyPass = false;
+	if (geometryPass)
+	{
+		deferredShading.BeginGeometryPass();
+	}
+
+	bool colorWrite = RenderCommand::GetColorWrite();
+
+	// Objects have one vertex array each, packets of one object come one after another unless they are translucent
+	int boundPass = -1;
+	int boundObject = -1;
+	std::shared_ptr<VertexArray> boundVertexArray;
+	renderQueue.numberOfBinds = 0;
+	renderQueue.numberOfDepthDraws = 0;
+	for (const auto& packet : renderQueue.GetPackets())
+	{
+		RenderPass pass = RenderQueue::GetPass(packet.key);
+		if ((int)pass != boundPass)
+		{
+			// Every pass binds the objects again, with other vertex arrays or constants
+			if (boundVertexArray)
+			{
+				boundVertexArray->Unbind();
+				boundVertexArray.reset();
+			}
+			boundObject = -1;
+			boundPass = (int)pass;
+
+			RenderCommand::SetColorWrite(pass == RenderPass::Depth ? false : colorWrite);
+
+			if (geometryPass
+				&& pass != RenderPass::Depth
+				&& pass != RenderPass::GBuffer)
+			{
+				deferredShading.EndGeometryPass();
+				geometryPass = false;
+			}
+
+			// Last of the passes, ended after the loop
+			if (pass == RenderPass::Transparency)
+			{
+				transparency.Begin();
+				transparencyPass = true;
+			}
+		}
+
+		const ObjectConstants& object = renderQueue.GetObject(packet.object);
+		if (pass == RenderPass::Depth)
+		{
+			if ((int)packet.object != boundObject)
+			{
+				// One shader for all of them, the transform goes in right before the draws
+				auto depthShader = object.depthVertexArray->GetShader();
+				depthShader->UploadConstant("u_transform", object.transform);
+				if (depthShader->HasInstanceTransforms())
+				{
+					depthShader->UploadConstant("u_instanced", object.instanceCount > 0 ? 1 : 0);
+					depthShader->UploadConstant("u_instanceOffset", (int)object.instanceOffset);
+				}
+				object.depthVertexArray->Bind();
+				boundObject = (int)packet.object;
+				boundVertexArray = object.depthVertexArray;
+				renderQueue.numberOfBinds++;
+			}
+
+			if (packet.group == -1)
+			{
+				RenderCommand::DrawIndexed(object.depthVertexArray, 0, 0, object.instanceCount);
+				renderQueue.numberOfDepthDraws++;
+				continue;
+			}
+
+			// Still hidden as of the last results, the main pass skips it as well unless it shows up again
+			const VertexGroup& group = object.vertexArray->GetGroups()[packet.group].first;
+			if (object.occlusionQueries
+				&& object.groups->groups[packet.group].occlusion.occluded)
+			{
+				continue;
+			}
+
+			RenderCommand::DrawIndexed(object.depthVertexArray, group.endIndex - group.startIndex + 1, group.startIndex, object.instanceCount);
+			renderQueue.numberOfDepthDraws++;
+			continue;
+		}
+
+		if ((int)packet.object != boundObject)
+		{
+			auto shader = object.vertexArray->GetShader();
+			shader->SelectConstants(object.constantSlot);
+			// Also when deferred shading or the transparency is off, the last scene may have left them on
+			if (shader->HasGBufferOutput())
+			{
+				shader->UploadConstant("u_gBufferPass", pass == RenderPass::GBuffer ? 1 : 0);
+				shader->UploadConstant("u_transparencyPass", pass == RenderPass::Transparency ? 1 : 0);
+			}
+			if (shader->HasInstanceTransforms())
+			{
+				shader->UploadConstant("u_instanced", object.instanceCount > 0 ? 1 : 0);
+				shader->UploadConstant("u_instanceOffset", (int)object.instanceOffset);
+			}
+			if (pass == RenderPass::GBuffer)
+			{
+				deferredShading.geometryDraws++;
+			}
+			else if (pass == RenderPass::Transparency)
+			{
+				transparency.numberOfDraws++;
+			}
+			else if (deferredActive)
+			{
+				deferredShading.forwardDraws++;
+			}
+			object.vertexArray->Bind();
+			boundObject = (int)packet.object;
+			boundVertexArray = object.vertexArray;
+			renderQueue.numberOfBinds++;
+		}
+
+		if (packet.group == -1)
+		{
+			RenderCommand::DrawIndexed(object.vertexArray, 0, 0, object.instanceCount);
+			continue;
+		}
+
+		const VertexGroup& group = object.vertexArray->GetGroups()[packet.group].first;
+		if (object.occlusionQueries
+			&& !object.occlusionQueries->BeginGroup(group, object.groups->groups[packet.group].occlusion, object.transform))
+		{
+			cullingStatistics.occludedGroups++;
+			continue;
+		}
+
+		cullingStatistics.visibleGroups++;
+		RenderCommand::DrawIndexed(object.vertexArray, group.endIndex - group.startIndex + 1, group.startIndex, object.instanceCount);
+
+		if (object.occlusionQueries)
+		{
+			object.occlusionQueries->EndGroup();
+		}
+	}
+
+	if (boundVertexArray)
+	{
+		boundVertexArray->Unbind();
+	}
+
+	RenderCommand::SetColorWrite(colorWrite);
+
+	// Nothing in the passes after it
+	if (geometryPass)
+	{
+		deferredShading.EndGeometryPass();
+	}
+
+	if (transparencyPass)
+	{
+		transparency.End();
+	}
+
+	// The boxes of the occluded groups go against the depth of everything drawn
+	if (sceneCamera)
+	{
+		auto projectionView = sceneCamera.Get<Camera>().GetProjection() * glm::inverse(sceneCamera.Get<Transform>().Get());
+		for (auto occlusionQueries : usedOcclusionQueries)
+		{
+			occlusionQueries->Flush(projectionView);
+		}
+	}
+	usedOcclusionQueries.clear();
+
+	instanceBatches.clear();
+	instanceBatchIndices.clear();
+
+	renderQueue.Clear();
+
 	for (auto& shader : usedShaders)
 	{
 		// When we unbind the shader, we clear the number of objects that used the same shader
@@ -48,54 +430,181 @@ void Renderer::EndScene()
 }
 
 void Renderer::Submit(const std::shared_ptr<VertexArray>& vertexArray,
-					  const glm::mat4x4& transform)
+					  const glm::mat4x4& transform,
+					  const OcclusionBuffer* occlusionBuffer,
+					  OcclusionQueries* occlusionQueries,
+					  const std::shared_ptr<VertexArray>& depthVertexArray,
+					  bool objectConstants,
+					  bool rigid,
+					  MeshGroups* groups)
 {
 	if (!sceneCamera)
 	{
 		return;
 	}
 
+	if (groups
+		&& groups->groups.size() != vertexArray->GetGroups().size())
+	{
+		groups->groups.resize(vertexArray->GetGroups().size());
+	}
+
+	// Once per shader, it is ignored by those that read it from the frame constants
 	if (!usedShaders.contains(vertexArray->GetShader()))
 	{
 		auto projectionView = sceneCamera.Get<Camera>().GetProjection() * glm::inverse(sceneCamera.Get<Transform>().Get());
 		vertexArray->GetShader()->UploadConstant("u_projectionView", projectionView);
 	}
 	vertexArray->GetShader()->UploadConstant("u_transform", transform);
+	unsigned int constantSlot = vertexArray->GetShader()->CommitConstants();
 
+	// Keep track of different shaders that are being used so they can be cleared at the end of the scene
+	usedShaders.insert(vertexArray->GetShader());
+
+	// Recorded at the end of the scene, once all of the entities sharing the vertex array are known
+	// The batch only has the constant slot and the groups of its first entity, the transforms are all that may differ
+	bool allGroups = !groups
+		|| std::all_of(groups->groups.begin(), groups->groups.end(), [](const GroupState& group) { return group.enabled; });
+	if (!objectConstants
+		&& rigid
+		&& allGroups
+		&& IsInstanceable(*vertexArray))
+	{
+		auto [index, inserted] = instanceBatchIndices.try_emplace(vertexArray.get(), (unsigned int)instanceBatches.size());
+		if (inserted)
+		{
+			instanceBatches.push_back({ vertexArray, depthVertexArray, occlusionBuffer, occlusionQueries, constantSlot, groups, {} });
+		}
+		instanceBatches[index->second].transforms.push_back(transform);
+		return;
+	}
+
+	Record(vertexArray, transform, constantSlot, occlusionBuffer, occlusionQueries, depthVertexArray, groups, 0, 0, rigid);
+}
+
+void Renderer::Record(const std::shared_ptr<VertexArray>& vertexArray,
+					  const glm::mat4x4& transform,
+					  unsigned int constantSlot,
+					  const OcclusionBuffer* occlusionBuffer,
+					  OcclusionQueries* occlusionQueries,
+					  const std::shared_ptr<VertexArray>& depthVertexArray,
+					  MeshGroups* meshGroups,
+					  unsigned int instanceOffset,
+					  unsigned int instanceCount,
+					  bool rigid)
+{
 	auto& groups = vertexArray->GetGroups();
+	glm::vec3 cameraPosition = sceneCamera.Get<Transform>().GetTranslation();
 
-	// TODO this should be done only if camera position or transform changes between frames
-	for (auto& [group, distance] : groups)
+	// Whatever the last vertex array without groups left in it is of no use
+	if (!meshGroups)
 	{
-		distance = glm::distance(sceneCamera.Get<Transform>().GetTranslation(),
-									glm::vec3(transform * glm::vec4(group.center, 1.0f)));
+		unkeptGroupOrder.cameraPosition = glm::vec3(std::numeric_limits<float>::quiet_NaN());
 	}
+	GroupOrder& order = meshGroups ? meshGroups->order : unkeptGroupOrder;
+	UpdateGroupOrder(*vertexArray, order, cameraPosition, transform);
+
+	// Instances are spread around by their own offsets or transforms, the bounds of the groups don't tell where
+	// Neither do they for animated vertices, the whole mesh was already tested against bounds with room for them
+	bool single = instanceCount == 0
+		&& vertexArray->GetInstanceCount() <= 1;
+	bool cullGroups = frustumCulling
+		&& single
+		&& rigid;
+	FrustumPlanes localPlanes = cullGroups ? frustumPlanes.Transform(transform) : FrustumPlanes();
+	bool occludeGroups = occlusionBuffer
+		&& single
+		&& rigid;
+	bool queryGroups = occlusionQueries
+		&& meshGroups
+		&& occlusionQueries->IsActive()
+		&& single
+		&& rigid;
+	// The positions of the depth vertex array don't have the offsets or whatever else the instance data adds to them
+	bool depthGroups = depthPrePass
+		&& depthVertexArray
+		&& (single || instanceCount > 0)
+		&& !HasInstanceData(*vertexArray);
 
-	auto comp = [](const std::pair<VertexGroup, float>& a, const std::pair<VertexGroup, float>& b)
+	ObjectConstants objectConstants;
+	objectConstants.vertexArray = vertexArray;
+	objectConstants.transform = transform;
+	objectConstants.constantSlot = constantSlot;
+	objectConstants.occlusionQueries = queryGroups ? occlusionQueries : nullptr;
+	objectConstants.depthVertexArray = depthGroups ? depthVertexArray : nullptr;
+	objectConstants.instanceOffset = instanceOffset;
+	objectConstants.instanceCount = instanceCount;
+	objectConstants.groups = meshGroups;
+	unsigned int object = renderQueue.AddObject(objectConstants);
+
+	if (queryGroups)
 	{
-		return a.second > b.second;
-	};
-	std::sort(groups.begin(), groups.end(), comp);
-	
-	vertexArray->Bind();
+		usedOcclusionQueries.insert(occlusionQueries);
+	}
+
+	unsigned int shaderId = renderQueue.GetShaderId(vertexArray->GetShader().get());
+	unsigned int materialId = renderQueue.GetMaterialId(vertexArray.get());
+
+	unsigned int depthShaderId = depthGroups ? renderQueue.GetShaderId(depthVertexArray->GetShader().get()) : 0;
+	unsigned int depthMaterialId = depthGroups ? renderQueue.GetMaterialId(depthVertexArray.get()) : 0;
+
+	// Translucent groups blend with what is behind them, they always go forward and not into the depth pre-pass
+	// Sorted back to front unless the weighted blended transparency can take them
+	bool extraOutputs = vertexArray->GetShader()->HasGBufferOutput();
+	RenderPass opaquePass = deferredActive && extraOutputs ? RenderPass::GBuffer : RenderPass::Main;
+	bool sortTranslucent = !transparencyActive || !extraOutputs;
+
 	if (groups.empty())
 	{
-		RenderCommand::DrawIndexed(vertexArray);
+		float distance = glm::distance(cameraPosition, glm::vec3(transform[3]));
+		if (depthGroups)
+		{
+			renderQueue.Add(RenderQueue::CreateKey(RenderPass::Depth, false, depthShaderId, depthMaterialId, distance), object);
+		}
+		renderQueue.Add(RenderQueue::CreateKey(opaquePass, false, shaderId, materialId, distance), object);
 	}
 	else
 	{
-		for (const auto& [group, distance] : groups)
+		// Nearest first, opaque packets then mostly come in already sorted
+		for (const auto& [distance, index] : order.groups)
 		{
-			if (group.enabled)
+			const VertexGroup& group = groups[index].first;
+
+			if (meshGroups
+				&& !meshGroups->groups[index].enabled)
+			{
+				continue;
+			}
+
+			if (cullGroups
+				&& !localPlanes.Intersects(group.bounds))
 			{
-				RenderCommand::DrawIndexed(vertexArray, group.endIndex - group.startIndex + 1, group.startIndex);
+				cullingStatistics.culledGroups++;
+				continue;
 			}
+
+			if (occludeGroups
+				&& !occlusionBuffer->IsVisible(group.bounds, transform))
+			{
+				cullingStatistics.occludedGroups++;
+				continue;
+			}
+
+			if (group.translucent)
+			{
+				RenderPass pass = sortTranslucent ? RenderPass::Main : RenderPass::Transparency;
+				renderQueue.Add(RenderQueue::CreateKey(pass, sortTranslucent, shaderId, materialId, distance), object, index);
+				continue;
+			}
+
+			if (depthGroups)
+			{
+				renderQueue.Add(RenderQueue::CreateKey(RenderPass::Depth, false, depthShaderId, depthMaterialId, distance), object, index);
+			}
+
+			renderQueue.Add(RenderQueue::CreateKey(opaquePass, false, shaderId, materialId, distance), object, index);
 		}
 	}
-	vertexArray->Unbind();
-
-	// Keep track of different shaders that are being used so they can be cleared at the end of the scene
-	usedShaders.insert(vertexArray->GetShader());
 }
 
 } // namespace Hedge
@@ -0,0 +1,149 @@
+#include <Renderer/ResourceCache.h>
+
+#include <Renderer/RendererAPI.h>
+
+#include <imgui.h>
+
+#include <sstream>
+
+
+namespace Hedge
+{
+
+std::shared_ptr<Geometry> ResourceCache::GetGeometry(const std::string& modelFilename,
+													 PrimitiveTopology primitiveTopology, const BufferLayout& bufferLayout)
+{
+	std::stringstream key;
+	key << modelFilename << '|' << (int)primitiveTopology;
+	for (auto& element : bufferLayout)
+	{
+		key << '|' << element.name << ',' << (int)element.type << ',' << element.instanceDataStep << ',' << element.normalized;
+	}
+
+	if (auto geometry = Find(geometries, key.str()))
+	{
+		return geometry;
+	}
+
+	// The model is only loaded on a miss, it isn't needed once the buffers have its vertices
+	Model model;
+	if (modelFilename.ends_with(".tri"))
+	{
+		model.LoadTri(modelFilename);
+	}
+	else if (modelFilename.ends_with(".obj"))
+	{
+		model.LoadObj(modelFilename);
+	}
+
+	auto geometry = std::shared_ptr<Geometry>(Geometry::Create(model.GetVertices(), model.GetSizeOfVertices(),
+															   model.GetIndices(), model.GetNumberOfIndices(),
+															   primitiveTopology, bufferLayout));
+	geometries[key.str()] = geometry;
+
+	return geometry;
+}
+
+std::shared_ptr<MeshMaterial> ResourceCache::GetMaterial(const std::string& VSfilename, const std::string& PSfilename, const std::string& GSfilename,
+														 const ConstantBufferDescription& constBufferDesc,
+														 const std::vector<TextureDescription>& textureDescriptions,
+														 const Geometry* geometry)
+{
+	std::stringstream key;
+	key << VSfilename << '|' << PSfilename << '|' << GSfilename;
+	for (auto& element : constBufferDesc)
+	{
+		key << '|' << element.name << ',' << element.size << ',' << (int)element.usage << ',' << element.count;
+	}
+	for (auto& textureDesc : textureDescriptions)
+	{
+		key << '|' << (int)textureDesc.type << ',' << textureDesc.filename;
+	}
+	if (RendererAPI::GetAPI() == RendererAPI::API::OpenGL)
+	{
+		key << '|' << geometry;
+	}
+
+	if (auto material = Find(materials, key.str()))
+	{
+		return material;
+	}
+
+	auto material = std::shared_ptr<MeshMaterial>(MeshMaterial::Create(VSfilename, PSfilename, GSfilename, constBufferDesc, textureDescriptions));
+	materials[key.str()] = material;
+
+	return material;
+}
+
+std::shared_ptr<Texture> ResourceCache::GetTexture(const std::string& filename)
+{
+	if (auto texture = Find(textures, filename))
+	{
+		return texture;
+	}
+
+	auto texture = std::shared_ptr<Texture>(Texture2D::Create(filename));
+	textures[filename] = texture;
+
+	return texture;
+}
+
+std::shared_ptr<VertexArray> ResourceCache::GetVertexArray(const std::shared_ptr<Geometry>& geometry, const std::shared_ptr<MeshMaterial>& material)
+{
+	// The meshes holding the vertex array hold the two as well, their addresses can't be taken by anything else meanwhile
+	std::pair<const Geometry*, const MeshMaterial*> key(geometry.get(), material.get());
+	if (auto vertexArray = Find(vertexArrays, key))
+	{
+		return vertexArray;
+	}
+
+	auto vertexArray = std::shared_ptr<VertexArray>(VertexArray::Create(material->shader, geometry->primitiveTopology, {}, material->textureDescriptions));
+
+	std::unordered_map<TextureType, int> texturePosition =
+	{
+		{ TextureType::Diffuse, 0 },
+		{ TextureType::Specular, 0 },
+		{ TextureType::Normal, 0 },
+		{ TextureType::Generic, 0 },
+	};
+	for (auto& [type, texture] : material->textures)
+	{
+		vertexArray->AddTexture(type, texturePosition[type]++, texture);
+	}
+
+	vertexArray->AddVertexBuffer(geometry->vertexBuffer);
+	vertexArray->AddIndexBuffer(geometry->indexBuffer);
+	vertexArray->SetupGroups(geometry->groups);
+
+	// The textures already went through their texels when they were decoded, the texture slot is a position among the diffuse ones
+	std::vector<bool> translucentSlots;
+	for (auto& [type, texture] : material->textures)
+	{
+		if (type == TextureType::Diffuse)
+		{
+			translucentSlots.push_back(texture && texture->IsTranslucent());
+		}
+	}
+	for (auto& [group, distance] : vertexArray->GetGroups())
+	{
+		if (group.textureSlot >= 0
+			&& group.textureSlot < (int)translucentSlots.size()
+			&& translucentSlots[group.textureSlot])
+		{
+			group.translucent = true;
+		}
+	}
+
+	vertexArrays[key] = vertexArray;
+
+	return vertexArray;
+}
+
+void ResourceCache::CreateGuiControls()
+{
+	ImGui::Text("Resources: %u geometries, %u materials, %u textures, %u vertex arrays",
+				Count(geometries), Count(materials), Count(textures), Count(vertexArrays));
+	ImGui::Text("Resource cache: %u of %u requests shared", hits, requests);
+}
+
+} // namespace Hedge
@@ -0,0 +1,148 @@
+#include <Renderer/ShadingBenchmark.h>
+
+#include <Component/Light.h>
+#include <Component/Transform.h>
+#include <Renderer/Renderer.h>
+
+#include <cstdio>
+#include <random>
+
+
+namespace Hedge
+{
+
+void ShadingBenchmark::Start(Scene& scene, const std::vector<int>& lightCounts, int numberOfFrames)
+{
+	if (running)
+	{
+		return;
+	}
+
+	if (!Renderer::GetDeferredShading().IsSupported()
+		|| !scene.GetPrimaryCamera())
+	{
+		printf("Shading benchmark needs render targets and a camera\n");
+		return;
+	}
+
+	this->lightCounts = lightCounts;
+	this->numberOfFrames = numberOfFrames;
+
+	deferredWasEnabled = Renderer::GetDeferredShading().enabled;
+	depthPrePassWasEnabled = Renderer::GetDepthPrePass();
+	clustersWereEnabled = scene.lightClusters.enabled;
+	scene.lightClusters.enabled = true;
+
+	results.clear();
+	running = true;
+	run = 0;
+	BeginRun(scene);
+}
+
+void ShadingBenchmark::OnFrame(Scene& scene, double frameDuration)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	frame++;
+	if (frame <= WARMUP_FRAMES)
+	{
+		return;
+	}
+
+	durationSum += frameDuration;
+	if (frame < WARMUP_FRAMES + numberOfFrames)
+	{
+		return;
+	}
+
+	EndRun(scene);
+	run++;
+
+	if (run == lightCounts.size() * (int)ShadingConfiguration::Count)
+	{
+		Finish();
+		scene.lightClusters.enabled = clustersWereEnabled;
+		return;
+	}
+
+	BeginRun(scene);
+}
+
+void ShadingBenchmark::BeginRun(Scene& scene)
+{
+	auto configuration = (ShadingConfiguration)(run % (int)ShadingConfiguration::Count);
+
+	// Same lights for all of the configurations
+	if (configuration == ShadingConfiguration::Forward)
+	{
+		std::mt19937 random(42);
+		std::uniform_real_distribution<float> offset(-30.0f, 30.0f);
+		std::uniform_real_distribution<float> hue(0.0f, 1.0f);
+		glm::vec3 center = scene.GetPrimaryCamera().Get<Transform>().GetTranslation();
+
+		for (int i = 0; i < lightCounts[run / (int)ShadingConfiguration::Count]; i++)
+		{
+			auto entity = scene.CreateEntity("Benchmark Point Light");
+			auto& light = entity.Add<PointLight>();
+			light.color = glm::vec3(hue(random), hue(random), hue(random));
+			light.attenuation = glm::vec3(1.0f, 0.35f, 0.44f);
+			light.position = center + glm::vec3(offset(random), offset(random) * 0.25f, offset(random));
+			lights.push_back(entity);
+		}
+	}
+
+	Renderer::GetDeferredShading().enabled = configuration == ShadingConfiguration::Deferred
+		|| configuration == ShadingConfiguration::DeferredDepthPrePass;
+	Renderer::SetDepthPrePass(configuration == ShadingConfiguration::ForwardDepthPrePass
+							  || configuration == ShadingConfiguration::DeferredDepthPrePass);
+	frame = 0;
+	durationSum = 0.0;
+}
+
+void ShadingBenchmark::EndRun(Scene& scene)
+{
+	auto configuration = (ShadingConfiguration)(run % (int)ShadingConfiguration::Count);
+
+	if (configuration == ShadingConfiguration::Forward)
+	{
+		ShadingBenchmarkResult result;
+		result.numberOfLights = lightCounts[run / (int)ShadingConfiguration::Count];
+		results.push_back(result);
+	}
+
+	results.back().durations[(int)configuration] = durationSum / numberOfFrames;
+
+	if (configuration != ShadingConfiguration::DeferredDepthPrePass)
+	{
+		return;
+	}
+
+	for (auto& light : lights)
+	{
+		scene.DestroyEntity(light);
+	}
+	lights.clear();
+}
+
+void ShadingBenchmark::Finish()
+{
+	running = false;
+	Renderer::GetDeferredShading().enabled = deferredWasEnabled;
+	Renderer::SetDepthPrePass(depthPrePassWasEnabled);
+
+	printf("Shading benchmark, clustered lights, %d frames each, in ms per frame\n", numberOfFrames);
+	printf("%10s %12s %12s %12s %12s\n", "lights", "forward", "+pre-pass", "deferred", "+pre-pass");
+	for (const auto& result : results)
+	{
+		printf("%10d %12.3f %12.3f %12.3f %12.3f\n", result.numberOfLights,
+			   result.durations[(int)ShadingConfiguration::Forward],
+			   result.durations[(int)ShadingConfiguration::ForwardDepthPrePass],
+			   result.durations[(int)ShadingConfiguration::Deferred],
+			   result.durations[(int)ShadingConfiguration::DeferredDepthPrePass]);
+	}
+}
+
+} // namespace Hedge
@@ -26,4 +26,39 @@ Texture2D* Texture2D::Create(const std::string& filename)
 	}
 }
 
+Texture2D* Texture2D::Create(unsigned int width, unsigned int height, const float* data)
+{
+	switch (Renderer::GetAPI())
+	{
+	case RendererAPI::API::OpenGL:
+		return new OpenGLTexture2D(width, height, data);
+
+	// TODO DirectX12 and Vulkan float textures
+	case RendererAPI::API::None:
+		return nullptr;
+
+	default:
+		return nullptr;
+	}
+}
+
+bool Texture2D::HasTranslucentTexels(const unsigned char* data, unsigned int width, unsigned int height, int channels)
+{
+	if (!data
+		|| (channels != 2 && channels != 4))
+	{
+		return false;
+	}
+
+	for (size_t texel = 0; texel < (size_t)width * height; texel++)
+	{
+		if (data[texel * channels + channels - 1] < 255)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 } // namespace Hedge
@@ -1,8 +1,12 @@
 #include <Renderer/VulkanBuffer.h>
 
 #include <Renderer/VulkanContext.h>
+#include <Renderer/RenderCommand.h>
 #include <Application/Application.h>
 
+#include <algorithm>
+#include <cstring>
+
 
 namespace Hedge
 {
@@ -14,6 +18,7 @@ VulkanVertexBuffer::VulkanVertexBuffer(const BufferLayout& layout,
 	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
 
 	this->layout = layout;
+	this->size = size;
 
 	vulkanContext->CreateStagedBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 									  (void*)vertices,
@@ -27,15 +32,28 @@ VulkanVertexBuffer::~VulkanVertexBuffer()
 	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
 
 	vulkanContext->DestoyVulkanBuffer(vertexBuffer, vertexBufferMemory);
+	if (fallbackBuffer != VK_NULL_HANDLE)
+	{
+		vkUnmapMemory(vulkanContext->device, fallbackBufferMemory);
+		vulkanContext->DestoyVulkanBuffer(fallbackBuffer, fallbackBufferMemory);
+	}
 }
 
 void VulkanVertexBuffer::Bind(unsigned int slot) const
 {
 	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
 
+	auto streamBuffer = RenderCommand::GetStreamBuffer();
+	unsigned long long frame = streamBuffer ? streamBuffer->GetFrame() : 0;
+	if (!dynamicData.empty()
+		&& (!streamed || streamFrame != frame))
+	{
+		Stream();
+	}
+
 	// TODO maybe this should be done in the vertex array, especiall if there are multiple vertex buffers
-	VkBuffer vertexBuffers[] = { vertexBuffer };
-	VkDeviceSize vertexBufferOffsets[] = { 0 };
+	VkBuffer vertexBuffers[] = { streamed ? streamSource : vertexBuffer };
+	VkDeviceSize vertexBufferOffsets[] = { streamed ? streamOffset : 0 };
 	vkCmdBindVertexBuffers(vulkanContext->commandBuffers[vulkanContext->swapChainImageIndex],
 						   slot,
 						   1, // bindingCount
@@ -45,8 +63,53 @@ void VulkanVertexBuffer::Bind(unsigned int slot) const
 
 void VulkanVertexBuffer::SetData(const float* vertices, unsigned int size)
 {
-	// Not implemented
-	assert(false);
+	// TODO resizing, the static buffer would have to be recreated once the GPU is done with it
+	assert(size <= this->size);
+
+	// Whatever isn't set keeps the data of the last call
+	dynamicData.resize(this->size / sizeof(float));
+	memcpy(dynamicData.data(), vertices, size);
+
+	Stream();
+}
+
+void VulkanVertexBuffer::Stream() const
+{
+	auto streamBuffer = dynamic_cast<VulkanStreamBuffer*>(RenderCommand::GetStreamBuffer());
+	StreamBuffer::Allocation allocation = streamBuffer ? streamBuffer->Allocate(size) : StreamBuffer::Allocation();
+	streamFrame = streamBuffer ? streamBuffer->GetFrame() : 0;
+	streamed = true;
+	if (allocation.data)
+	{
+		memcpy(allocation.data, dynamicData.data(), size);
+		streamSource = streamBuffer->GetBuffer();
+		streamOffset = allocation.offset;
+		return;
+	}
+
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	// The static buffer still has the data it was created with, so the data goes into a buffer of its own
+	if (fallbackBuffer == VK_NULL_HANDLE)
+	{
+		VkDeviceSize fallbackSize = (VkDeviceSize)size * VulkanContext::NUM_FRAMES_IN_FLIGHT;
+		vulkanContext->CreateBuffer(fallbackSize,
+									VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+									VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+									&fallbackBuffer,
+									&fallbackBufferMemory);
+
+		void* data = nullptr;
+		if (vkMapMemory(vulkanContext->device, fallbackBufferMemory, 0, fallbackSize, 0, &data) != VK_SUCCESS)
+		{
+			assert(false);
+		}
+		fallbackData = static_cast<uint8_t*>(data);
+	}
+
+	streamSource = fallbackBuffer;
+	streamOffset = (VkDeviceSize)size * vulkanContext->frameInFlightIndex;
+	memcpy(fallbackData + streamOffset, dynamicData.data(), size);
 }
 
 
@@ -81,4 +144,238 @@ void VulkanIndexBuffer::Bind() const
 						 VK_INDEX_TYPE_UINT32);
 }
 
+
+VulkanConstantBuffer::VulkanConstantBuffer(unsigned int size)
+	: size(size)
+{
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(vulkanContext->chosenGPU, &properties);
+	VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+	sliceSize = (size + alignment - 1) / alignment * alignment;
+
+	VkDeviceSize bufferSize = sliceSize * VulkanContext::NUM_FRAMES_IN_FLIGHT;
+	vulkanContext->CreateBuffer(bufferSize,
+								VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+								VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+								&buffer,
+								&bufferMemory);
+
+	void* data = nullptr;
+	if (vkMapMemory(vulkanContext->device, bufferMemory, 0, bufferSize, 0, &data) != VK_SUCCESS)
+	{
+		assert(false);
+	}
+	mappedData = static_cast<uint8_t*>(data);
+
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.descriptorPool = vulkanContext->descriptorPool;
+	descriptorSetAllocateInfo.descriptorSetCount = 1;
+	descriptorSetAllocateInfo.pSetLayouts = &vulkanContext->sharedConstantsLayout;
+	if (vkAllocateDescriptorSets(vulkanContext->device, &descriptorSetAllocateInfo, &descriptorSet) != VK_SUCCESS)
+	{
+		assert(false);
+	}
+
+	// The slice is picked with the dynamic offset when the set is bound
+	VkDescriptorBufferInfo descriptorBufferInfo{};
+	descriptorBufferInfo.buffer = buffer;
+	descriptorBufferInfo.offset = 0;
+	descriptorBufferInfo.range = size;
+
+	VkWriteDescriptorSet descriptorWrite{};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = descriptorSet;
+	descriptorWrite.dstBinding = 0;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pBufferInfo = &descriptorBufferInfo;
+	vkUpdateDescriptorSets(vulkanContext->device, 1, &descriptorWrite, 0, nullptr);
+}
+
+VulkanConstantBuffer::~VulkanConstantBuffer()
+{
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	if (vulkanContext->sharedConstantsSet == descriptorSet)
+	{
+		vulkanContext->sharedConstantsSet = VK_NULL_HANDLE;
+	}
+	vkFreeDescriptorSets(vulkanContext->device, vulkanContext->descriptorPool, 1, &descriptorSet);
+	vkUnmapMemory(vulkanContext->device, bufferMemory);
+	vulkanContext->DestoyVulkanBuffer(buffer, bufferMemory);
+}
+
+void VulkanConstantBuffer::Bind(unsigned int binding) const
+{
+	// TODO more shared constant buffers need more bindings in the shared set
+	assert(binding == 0);
+
+	auto streamBuffer = RenderCommand::GetStreamBuffer();
+	if (streamed
+		&& streamBuffer
+		&& streamBuffer->GetFrame() == streamFrame)
+	{
+		streamBuffer->BindConstants(binding, streamOffset, size);
+		return;
+	}
+
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	// Takes effect when the next shader is bound
+	vulkanContext->sharedConstantsSet = descriptorSet;
+	vulkanContext->sharedConstantsOffset = (uint32_t)(sliceSize * vulkanContext->frameInFlightIndex);
+}
+
+void VulkanConstantBuffer::SetData(const void* data, unsigned int size)
+{
+	assert(size == this->size);
+
+	auto streamBuffer = RenderCommand::GetStreamBuffer();
+	StreamBuffer::Allocation allocation = streamBuffer ? streamBuffer->Allocate(size) : StreamBuffer::Allocation();
+	streamed = allocation.data != nullptr;
+	if (streamed)
+	{
+		memcpy(allocation.data, data, size);
+		streamOffset = allocation.offset;
+		streamFrame = streamBuffer->GetFrame();
+		return;
+	}
+
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	memcpy(mappedData + sliceSize * vulkanContext->frameInFlightIndex, data, size);
+}
+
+
+VulkanStreamBuffer::VulkanStreamBuffer(unsigned int regionSize)
+{
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	// Allocations may be bound as any kind of buffer
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(vulkanContext->chosenGPU, &properties);
+	alignment = (unsigned int)std::max({ (VkDeviceSize)16,
+										 properties.limits.minUniformBufferOffsetAlignment,
+										 properties.limits.minStorageBufferOffsetAlignment });
+	this->regionSize = (regionSize + alignment - 1) / alignment * alignment;
+
+	// The ranges start at the dynamic offsets, the buffer is padded so those of the last region stay inside it
+	constantsRange = std::min((VkDeviceSize)properties.limits.maxUniformBufferRange, (VkDeviceSize)this->regionSize);
+	storageRange = std::min((VkDeviceSize)properties.limits.maxStorageBufferRange, (VkDeviceSize)this->regionSize);
+
+	VkDeviceSize size = (VkDeviceSize)this->regionSize * VulkanContext::NUM_FRAMES_IN_FLIGHT + std::max(constantsRange, storageRange);
+	vulkanContext->CreateBuffer(size,
+								VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+								| VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+								VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+								&buffer,
+								&bufferMemory);
+
+	// Kept mapped for the life of the buffer
+	void* data = nullptr;
+	VkResult result = vkMapMemory(vulkanContext->device, bufferMemory, 0, size, 0, &data);
+	if (result != VK_SUCCESS)
+	{
+		assert(false);
+	}
+	mappedData = static_cast<uint8_t*>(data);
+
+	VkDescriptorSetLayout setLayouts[] = { vulkanContext->sharedConstantsLayout, vulkanContext->sharedStorageLayout };
+	VkDescriptorSet sets[2] = {};
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.descriptorPool = vulkanContext->descriptorPool;
+	descriptorSetAllocateInfo.descriptorSetCount = 2;
+	descriptorSetAllocateInfo.pSetLayouts = setLayouts;
+	if (vkAllocateDescriptorSets(vulkanContext->device, &descriptorSetAllocateInfo, sets) != VK_SUCCESS)
+	{
+		assert(false);
+	}
+	constantsSet = sets[0];
+	storageSet = sets[1];
+
+	// Every binding starts at the beginning of the buffer, the allocations are picked with the dynamic offsets
+	VkDescriptorBufferInfo constantsInfo{};
+	constantsInfo.buffer = buffer;
+	constantsInfo.offset = 0;
+	constantsInfo.range = constantsRange;
+
+	VkDescriptorBufferInfo storageInfo{};
+	storageInfo.buffer = buffer;
+	storageInfo.offset = 0;
+	storageInfo.range = storageRange;
+
+	std::vector<VkWriteDescriptorSet> descriptorWrites(1 + VulkanContext::NUM_SHARED_STORAGE_BINDINGS, VkWriteDescriptorSet{});
+	for (uint32_t i = 0; i < descriptorWrites.size(); i++)
+	{
+		descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[i].dstSet = i == 0 ? constantsSet : storageSet;
+		descriptorWrites[i].dstBinding = i == 0 ? 0 : i - 1;
+		descriptorWrites[i].dstArrayElement = 0;
+		descriptorWrites[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+		descriptorWrites[i].descriptorCount = 1;
+		descriptorWrites[i].pBufferInfo = i == 0 ? &constantsInfo : &storageInfo;
+	}
+	vkUpdateDescriptorSets(vulkanContext->device,
+						   static_cast<uint32_t>(descriptorWrites.size()),
+						   descriptorWrites.data(),
+						   0,
+						   nullptr);
+}
+
+VulkanStreamBuffer::~VulkanStreamBuffer()
+{
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	if (vulkanContext->sharedConstantsSet == constantsSet)
+	{
+		vulkanContext->sharedConstantsSet = VK_NULL_HANDLE;
+	}
+	if (vulkanContext->sharedStorageSet == storageSet)
+	{
+		vulkanContext->sharedStorageSet = VK_NULL_HANDLE;
+	}
+	VkDescriptorSet sets[] = { constantsSet, storageSet };
+	vkFreeDescriptorSets(vulkanContext->device, vulkanContext->descriptorPool, 2, sets);
+	vkUnmapMemory(vulkanContext->device, bufferMemory);
+	vulkanContext->DestoyVulkanBuffer(buffer, bufferMemory);
+}
+
+void VulkanStreamBuffer::BeginFrame()
+{
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	// The fence of the frame in flight was waited on when the swapchain image was acquired
+	BeginRegion((unsigned int)vulkanContext->frameInFlightIndex);
+}
+
+void VulkanStreamBuffer::BindStorage(unsigned int binding, unsigned int offset, unsigned int size) const
+{
+	assert(binding < VulkanContext::NUM_SHARED_STORAGE_BINDINGS);
+	assert(size <= storageRange);
+
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	// Takes effect when the next shader is bound, the other bindings keep their offsets
+	vulkanContext->sharedStorageSet = storageSet;
+	vulkanContext->sharedStorageOffsets[binding] = offset;
+}
+
+void VulkanStreamBuffer::BindConstants(unsigned int binding, unsigned int offset, unsigned int size) const
+{
+	// TODO more shared constant buffers need more bindings in the shared set
+	assert(binding == 0);
+	assert(size <= constantsRange);
+
+	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
+
+	// Takes effect when the next shader is bound
+	vulkanContext->sharedConstantsSet = constantsSet;
+	vulkanContext->sharedConstantsOffset = offset;
+}
+
 } // namespace Hedge
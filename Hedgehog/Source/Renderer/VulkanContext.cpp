@@ -22,10 +22,15 @@ VulkanContext::VulkanContext(HWND windowHandle)
 					   Application::GetInstance().GetWindow().GetHeight());
 	CreateSyncObjects();
 	CreateDescriptorPool();
+	CreateQueryPool();
+	CreateSharedDescriptorSetLayouts();
 }
 
 VulkanContext::~VulkanContext()
 {
+	vkDestroyDescriptorSetLayout(device, sharedStorageLayout, nullptr);
+	vkDestroyDescriptorSetLayout(device, sharedConstantsLayout, nullptr);
+	vkDestroyQueryPool(device, occlusionQueryPool, nullptr);
 	vkDestroyDescriptorPool(device, descriptorPool, nullptr);
 	DestroySyncObjects();
 	vkDestroyImageView(device, depthImageView, nullptr);
@@ -383,13 +388,15 @@ void VulkanContext::CreateDescriptorPool()
 		// type,                                     descriptorCount
 		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         1000 },
 		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 16 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 16 },
 	};
 
 	VkDescriptorPoolCreateInfo descriptorPoolInfo{};
 	descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 	descriptorPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 	descriptorPoolInfo.maxSets = 2 * 1000;
-	descriptorPoolInfo.poolSizeCount = 2;
+	descriptorPoolInfo.poolSizeCount = (uint32_t)std::size(poolSizes);
 	descriptorPoolInfo.pPoolSizes = poolSizes;
 
 	if (vkCreateDescriptorPool(device, &descriptorPoolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
@@ -398,6 +405,88 @@ void VulkanContext::CreateDescriptorPool()
 	}
 }
 
+void VulkanContext::CreateQueryPool()
+{
+	VkQueryPoolCreateInfo queryPoolInfo{};
+	queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+	queryPoolInfo.queryCount = NUM_OCCLUSION_QUERIES;
+
+	if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &occlusionQueryPool) != VK_SUCCESS)
+	{
+		assert(false);
+	}
+}
+
+void VulkanContext::CreateSharedDescriptorSetLayouts()
+{
+	// Dynamic, so the frames in flight only differ in the offset and one set will do
+	VkDescriptorSetLayoutBinding constantsBinding{};
+	constantsBinding.binding = 0;
+	constantsBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	constantsBinding.descriptorCount = 1;
+	constantsBinding.stageFlags = VK_SHADER_STAGE_ALL;
+	constantsBinding.pImmutableSamplers = nullptr;
+
+	VkDescriptorSetLayoutCreateInfo constantsLayoutInfo{};
+	constantsLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	constantsLayoutInfo.bindingCount = 1;
+	constantsLayoutInfo.pBindings = &constantsBinding;
+
+	if (vkCreateDescriptorSetLayout(device, &constantsLayoutInfo, nullptr, &sharedConstantsLayout) != VK_SUCCESS)
+	{
+		assert(false);
+	}
+
+	VkDescriptorSetLayoutBinding storageBindings[NUM_SHARED_STORAGE_BINDINGS]{};
+	for (uint32_t binding = 0; binding < NUM_SHARED_STORAGE_BINDINGS; binding++)
+	{
+		storageBindings[binding].binding = binding;
+		storageBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+		storageBindings[binding].descriptorCount = 1;
+		storageBindings[binding].stageFlags = VK_SHADER_STAGE_ALL;
+		storageBindings[binding].pImmutableSamplers = nullptr;
+	}
+
+	VkDescriptorSetLayoutCreateInfo storageLayoutInfo{};
+	storageLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	storageLayoutInfo.bindingCount = NUM_SHARED_STORAGE_BINDINGS;
+	storageLayoutInfo.pBindings = storageBindings;
+
+	if (vkCreateDescriptorSetLayout(device, &storageLayoutInfo, nullptr, &sharedStorageLayout) != VK_SUCCESS)
+	{
+		assert(false);
+	}
+}
+
+void VulkanContext::BindSharedDescriptorSets(VkPipelineLayout pipelineLayout)
+{
+	// Sets that nothing was bound to yet are left out, shaders that read them are drawn without them
+	if (sharedConstantsSet != VK_NULL_HANDLE)
+	{
+		vkCmdBindDescriptorSets(commandBuffers[swapChainImageIndex],
+								VK_PIPELINE_BIND_POINT_GRAPHICS,
+								pipelineLayout,
+								0, // firstSet
+								1, // descriptorSetCount
+								&sharedConstantsSet,
+								1, // dynamicOffsetCount
+								&sharedConstantsOffset);
+	}
+
+	if (sharedStorageSet != VK_NULL_HANDLE)
+	{
+		vkCmdBindDescriptorSets(commandBuffers[swapChainImageIndex],
+								VK_PIPELINE_BIND_POINT_GRAPHICS,
+								pipelineLayout,
+								1, // firstSet
+								1, // descriptorSetCount
+								&sharedStorageSet,
+								NUM_SHARED_STORAGE_BINDINGS,
+								sharedStorageOffsets);
+	}
+}
+
 void VulkanContext::DestroySwapChain()
 {
 	vkDestroySwapchainKHR(device, swapchain, nullptr);
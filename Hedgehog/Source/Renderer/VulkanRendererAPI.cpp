@@ -4,6 +4,8 @@
 
 #include <backends/imgui_impl_vulkan.h>
 
+#include <algorithm>
+
 
 namespace Hedge
 {
@@ -11,6 +13,12 @@ namespace Hedge
 void VulkanRendererAPI::Init(RenderContext* renderContext)
 {
 	this->renderContext = dynamic_cast<VulkanContext*>(renderContext);
+
+	// Queries start out in an undefined state, all of them get reset with the first frame
+	for (uint32_t query = 0; query < VulkanContext::NUM_OCCLUSION_QUERIES; query++)
+	{
+		queriesToReset.push_back(query);
+	}
 }
 
 void VulkanRendererAPI::Resize(int width, int height, bool fillViewport)
@@ -50,15 +58,24 @@ void VulkanRendererAPI::SetScissor(int x, int y, int width, int height)
 	scissor.extent.height = height;
 }
 
+void VulkanRendererAPI::Begin()
+{
+	streamBuffer = std::make_unique<VulkanStreamBuffer>(StreamBuffer::REGION_SIZE);
+}
+
 void VulkanRendererAPI::End()
 {
 	vkDeviceWaitIdle(renderContext->device);
+
+	streamBuffer.reset();
 }
 
 void VulkanRendererAPI::BeginFrame()
 {
 	uint32_t swapchainImageIndex = renderContext->WaitForNextFrame();
 
+	streamBuffer->BeginFrame();
+
 	VkCommandBuffer commandBuffer = renderContext->commandBuffers[renderContext->swapChainImageIndex];
 
 	//now that we are sure that the commands finished executing, we can safely reset the command buffer to begin recording again.
@@ -80,6 +97,23 @@ void VulkanRendererAPI::BeginFrame()
 		assert(false);
 	}
 
+	// Not allowed inside of a render pass, ranges of consecutive queries are reset together
+	std::sort(queriesToReset.begin(), queriesToReset.end());
+	for (size_t first = 0; first < queriesToReset.size();)
+	{
+		size_t last = first;
+		while (last + 1 < queriesToReset.size()
+			   && queriesToReset[last + 1] == queriesToReset[last] + 1)
+		{
+			last++;
+		}
+
+		vkCmdResetQueryPool(commandBuffer, renderContext->occlusionQueryPool, queriesToReset[first], static_cast<uint32_t>(last - first + 1));
+		first = last + 1;
+	}
+	freeQueries.insert(freeQueries.end(), queriesToReset.begin(), queriesToReset.end());
+	queriesToReset.clear();
+
 
 	std::vector<VkClearValue> clearValues;
 	clearValues.resize(2, {});
@@ -111,6 +145,8 @@ void VulkanRendererAPI::BeginFrame()
 
 void VulkanRendererAPI::EndFrame()
 {
+	streamBuffer->EndFrame();
+
 	VkCommandBuffer commandBuffer = renderContext->commandBuffers[renderContext->swapChainImageIndex];
 
 	//finalize the render pass
@@ -154,16 +190,70 @@ void VulkanRendererAPI::EndFrame()
 	renderContext->SwapBuffers();
 
 	renderContext->frameInFlightIndex = (renderContext->frameInFlightIndex + 1) % renderContext->NUM_FRAMES_IN_FLIGHT;
+	renderContext->frameNumber++;
 }
 
-void VulkanRendererAPI::DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, unsigned int count, unsigned int offset)
+void VulkanRendererAPI::DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, unsigned int count, unsigned int offset, unsigned int instanceCount)
 {
 	vkCmdDrawIndexed(renderContext->commandBuffers[renderContext->swapChainImageIndex],
 					 count > 0 ? count * 3 : vertexArray->GetIndexBuffer()->GetCount(),
-					 vertexArray->GetInstanceCount(), 
+					 instanceCount > 0 ? instanceCount : vertexArray->GetInstanceCount(),
 					 offset * 3,
 					 0, // vertexOffset
 					 0); // firstInstance
 }
 
+int VulkanRendererAPI::CreateOcclusionQuery()
+{
+	if (freeQueries.empty())
+	{
+		return -1;
+	}
+
+	uint32_t query = freeQueries.back();
+	freeQueries.pop_back();
+
+	return (int)query;
+}
+
+void VulkanRendererAPI::DestroyOcclusionQuery(int query)
+{
+	queriesToReset.push_back((uint32_t)query);
+}
+
+void VulkanRendererAPI::BeginOcclusionQuery(int query)
+{
+	// No precise bit, any samples is all that is needed
+	vkCmdBeginQuery(renderContext->commandBuffers[renderContext->swapChainImageIndex],
+					renderContext->occlusionQueryPool,
+					(uint32_t)query,
+					0);
+}
+
+void VulkanRendererAPI::EndOcclusionQuery(int query)
+{
+	vkCmdEndQuery(renderContext->commandBuffers[renderContext->swapChainImageIndex],
+				  renderContext->occlusionQueryPool,
+				  (uint32_t)query);
+}
+
+bool VulkanRendererAPI::GetOcclusionQueryResult(int query, unsigned long long& samples)
+{
+	uint64_t result = 0;
+	VkResult status = vkGetQueryPoolResults(renderContext->device,
+											renderContext->occlusionQueryPool,
+											(uint32_t)query, 1,
+											sizeof(result), &result, sizeof(result),
+											VK_QUERY_RESULT_64_BIT);
+	if (status != VK_SUCCESS)
+	{
+		// VK_NOT_READY until the frame that ended the query is done on the GPU
+		return false;
+	}
+
+	samples = result;
+
+	return true;
+}
+
 } // namespace Hedge
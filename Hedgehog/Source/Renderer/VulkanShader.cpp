@@ -60,6 +60,31 @@ void VulkanShader::Bind()
 {
 	VulkanContext* vulkanContext = dynamic_cast<VulkanContext*>(Application::GetInstance().GetRenderContext());
 
+	vulkanContext->BindSharedDescriptorSets(pipelineLayout);
+
+	// Constants of a recorded draw, other pipelines may have been bound since, so all of the sets are bound again
+	// Scene data is only uploaded once per frame, into the first slot
+	if (selectedSlot != -1)
+	{
+		std::vector<VkDescriptorSet> selectedDescriptorSets = descriptorSets[selectedSlot][vulkanContext->swapChainImageIndex];
+		if (uniformBuffers.contains(ConstantBufferUsage::Scene))
+		{
+			selectedDescriptorSets[0] = descriptorSets[0][vulkanContext->swapChainImageIndex][0];
+		}
+
+		vkCmdBindDescriptorSets(vulkanContext->commandBuffers[vulkanContext->swapChainImageIndex],
+								VK_PIPELINE_BIND_POINT_GRAPHICS,
+								pipelineLayout,
+								VulkanContext::NUM_SHARED_DESCRIPTOR_SETS,
+								static_cast<uint32_t>(selectedDescriptorSets.size()),
+								selectedDescriptorSets.data(),
+								0,
+								nullptr);
+
+		selectedSlot = -1;
+		return;
+	}
+
 	// For each draw call using the same pipeline within one frame we need a separate desriptor sets
 	// which point to the same uniform buffer but with per-call offsets
 	// TODO Other way to do this would be to use dynamic uniform buffers
@@ -73,7 +98,7 @@ void VulkanShader::Bind()
 
 	std::vector<VkDescriptorSet> currentDescriptorSets = descriptorSets[bindCount][vulkanContext->swapChainImageIndex];
 
-	uint32_t firstSet = 0;
+	uint32_t firstSet = VulkanContext::NUM_SHARED_DESCRIPTOR_SETS;
 	uint32_t descriptorSetCount = static_cast<uint32_t>(currentDescriptorSets.size());
 	VkDescriptorSet* pDescriptorSets = currentDescriptorSets.data();
 	// If there is a descriptor set for scene data, it is enough to bind it only once per frame
@@ -83,7 +108,7 @@ void VulkanShader::Bind()
 		&& uniformBuffers.contains(ConstantBufferUsage::Scene))
 	{
 		// Descriptor set for scene data is always first in the current implementation
-		firstSet = 1;
+		firstSet++;
 		descriptorSetCount--;
 		pDescriptorSets = &currentDescriptorSets.data()[1];
 	}
@@ -108,6 +133,16 @@ void VulkanShader::Unbind()
 	bindCount = 0;
 }
 
+unsigned int VulkanShader::CommitConstants()
+{
+	if (bindCount + 1 > descriptorSets.size())
+	{
+		descriptorSets.push_back(CreateDescriptorSets());
+	}
+
+	return static_cast<unsigned int>(bindCount++);
+}
+
 void VulkanShader::SetupConstantBuffers(ConstantBufferDescription constBufferDesc)
 {
 	uniformBufferDescription = constBufferDesc;
@@ -453,8 +488,12 @@ VkPipelineLayout VulkanShader::CreatePipelineLayout(std::vector<VkDescriptorSetL
 	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 
-	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
-	pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();;
+	// The shared sets come first, so they stay bound when the pipeline changes
+	std::vector<VkDescriptorSetLayout> setLayouts = { vulkanContext->sharedConstantsLayout, vulkanContext->sharedStorageLayout };
+	setLayouts.insert(setLayouts.end(), descriptorSetLayouts.begin(), descriptorSetLayouts.end());
+
+	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+	pipelineLayoutInfo.pSetLayouts = setLayouts.data();
 
 	pipelineLayoutInfo.pushConstantRangeCount = 0;
 	pipelineLayoutInfo.pPushConstantRanges = nullptr;
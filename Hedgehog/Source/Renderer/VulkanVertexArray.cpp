@@ -39,18 +39,24 @@ VulkanVertexArray::VulkanVertexArray(const std::shared_ptr<Shader>& inputShader,
 
 VulkanVertexArray::~VulkanVertexArray()
 {
-	vkDestroyPipeline(vulkanContext->device, pipeline, nullptr);
+	// The pipelines go with the last vertex array using them
 }
 
 void VulkanVertexArray::Bind()
 {
-	if (pipeline == VK_NULL_HANDLE)
+	if (!pipeline)
 	{
 		vertexInputState = CreateVertexInputState();
 		CreatePipeline();
 	}
 
-	vkCmdBindPipeline(vulkanContext->commandBuffers[vulkanContext->swapChainImageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	// BeginFrame waited for the fence of the frame NUM_FRAMES_IN_FLIGHT ago, nothing older uses them anymore
+	std::erase_if(retiredPipelines, [this](const auto& retired)
+		{
+			return retired.second + VulkanContext::NUM_FRAMES_IN_FLIGHT <= vulkanContext->frameNumber;
+		});
+
+	vkCmdBindPipeline(vulkanContext->commandBuffers[vulkanContext->swapChainImageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline);
 
 	shader->Bind();
 
@@ -89,19 +95,32 @@ void VulkanVertexArray::SetupGroups(const std::vector<VertexGroup>& groups)
 
 void VulkanVertexArray::ResizeViewport()
 {
-	// TODO we can't just destroy the current pipeline here, it's most likely still in use
-	// for now, just leak it and create a new one
-	//vkDestroyPipeline(vulkanContext->device, pipeline, nullptr);
-
 	const VulkanRendererAPI* renderer = dynamic_cast<const VulkanRendererAPI*>(RenderCommand::GetRenderer());
 	viewport = renderer->GetViewport();
 	scissor = renderer->GetScissor();
 
+	// Not bound yet, it gets the new viewport when it is
+	if (!pipeline)
+	{
+		return;
+	}
+
+	// We can't just destroy the current pipeline here, it's most likely still in use
+	retiredPipelines.emplace_back(pipeline, vulkanContext->frameNumber);
+
 	CreatePipeline();
 }
 
 void VulkanVertexArray::CreatePipeline()
 {
+	// Vertex arrays of the same shader and vertex layout, drawn with the same render state, end up with the same pipeline
+	std::string key = CreatePipelineKey();
+	pipeline = pipelineCache[key].lock();
+	if (pipeline)
+	{
+		return;
+	}
+
 	VkGraphicsPipelineCreateInfo pipelineInfo{};
 	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 
@@ -122,10 +141,55 @@ void VulkanVertexArray::CreatePipeline()
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 	pipelineInfo.basePipelineIndex = -1;
 
-	if (vkCreateGraphicsPipelines(vulkanContext->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+	pipeline = std::make_shared<Pipeline>();
+	pipeline->device = vulkanContext->device;
+	if (vkCreateGraphicsPipelines(vulkanContext->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline->pipeline) != VK_SUCCESS)
 	{
 		assert(false);
 	}
+
+	std::erase_if(pipelineCache, [](const auto& cached) { return cached.second.expired(); });
+	pipelineCache[key] = pipeline;
+}
+
+std::string VulkanVertexArray::CreatePipelineKey() const
+{
+	std::string key;
+	auto append = [&key](const void* data, size_t size)
+	{
+		key.append(static_cast<const char*>(data), size);
+	};
+
+	// The shader modules and the layout come with the shader
+	const VulkanShader* shaderPointer = shader.get();
+	append(&shaderPointer, sizeof(shaderPointer));
+	append(&vulkanContext->renderPass, sizeof(vulkanContext->renderPass));
+
+	append(&inputAssemblyState.topology, sizeof(inputAssemblyState.topology));
+	for (auto& binding : vertexBindingDescriptions)
+	{
+		append(&binding, sizeof(binding));
+	}
+	for (auto& divisor : vertexBindingDivisorDescriptions)
+	{
+		append(&divisor, sizeof(divisor));
+	}
+	for (auto& attribute : vertexAttributeDescriptions)
+	{
+		append(&attribute, sizeof(attribute));
+	}
+
+	append(&viewport, sizeof(viewport));
+	append(&scissor, sizeof(scissor));
+	append(&rasterizationState.polygonMode, sizeof(rasterizationState.polygonMode));
+	append(&rasterizationState.cullMode, sizeof(rasterizationState.cullMode));
+
+	VkBool32 depthTest = RenderCommand::GetDepthTest() ? VK_TRUE : VK_FALSE;
+	append(&depthTest, sizeof(depthTest));
+	append(&depthStencilState.depthWriteEnable, sizeof(depthStencilState.depthWriteEnable));
+	append(&colorBlendAttachmentState.colorWriteMask, sizeof(colorBlendAttachmentState.colorWriteMask));
+
+	return key;
 }
 
 VkPipelineVertexInputStateCreateInfo VulkanVertexArray::CreateVertexInputState()
@@ -252,7 +316,7 @@ VkPipelineDepthStencilStateCreateInfo VulkanVertexArray::CreateDepthStencilState
 
 	depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
 	depthStencilState.depthTestEnable = VK_TRUE;
-	depthStencilState.depthWriteEnable = VK_TRUE;
+	depthStencilState.depthWriteEnable = RenderCommand::GetDepthWrite() ? VK_TRUE : VK_FALSE;
 	depthStencilState.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
 	depthStencilState.depthBoundsTestEnable = VK_FALSE;
 	depthStencilState.stencilTestEnable = VK_FALSE;
@@ -271,7 +335,9 @@ VkPipelineColorBlendAttachmentState VulkanVertexArray::CreateColorBlendAttachmen
 	colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
 	colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
 	colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
-	colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	colorBlendAttachmentState.colorWriteMask = RenderCommand::GetColorWrite()
+		? VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+		: 0;
 
 	return colorBlendAttachmentState;
 }
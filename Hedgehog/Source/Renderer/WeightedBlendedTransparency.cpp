@@ -0,0 +1,129 @@
+#include <Renderer/WeightedBlendedTransparency.h>
+
+#include <Application/Application.h>
+#include <Renderer/Renderer.h>
+
+#include <imgui.h>
+
+
+namespace Hedge
+{
+
+bool WeightedBlendedTransparency::IsSupported() const
+{
+	return RenderCommand::SupportsRenderTargets();
+}
+
+bool WeightedBlendedTransparency::IsActive() const
+{
+	return enabled
+		&& IsSupported();
+}
+
+void WeightedBlendedTransparency::Begin()
+{
+	auto& window = Application::GetInstance().GetWindow();
+	if (!target
+		|| target->GetDescription().width != window.GetWidth()
+		|| target->GetDescription().height != window.GetHeight())
+	{
+		RenderTargetDescription description;
+		description.width = window.GetWidth();
+		description.height = window.GetHeight();
+		description.colorFormats = { RenderTargetFormat::RGBA16F, RenderTargetFormat::RGBA8 };
+		description.depth = true;
+		target.reset(RenderTarget::Create(description));
+	}
+
+	if (!compositeVertexArray)
+	{
+		CreateCompositeVertexArray();
+	}
+
+	target->ClearColor(Accumulation, glm::vec4(0.0f));
+	target->ClearColor(Revealage, glm::vec4(1.0f));
+	target->CopyDepthFromWindow();
+	target->Bind();
+
+	depthWrite = RenderCommand::GetDepthWrite();
+	blending = RenderCommand::GetBlending();
+	RenderCommand::SetDepthWrite(false);
+	RenderCommand::SetBlending(true);
+	RenderCommand::SetBlendMode(BlendMode::WeightedBlended);
+
+	numberOfDraws = 0;
+}
+
+void WeightedBlendedTransparency::End()
+{
+	target->Unbind();
+
+	RenderCommand::SetBlendMode(BlendMode::Alpha);
+
+	bool depthTest = RenderCommand::GetDepthTest();
+	bool faceCulling = RenderCommand::GetFaceCulling();
+	RenderCommand::SetDepthTest(false);
+	RenderCommand::SetFaceCulling(false);
+
+	target->BindColorTexture(Accumulation, Accumulation);
+	target->BindColorTexture(Revealage, Revealage);
+
+	compositeVertexArray->Bind();
+	RenderCommand::DrawIndexed(compositeVertexArray);
+	compositeVertexArray->Unbind();
+
+	RenderCommand::SetDepthTest(depthTest);
+	RenderCommand::SetFaceCulling(faceCulling);
+	RenderCommand::SetDepthWrite(depthWrite);
+	RenderCommand::SetBlending(blending);
+}
+
+void WeightedBlendedTransparency::CreateCompositeVertexArray()
+{
+	// Only OpenGL has render targets so far, the triangle over the viewport is the one of the deferred lighting
+	std::string vertexSrc = "..\\Hedgehog\\Asset\\Shader\\OpenGLDeferredLightingVertexShader.glsl";
+	std::string pixelSrc = "..\\Hedgehog\\Asset\\Shader\\OpenGLTransparencyCompositePixelShader.glsl";
+
+	auto shader = std::shared_ptr<Shader>(Shader::Create(vertexSrc, pixelSrc, ""));
+	compositeVertexArray.reset(VertexArray::Create(shader, PrimitiveTopology::Triangle, {}, {}));
+
+	BufferLayout bufferLayout =
+	{
+		{ ShaderDataType::Float2, "a_position" },
+	};
+
+	float vertices[] =
+	{
+		-1.0f, -1.0f,
+		 3.0f, -1.0f,
+		-1.0f,  3.0f,
+	};
+	auto vertexBuffer = std::shared_ptr<VertexBuffer>(VertexBuffer::Create(bufferLayout, vertices, sizeof(vertices)));
+	compositeVertexArray->AddVertexBuffer(vertexBuffer);
+
+	unsigned int indices[] = { 0, 1, 2 };
+	auto indexBuffer = std::shared_ptr<IndexBuffer>(IndexBuffer::Create(indices, 3));
+	compositeVertexArray->AddIndexBuffer(indexBuffer);
+}
+
+void WeightedBlendedTransparency::CreateGuiControls()
+{
+	ImGui::PushID(this);
+
+	if (!IsSupported())
+	{
+		ImGui::Text("Weighted blended transparency needs render targets, translucent groups are sorted");
+		ImGui::PopID();
+		return;
+	}
+
+	ImGui::Checkbox("Weighted Blended Transparency", &enabled);
+	if (enabled)
+	{
+		ImGui::SameLine(); ImGui::Text("%u draws", numberOfDraws);
+	}
+
+	ImGui::PopID();
+}
+
+} // namespace Hedge
@@ -0,0 +1,330 @@
+#include <Spatial/BoundingVolumeHierarchy.h>
+
+
+namespace Hedge
+{
+
+static BoundingBox Union(const BoundingBox& first, const BoundingBox& second)
+{
+	BoundingBox box = first;
+	box.Add(second);
+	return box;
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(float margin)
+	: margin(margin)
+{
+}
+
+int BoundingVolumeHierarchy::CreateProxy(const BoundingBox& bounds, unsigned int userData)
+{
+	assert(bounds.IsValid());
+
+	int proxy = AllocateNode();
+	nodes[proxy].bounds.min = bounds.min - glm::vec3(margin);
+	nodes[proxy].bounds.max = bounds.max + glm::vec3(margin);
+	nodes[proxy].userData = userData;
+	nodes[proxy].height = 0;
+
+	InsertLeaf(proxy);
+	numberOfProxies++;
+
+	return proxy;
+}
+
+void BoundingVolumeHierarchy::DestroyProxy(int proxy)
+{
+	assert(nodes[proxy].IsLeaf());
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	numberOfProxies--;
+}
+
+bool BoundingVolumeHierarchy::MoveProxy(int proxy, const BoundingBox& bounds)
+{
+	assert(nodes[proxy].IsLeaf());
+	assert(bounds.IsValid());
+
+	if (nodes[proxy].bounds.Contains(bounds))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+	nodes[proxy].bounds.min = bounds.min - glm::vec3(margin);
+	nodes[proxy].bounds.max = bounds.max + glm::vec3(margin);
+	InsertLeaf(proxy);
+
+	return true;
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+	nodes.clear();
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+	numberOfProxies = 0;
+}
+
+int BoundingVolumeHierarchy::AllocateNode()
+{
+	if (freeList == NULL_NODE)
+	{
+		nodes.emplace_back();
+		return static_cast<int>(nodes.size()) - 1;
+	}
+
+	int node = freeList;
+	freeList = nodes[node].parent;
+	nodes[node] = Node();
+
+	return node;
+}
+
+void BoundingVolumeHierarchy::FreeNode(int node)
+{
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+void BoundingVolumeHierarchy::InsertLeaf(int leaf)
+{
+	if (root == NULL_NODE)
+	{
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Go down to the sibling that makes the tree grow the least,
+	// every ancestor on the way grows by the same amount whichever child is taken
+	BoundingBox leafBounds = nodes[leaf].bounds;
+	int index = root;
+	while (!nodes[index].IsLeaf())
+	{
+		const Node& node = nodes[index];
+
+		float area = node.bounds.GetSurfaceArea();
+		float combinedArea = Union(node.bounds, leafBounds).GetSurfaceArea();
+
+		// Pairing with this node
+		float cost = 2.0f * combinedArea;
+		// Descending further makes this node grow
+		float inheritedCost = 2.0f * (combinedArea - area);
+
+		auto childCost = [this, &leafBounds, inheritedCost](int child)
+		{
+			float grownArea = Union(nodes[child].bounds, leafBounds).GetSurfaceArea();
+			return nodes[child].IsLeaf() ? grownArea + inheritedCost : grownArea - nodes[child].bounds.GetSurfaceArea() + inheritedCost;
+		};
+
+		float leftCost = childCost(node.left);
+		float rightCost = childCost(node.right);
+
+		if (cost < leftCost
+			&& cost < rightCost)
+		{
+			break;
+		}
+
+		index = leftCost < rightCost ? node.left : node.right;
+	}
+
+	int sibling = index;
+	int oldParent = nodes[sibling].parent;
+
+	// May reallocate the nodes, don't hold on to references across it
+	int newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].bounds = Union(leafBounds, nodes[sibling].bounds);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].left = sibling;
+	nodes[newParent].right = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_NODE)
+	{
+		root = newParent;
+	}
+	else if (nodes[oldParent].left == sibling)
+	{
+		nodes[oldParent].left = newParent;
+	}
+	else
+	{
+		nodes[oldParent].right = newParent;
+	}
+
+	Refit(nodes[leaf].parent);
+}
+
+void BoundingVolumeHierarchy::RemoveLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = NULL_NODE;
+		return;
+	}
+
+	// The parent goes away and the sibling takes its place
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+	nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NULL_NODE)
+	{
+		root = sibling;
+		return;
+	}
+
+	if (nodes[grandParent].left == parent)
+	{
+		nodes[grandParent].left = sibling;
+	}
+	else
+	{
+		nodes[grandParent].right = sibling;
+	}
+
+	Refit(grandParent);
+}
+
+void BoundingVolumeHierarchy::Refit(int node)
+{
+	while (node != NULL_NODE)
+	{
+		node = Balance(node);
+
+		Node& current = nodes[node];
+		current.bounds = Union(nodes[current.left].bounds, nodes[current.right].bounds);
+		current.height = 1 + std::max(nodes[current.left].height, nodes[current.right].height);
+
+		node = current.parent;
+	}
+}
+
+int BoundingVolumeHierarchy::Balance(int a)
+{
+	Node& nodeA = nodes[a];
+	if (nodeA.IsLeaf()
+		|| nodeA.height < 2)
+	{
+		return a;
+	}
+
+	int b = nodeA.left;
+	int c = nodeA.right;
+	Node& nodeB = nodes[b];
+	Node& nodeC = nodes[c];
+
+	int balance = nodeC.height - nodeB.height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		int f = nodeC.left;
+		int g = nodeC.right;
+		Node& nodeF = nodes[f];
+		Node& nodeG = nodes[g];
+
+		nodeC.left = a;
+		nodeC.parent = nodeA.parent;
+		nodeA.parent = c;
+
+		if (nodeC.parent == NULL_NODE)
+		{
+			root = c;
+		}
+		else if (nodes[nodeC.parent].left == a)
+		{
+			nodes[nodeC.parent].left = c;
+		}
+		else
+		{
+			nodes[nodeC.parent].right = c;
+		}
+
+		// The taller grandchild stays with C
+		if (nodeF.height > nodeG.height)
+		{
+			nodeC.right = f;
+			nodeA.right = g;
+			nodeG.parent = a;
+			nodeA.bounds = Union(nodeB.bounds, nodeG.bounds);
+			nodeC.bounds = Union(nodeA.bounds, nodeF.bounds);
+			nodeA.height = 1 + std::max(nodeB.height, nodeG.height);
+			nodeC.height = 1 + std::max(nodeA.height, nodeF.height);
+		}
+		else
+		{
+			nodeC.right = g;
+			nodeA.right = f;
+			nodeF.parent = a;
+			nodeA.bounds = Union(nodeB.bounds, nodeF.bounds);
+			nodeC.bounds = Union(nodeA.bounds, nodeG.bounds);
+			nodeA.height = 1 + std::max(nodeB.height, nodeF.height);
+			nodeC.height = 1 + std::max(nodeA.height, nodeG.height);
+		}
+
+		return c;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		int d = nodeB.left;
+		int e = nodeB.right;
+		Node& nodeD = nodes[d];
+		Node& nodeE = nodes[e];
+
+		nodeB.left = a;
+		nodeB.parent = nodeA.parent;
+		nodeA.parent = b;
+
+		if (nodeB.parent == NULL_NODE)
+		{
+			root = b;
+		}
+		else if (nodes[nodeB.parent].left == a)
+		{
+			nodes[nodeB.parent].left = b;
+		}
+		else
+		{
+			nodes[nodeB.parent].right = b;
+		}
+
+		if (nodeD.height > nodeE.height)
+		{
+			nodeB.right = d;
+			nodeA.left = e;
+			nodeE.parent = a;
+			nodeA.bounds = Union(nodeC.bounds, nodeE.bounds);
+			nodeB.bounds = Union(nodeA.bounds, nodeD.bounds);
+			nodeA.height = 1 + std::max(nodeC.height, nodeE.height);
+			nodeB.height = 1 + std::max(nodeA.height, nodeD.height);
+		}
+		else
+		{
+			nodeB.right = e;
+			nodeA.left = d;
+			nodeD.parent = a;
+			nodeA.bounds = Union(nodeC.bounds, nodeD.bounds);
+			nodeB.bounds = Union(nodeA.bounds, nodeE.bounds);
+			nodeA.height = 1 + std::max(nodeC.height, nodeD.height);
+			nodeB.height = 1 + std::max(nodeA.height, nodeE.height);
+		}
+
+		return b;
+	}
+
+	return a;
+}
+
+} // namespace Hedge
@@ -0,0 +1,215 @@
+#include <Spatial/SpatialBenchmark.h>
+
+#include <Spatial/BoundingVolumeHierarchy.h>
+#include <Utilities/Stopwatch.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+
+namespace Hedge
+{
+
+// Exact hit distance for the leaves of the ray casts, negative for a miss
+static float RayDistance(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& direction, float maxDistance)
+{
+	float entryDistance = 0.0f;
+	float exitDistance = maxDistance;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float first = (box.min[axis] - origin[axis]) / direction[axis];
+		float second = (box.max[axis] - origin[axis]) / direction[axis];
+		entryDistance = std::max(entryDistance, std::min(first, second));
+		exitDistance = std::min(exitDistance, std::max(first, second));
+	}
+
+	return entryDistance <= exitDistance ? entryDistance : -1.0f;
+}
+
+std::vector<SpatialBenchmarkResult> RunSpatialBenchmark(const std::vector<int>& entityCounts,
+														int numberOfFrames,
+														int numberOfQueries)
+{
+	// Roughly one entity per this many cubic units, whatever the count
+	const float volumePerEntity = 64.0f;
+	const float querySize = 10.0f;
+	const float speed = 0.05f;
+
+	std::vector<SpatialBenchmarkResult> results;
+
+	printf("Spatial index benchmark, %d frames, %d queries of each kind\n", numberOfFrames, numberOfQueries);
+	printf("%10s %7s %10s %10s %10s %10s %10s %10s %10s %8s\n",
+		   "entities", "height", "build ms", "update ms", "frustum ms", "brute ms", "sphere ms", "box ms", "ray ms", "brute");
+
+	for (int numberOfEntities : entityCounts)
+	{
+		std::mt19937 random(42);
+		float worldSize = std::cbrt(numberOfEntities * volumePerEntity);
+		std::uniform_real_distribution<float> position(0.0f, worldSize);
+		std::uniform_real_distribution<float> size(0.25f, 1.0f);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		std::vector<BoundingBox> boxes(numberOfEntities);
+		std::vector<glm::vec3> velocities(numberOfEntities, glm::vec3(0.0f));
+		for (int i = 0; i < numberOfEntities; i++)
+		{
+			glm::vec3 center(position(random), position(random), position(random));
+			glm::vec3 extent(size(random), size(random), size(random));
+			boxes[i].min = center - extent;
+			boxes[i].max = center + extent;
+
+			if (i % 10 == 0)
+			{
+				velocities[i] = glm::vec3(unit(random), unit(random), unit(random)) * speed;
+			}
+		}
+
+		SpatialBenchmarkResult result;
+		result.numberOfEntities = numberOfEntities;
+
+		BoundingVolumeHierarchy tree;
+		std::vector<int> proxies(numberOfEntities);
+
+		Stopwatch stopwatch;
+		stopwatch.Start();
+		for (int i = 0; i < numberOfEntities; i++)
+		{
+			proxies[i] = tree.CreateProxy(boxes[i], (unsigned int)i);
+		}
+		stopwatch.Stop();
+		result.buildDuration = stopwatch.GetDuration().count();
+
+		stopwatch.Start();
+		for (int frame = 0; frame < numberOfFrames; frame++)
+		{
+			for (int i = 0; i < numberOfEntities; i += 10)
+			{
+				boxes[i].min += velocities[i];
+				boxes[i].max += velocities[i];
+				tree.MoveProxy(proxies[i], boxes[i]);
+			}
+		}
+		stopwatch.Stop();
+		result.updateDuration = stopwatch.GetDuration().count() / numberOfFrames;
+		result.treeHeight = tree.GetHeight();
+
+		// Same queries for every kind, from random points in the world
+		std::vector<glm::vec3> origins(numberOfQueries);
+		std::vector<glm::vec3> directions(numberOfQueries);
+		for (int query = 0; query < numberOfQueries; query++)
+		{
+			origins[query] = glm::vec3(position(random), position(random), position(random));
+			directions[query] = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0f, 0.0f, 0.001f));
+		}
+
+		std::vector<FrustumPlanes> frustums;
+		for (int query = 0; query < numberOfQueries; query++)
+		{
+			glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+			glm::mat4 view = glm::lookAt(origins[query], origins[query] + directions[query], glm::vec3(0.0f, 1.0f, 0.0f));
+			frustums.push_back(FrustumPlanes::Create(projection * view));
+		}
+
+		// Keeps the compiler from dropping the queries, the counts aren't compared
+		size_t found = 0;
+
+		std::vector<int> treeHits;
+		std::vector<char> reported(numberOfEntities, 0);
+		double bruteForceDuration = 0.0;
+		double frustumQueryDuration = 0.0;
+		for (int query = 0; query < numberOfQueries; query++)
+		{
+			treeHits.clear();
+
+			stopwatch.Start();
+			tree.Query(frustums[query], [&treeHits](unsigned int entity) { treeHits.push_back((int)entity); });
+			stopwatch.Stop();
+			frustumQueryDuration += stopwatch.GetDuration().count();
+
+			// What it takes today, every entity against the frustum
+			std::vector<int> bruteForceHits;
+			stopwatch.Start();
+			for (int i = 0; i < numberOfEntities; i++)
+			{
+				if (frustums[query].Intersects(boxes[i]))
+				{
+					bruteForceHits.push_back(i);
+				}
+			}
+			stopwatch.Stop();
+			bruteForceDuration += stopwatch.GetDuration().count();
+
+			for (int entity : treeHits)
+			{
+				reported[entity] = 1;
+			}
+			for (int entity : bruteForceHits)
+			{
+				result.matchesBruteForce = result.matchesBruteForce && reported[entity];
+			}
+			for (int entity : treeHits)
+			{
+				reported[entity] = 0;
+			}
+
+			found += treeHits.size();
+		}
+		result.frustumQueryDuration = frustumQueryDuration / numberOfQueries;
+		result.bruteForceDuration = bruteForceDuration / numberOfQueries;
+
+		stopwatch.Start();
+		for (int query = 0; query < numberOfQueries; query++)
+		{
+			tree.QuerySphere(origins[query], querySize, [&found](unsigned int) { found++; });
+		}
+		stopwatch.Stop();
+		result.sphereQueryDuration = stopwatch.GetDuration().count() / numberOfQueries;
+
+		stopwatch.Start();
+		for (int query = 0; query < numberOfQueries; query++)
+		{
+			BoundingBox box;
+			box.min = origins[query] - glm::vec3(querySize);
+			box.max = origins[query] + glm::vec3(querySize);
+			tree.Query(box, [&found](unsigned int) { found++; });
+		}
+		stopwatch.Stop();
+		result.boxQueryDuration = stopwatch.GetDuration().count() / numberOfQueries;
+
+		stopwatch.Start();
+		for (int query = 0; query < numberOfQueries; query++)
+		{
+			const glm::vec3& origin = origins[query];
+			const glm::vec3& direction = directions[query];
+			tree.RayCast(origin, direction, worldSize, [&boxes, &origin, &direction, worldSize, &found](unsigned int entity)
+				{
+					found++;
+					return RayDistance(boxes[entity], origin, direction, worldSize);
+				});
+		}
+		stopwatch.Stop();
+		result.rayCastDuration = stopwatch.GetDuration().count() / numberOfQueries;
+
+		printf("%10d %7d %10.3f %10.3f %10.4f %10.4f %10.4f %10.4f %10.4f %8s\n",
+			   result.numberOfEntities,
+			   result.treeHeight,
+			   result.buildDuration,
+			   result.updateDuration,
+			   result.frustumQueryDuration,
+			   result.bruteForceDuration,
+			   result.sphereQueryDuration,
+			   result.boxQueryDuration,
+			   result.rayCastDuration,
+			   result.matchesBruteForce ? "match" : "MISSED");
+		printf("%10s %zu entities found\n", "", found);
+
+		results.push_back(result);
+	}
+
+	return results;
+}
+
+} // namespace Hedge
@@ -0,0 +1,126 @@
+#include <Utilities/JobSystem.h>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace Hedge
+{
+
+JobSystem::JobSystem(unsigned int numberOfThreads)
+{
+	numberOfThreads = std::max(numberOfThreads, 1u);
+
+	for (unsigned int i = 0; i < numberOfThreads - 1; i++)
+	{
+		workers.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wakeUp.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+JobSystem& JobSystem::Get()
+{
+	static JobSystem jobSystem;
+	return jobSystem;
+}
+
+void JobSystem::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& function)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	chunkSize = std::max(chunkSize, size_t(1));
+
+	// Not worth waking anybody up
+	if (workers.empty()
+		|| count <= chunkSize)
+	{
+		function(0, count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		assert(!jobActive);
+
+		job = &function;
+		jobCount = count;
+		jobChunkSize = chunkSize;
+		numberOfChunks = (count + chunkSize - 1) / chunkSize;
+		nextChunk = 0;
+		jobGeneration++;
+		jobActive = true;
+	}
+	wakeUp.notify_all();
+
+	RunChunks();
+
+	// Every chunk is taken by now, close the job so late workers don't join
+	// and wait for the ones still running theirs
+	std::unique_lock<std::mutex> lock(mutex);
+	jobActive = false;
+	done.wait(lock, [this]() { return activeWorkers == 0; });
+	job = nullptr;
+}
+
+void JobSystem::WorkerLoop()
+{
+	unsigned long long seenGeneration = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeUp.wait(lock, [this, &seenGeneration]() { return quit || (jobActive && jobGeneration != seenGeneration); });
+
+			if (quit)
+			{
+				return;
+			}
+
+			seenGeneration = jobGeneration;
+			activeWorkers++;
+		}
+
+		RunChunks();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			activeWorkers--;
+		}
+		done.notify_one();
+	}
+}
+
+void JobSystem::RunChunks()
+{
+	for (;;)
+	{
+		size_t chunk = nextChunk.fetch_add(1);
+		if (chunk >= numberOfChunks)
+		{
+			break;
+		}
+
+		size_t begin = chunk * jobChunkSize;
+		size_t end = std::min(begin + jobChunkSize, jobCount);
+		(*job)(begin, end);
+	}
+}
+
+} // namespace Hedge